@@ -64,8 +64,10 @@ static BoolOption    opt_rnd_init_act      (_cat, "rnd-init",    "Randomize the
 static IntOption     opt_restart_first     (_cat, "rfirst",      "The base restart interval", 100, IntRange(1, INT32_MAX));
 static DoubleOption  opt_restart_inc       (_cat, "rinc",        "Restart interval increase factor", 2, DoubleRange(1, false, HUGE_VAL, false));
 static DoubleOption  opt_garbage_frac      (_cat, "gc-frac",     "The fraction of wasted memory allowed before a garbage collection is triggered",  0.20, DoubleRange(0, false, HUGE_VAL, false));
+static DoubleOption  opt_switch_time       (_cat, "switch-time", "CPU seconds of CHB search before switching to VSIDS", 2500, DoubleRange(0, true, HUGE_VAL, false));
 static IntOption     opt_chrono            (_cat, "chrono",  "Controls if to perform chrono backtrack", 100, IntRange(-1, INT32_MAX));
 static IntOption     opt_conf_to_chrono    (_cat, "confl-to-chrono",  "Controls number of conflicts to perform chrono backtrack", 4000, IntRange(-1, INT32_MAX));
+static BoolOption    opt_reuse_trail       (_cat, "reuse-trail", "Restart only to the first level whose decision ranks below the top of the order heap", false);
 
 
 //=================================================================================================
@@ -103,11 +105,14 @@ Solver::Solver() :
   //
   , learntsize_adjust_start_confl (100)
   , learntsize_adjust_inc         (1.5)
+  , switch_time                   (opt_switch_time)
+  , reuse_trail                   (opt_reuse_trail)
 
   // Statistics: (formerly in 'SolverStats')
   //
   , solves(0), starts(0), decisions(0), rnd_decisions(0), propagations(0), conflicts(0), conflicts_VSIDS(0)
   , dec_vars(0), clauses_literals(0), learnts_literals(0), max_literals(0), tot_literals(0)
+  , reused_restarts(0), reused_levels(0), reused_props(0)
   , chrono_backtrack(0), non_chrono_backtrack(0)
 
   , ok                 (true)
@@ -151,6 +156,7 @@ Solver::Solver() :
   , lbd_queue          (50)
   , next_T2_reduce     (10000)
   , next_L_reduce      (15000)
+  , switch_deadline    (-1)
   , confl_to_chrono    (opt_conf_to_chrono)
   , chrono			   (opt_chrono)
   
@@ -1849,6 +1855,35 @@ CRef Solver::propagateLits(vec<Lit>& lits) {
     }
     return CRef_Undef;
 }
+// Partial restarts: a full restart would decide the variables above the top of the order heap of the
+// current mode (DISTANCE, CHB or VSIDS) again, with the same phases, so the levels whose decisions
+// rank above it are kept, as are the levels of the assumptions. A due round of 'simplifyAll()' makes
+// it a full restart; imported clauses wait for one.
+int Solver::reuseTrailLevel()
+{
+    if (!reuse_trail || conflicts >= curSimplify * nbconfbeforesimplify)
+        return 0;
+
+    Heap<VarOrderLt>&  order_heap = DISTANCE ? order_heap_distance : ((!VSIDS)? order_heap_CHB:order_heap_VSIDS);
+    const vec<double>& activity   = DISTANCE ? activity_distance   : ((!VSIDS)? activity_CHB:activity_VSIDS);
+    while (!order_heap.empty() && (value(order_heap[0]) != l_Undef || !decision[order_heap[0]]))
+        order_heap.removeMin();
+    if (order_heap.empty())
+        return 0;
+
+    double top   = activity[order_heap[0]];
+    int    level = assumptions.size() < decisionLevel() ? assumptions.size() : decisionLevel();
+    while (level < decisionLevel() && activity[var(trail[trail_lim[level]])] > top)
+        level++;
+
+    if (level > 0){
+        reused_restarts++;
+        reused_levels += level;
+        reused_props  += (level < decisionLevel() ? trail_lim[level] : trail.size()) - trail_lim[0]; }
+    return level;
+}
+
+
 /*_________________________________________________________________________________________________
 |
 |  search : (nof_conflicts : int) (params : const SearchParams&)  ->  [lbool]
@@ -1998,7 +2033,7 @@ lbool Solver::search(int& nof_conflicts)
                 cached = false;
                 // Reached bound on number of conflicts:
                 progress_estimate = progressEstimate();
-                cancelUntil(0);
+                cancelUntil(reuseTrailLevel());
                 return l_Undef; }
 
             // Simplify the set of problem clauses:
@@ -2102,14 +2137,10 @@ static double luby(double y, int x){
     return pow(y, seq);
 }
 
-static bool switch_mode = false;
-static void SIGALRM_switch(int signum) { switch_mode = true; }
-
 // NOTE: assumptions passed in member-variable 'assumptions'.
 lbool Solver::solve_()
 {
-    signal(SIGALRM, SIGALRM_switch);
-    alarm(2500);
+    switch_deadline = cpuTime() + switch_time;
 
     model.clear();
     conflict.clear();
@@ -2135,6 +2166,8 @@ lbool Solver::solve_()
     int init = 10000;
     while (status == l_Undef && init > 0 /*&& withinBudget()*/)
         status = search(init);
+    // Each mode refills its own order heap when backtracking:
+    if (status == l_Undef) cancelUntil(0);
     VSIDS = false;
     phase1Done=false;    
     // Search:
@@ -2148,7 +2181,8 @@ lbool Solver::solve_()
             curr_restarts++;
             status = search(nof_conflicts);
         }
-        if (!VSIDS && switch_mode){
+        if (status == l_Undef && !VSIDS && cpuTime() >= switch_deadline){
+            cancelUntil(0);
             VSIDS = true;
             phase1Done=true;            
             //printf("c Switched to VSIDS.\n");
@@ -0,0 +1,50 @@
+/***********************************************************************************[ModelWriter.h]
+Buffered model output for the front-ends: the model is formatted in large chunks (on several
+threads for big models) and written with one 'fwrite' per chunk instead of one 'fprintf' per
+variable.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+**************************************************************************************************/
+
+#ifndef Minisat_ModelWriter_h
+#define Minisat_ModelWriter_h
+
+#include <stdio.h>
+
+#include "core/SolverTypes.h"
+
+namespace Minisat {
+
+//=================================================================================================
+// Model output:
+
+// Writes 'model' as the DIMACS literals "1 -2 3 ... 0\n" preceded by 'prefix'. Variables that are
+// undefined in the model are skipped. Honours the '-model-threads' option.
+void writeModel      (FILE* out, const vec<lbool>& model, const char* prefix = "");
+
+// Writes 'model' in binary form: the magic "MDL1", the number of variables as a 32-bit
+// little-endian integer, then two bits per variable (0 = false, 1 = true, 2 = undefined), four
+// variables per byte starting from the low bits.
+void writeModelBinary(FILE* out, const vec<lbool>& model);
+
+// Writes the "SAT" line of a result file followed by 'model', in text or, with '-binary-model',
+// in binary form.
+void writeSatResult  (FILE* res, const vec<lbool>& model);
+
+//=================================================================================================
+}
+
+#endif
@@ -188,11 +188,14 @@ public:
 
     int       learntsize_adjust_start_confl;
     double    learntsize_adjust_inc;
+    double    switch_time;        // CPU seconds of CHB search before switching to VSIDS for good.                           (default 2500)
+    bool      reuse_trail;        // Restarts keep the levels whose decisions rank above the top of the order heap.          (default false)
 
     // Statistics: (read-only member variable)
     //
     uint64_t solves, starts, decisions, rnd_decisions, propagations, conflicts, conflicts_VSIDS;
     uint64_t dec_vars, clauses_literals, learnts_literals, max_literals, tot_literals;
+    uint64_t reused_restarts, reused_levels, reused_props;
 
     vec<uint32_t> picked;
     vec<uint32_t> conflicted;
@@ -285,6 +288,8 @@ protected:
     uint64_t            next_T2_reduce,
                         next_L_reduce;
 
+    double              switch_deadline;  // CPU time at which the CHB phase ends; set by 'solve_()'.
+
     ClauseAllocator     ca;
 
     // Temporaries (to reduce allocation overhead). Each variable is prefixed by the method in which it is
@@ -354,6 +359,7 @@ protected:
     void     analyzeFinal     (Lit p, vec<Lit>& out_conflict);                         // COULD THIS BE IMPLEMENTED BY THE ORDINARIY "analyze" BY SOME REASONABLE GENERALIZATION?
     bool     litRedundant     (Lit p, uint32_t abstract_levels);                       // (helper method for 'analyze()')
     lbool    search           (int& nof_conflicts);                                    // Search for a given number of conflicts.
+    int      reuseTrailLevel  ();                                                      // The level a restart backtracks to (see 'reuse_trail').
     lbool    solve_           ();                                                      // Main solve method (assumptions given in 'assumptions').
     void     reduceDB         ();                                                      // Reduce the set of learnt clauses.
     void     reduceDB_Tier2   ();
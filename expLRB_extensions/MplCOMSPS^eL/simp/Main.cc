@@ -30,6 +30,7 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 #include "utils/ParseUtils.h"
 #include "utils/Options.h"
 #include "core/Dimacs.h"
+#include "core/ModelWriter.h"
 #include "simp/SimpSolver.h"
 #include<iostream>
 using namespace std;
@@ -317,6 +318,9 @@ int main(int argc, char** argv)
         vec<Lit> dummy;
         lbool ret = S.solveLimited(dummy);
         S.state = ret==l_True ? 1 : (ret==l_False ? 0 : -1);        
+        if (S.verbosity > 0 && S.reused_restarts > 0)
+            printf("c trail reuse: %.0f of %.0f restarts, %.0f levels kept, %.0f propagations saved\n",
+                   (double)S.reused_restarts, (double)S.starts, (double)S.reused_levels, (double)S.reused_props);
         
         if (S.verbosity > -1){
             printStats(S);
@@ -342,11 +346,7 @@ int main(int argc, char** argv)
 
         if (res != NULL){
             if (ret == l_True){
-                fprintf(res, "SAT\n");
-                for (int i = 0; i < S.nVars(); i++)
-                    if (S.model[i] != l_Undef)
-                        fprintf(res, "%s%s%d", (i==0)?"":" ", (S.model[i]==l_True)?"":"-", i+1);
-                fprintf(res, " 0\n");
+                writeSatResult(res, S.model);
             }else if (ret == l_False)
                 fprintf(res, "UNSAT\n");
             else
@@ -52,6 +52,7 @@ static BoolOption    opt_rnd_init_act      (_cat, "rnd-init",    "Randomize the
 static IntOption     opt_restart_first     (_cat, "rfirst",      "The base restart interval", 100, IntRange(1, INT32_MAX));
 static DoubleOption  opt_restart_inc       (_cat, "rinc",        "Restart interval increase factor", 2, DoubleRange(1, false, HUGE_VAL, false));
 static DoubleOption  opt_garbage_frac      (_cat, "gc-frac",     "The fraction of wasted memory allowed before a garbage collection is triggered",  0.20, DoubleRange(0, false, HUGE_VAL, false));
+static BoolOption    opt_reuse_trail       (_cat, "reuse-trail", "Restart only to the first level whose decision ranks below the top of the order heap", false);
 
 
 //=================================================================================================
@@ -87,11 +88,25 @@ Solver::Solver() :
     //
   , learntsize_adjust_start_confl (100)
   , learntsize_adjust_inc         (1.5)
+  , reuse_trail                   (opt_reuse_trail)
+
+    // Incremental interface hooks:
+    //
+  , term_state         (NULL)
+  , term_callback      (NULL)
+  , learn_state        (NULL)
+  , learn_callback     (NULL)
+  , learn_max_size     (0)
+  , learn_max_lbd      (INT32_MAX)
+  , import_state       (NULL)
+  , import_callback    (NULL)
 
     // Statistics: (formerly in 'SolverStats')
     //
   , solves(0), starts(0), decisions(0), rnd_decisions(0), propagations(0), conflicts(0), conflicts_glue(0)
   , dec_vars(0), clauses_literals(0), learnts_literals(0), max_literals(0), tot_literals(0)
+  , vivify_rounds(0), vivified(0), vivify_shortened(0), vivify_lits(0), vivify_props(0)
+  , reused_restarts(0), reused_levels(0), reused_props(0)
 
   , ok                 (true)
   , state               (-1)
@@ -134,6 +149,10 @@ Solver::Solver() :
   , lbd_queue          (50)
   , next_T2_reduce     (10000)
   , next_L_reduce      (15000)
+  , glue_warmup        (10000)
+  , phase_allotment    (100)
+  , vivify_split       (0)
+  , vivify_job         (NULL)
   
   , counter            (0)
 
@@ -147,6 +166,7 @@ Solver::Solver() :
 
 Solver::~Solver()
 {
+    vivifyStop();
 }
 
 
@@ -428,7 +448,8 @@ void Solver::analyze(CRef confl, vec<Lit>& out_learnt, int& out_btlevel, int& ou
                 c.touched() = conflicts;
             else if (c.mark() == LOCAL)
                 claBumpActivity(c);
-        }
+        }else if (!c.learnt() && !c.used())
+            c.used(true);   // (vivification tries these problem clauses first)
 
         for (int j = (p == lit_Undef) ? 0 : 1; j < c.size(); j++){
             Lit q = c[j];
@@ -967,6 +988,57 @@ NextClause:;
     cs.shrink(i - j);
 }
 
+/*_________________________________________________________________________________________________
+|
+|  importClauses : [void]  ->  [bool]
+|  
+|  Description:
+|    Adds the clauses handed over by 'import_callback' (if any) as problem clauses. Must be called
+|    at decision level 0. Returns FALSE if an imported clause made the formula unsatisfiable.
+|________________________________________________________________________________________________@*/
+bool Solver::importClauses()
+{
+    if (import_callback == NULL) return true;
+    assert(decisionLevel() == 0);
+
+    for (;;){
+        add_tmp.clear();
+        if (!import_callback(import_state, add_tmp)) break;
+        if (!addClause_(add_tmp)) return false;
+    }
+    return true;
+}
+
+
+// Partial restarts: a full restart would decide the variables above the top of the order heap of the
+// current restart policy again (phase saving repeats their values), so the levels whose decisions
+// rank above it are kept, as are the levels of the assumptions. A due round of vivification makes it
+// a full restart; imported clauses wait for one.
+int Solver::reuseTrailLevel()
+{
+    if (!reuse_trail || vivifyReady())
+        return 0;
+
+    Heap<VarOrderLt>&  order_heap = glucose_restart ? order_heap_glue_r : order_heap_no_r;
+    const vec<double>& activity   = glucose_restart ? activity_glue_r   : activity_no_r;
+    while (!order_heap.empty() && (value(order_heap[0]) != l_Undef || !decision[order_heap[0]]))
+        order_heap.removeMin();
+    if (order_heap.empty())
+        return 0;
+
+    double top   = activity[order_heap[0]];
+    int    level = assumptions.size() < decisionLevel() ? assumptions.size() : decisionLevel();
+    while (level < decisionLevel() && activity[var(trail[trail_lim[level]])] > top)
+        level++;
+
+    if (level > 0){
+        reused_restarts++;
+        reused_levels += level;
+        reused_props  += (level < decisionLevel() ? trail_lim[level] : trail.size()) - trail_lim[0]; }
+    return level;
+}
+
+
 /*_________________________________________________________________________________________________
 |
 |  search : (nof_conflicts : int) (params : const SearchParams&)  ->  [lbool]
@@ -987,6 +1059,13 @@ lbool Solver::search(int& nof_conflicts)
     vec<Lit>    learnt_clause;
     bool        cached = false;
     starts++;
+
+    if (decisionLevel() == 0 && !importClauses())
+        return l_False;
+
+    if (decisionLevel() == 0 && (vivify_job != NULL || vivifyDue()) && !vivify())
+        return l_False;
+
     for (;;){
         CRef confl = propagate();
         if (confl != CRef_Undef){
@@ -1040,6 +1119,9 @@ lbool Solver::search(int& nof_conflicts)
                 fprintf(drup_file, "0\n");
 #endif
             }
+            if (learn_callback != NULL && learnt_clause.size() <= learn_max_size &&
+                (learnt_clause.size() == 1 || lbd <= learn_max_lbd))
+                learn_callback(learn_state, learnt_clause);
 
             claDecayActivity();
 
@@ -1065,11 +1147,11 @@ lbool Solver::search(int& nof_conflicts)
                 restart = lbd_queue.full() && (lbd_queue.avg() * K > global_lbd_sum / conflicts_glue);
                 cached = true;
             }
-            if (restart /*|| !withinBudget()*/){
+            if (restart || !withinBudget()){
                 lbd_queue.clear();
                 // Reached bound on number of conflicts:
                 progress_estimate = progressEstimate();
-                cancelUntil(0);
+                cancelUntil(restart && withinBudget() ? reuseTrailLevel() : 0);
                 return l_Undef; }
 
             // Simplify the set of problem clauses:
@@ -1084,7 +1166,7 @@ lbool Solver::search(int& nof_conflicts)
                 reduceDB(); }
 
             Lit next = lit_Undef;
-            /*while (decisionLevel() < assumptions.size()){
+            while (decisionLevel() < assumptions.size()){
                 // Perform user provided assumption:
                 Lit p = assumptions[decisionLevel()];
                 if (value(p) == l_True){
@@ -1099,7 +1181,7 @@ lbool Solver::search(int& nof_conflicts)
                 }
             }
 
-            if (next == lit_Undef)*/{
+            if (next == lit_Undef){
                 // New variable decision:
                 if(triggerExploration()==true) {
                     // cout<<"\nexploring";
@@ -1193,29 +1275,31 @@ lbool Solver::solve_()
     add_tmp.clear();
 
     glucose_restart = true;
-    int init = 10000;
     initExpParameters();
     
-    
-    while (status == l_Undef && init > 0 /*&& withinBudget()*/){
+    // The warm-up phase is spent only once over all calls, so that repeated incremental calls
+    // continue from the heuristic state (and exploration statistics) reached so far.
+    while (status == l_Undef && glue_warmup > 0 && withinBudget()){
         justRestarted=true;
-        status = search(init);
+        status = search(glue_warmup);
     }
+    // Each restart policy refills its own order heap when backtracking:
+    if (status == l_Undef) cancelUntil(0);
     glucose_restart = false;
 
     
     // Search:
-    int phase_allotment = 100;
     for (;;){
         int weighted = glucose_restart ? phase_allotment * 2 : phase_allotment;
         fflush(stdout);
-        while (status == l_Undef && weighted > 0 /*&& withinBudget()*/){
+        while (status == l_Undef && weighted > 0 && withinBudget()){
             justRestarted=true;                    
             status = search(weighted);
         }
-        if (status != l_Undef /*|| !withinBudget()*/)
+        if (status != l_Undef || !withinBudget())
             break; // Should break here for correctness in incremental SAT solving.
 
+        cancelUntil(0);
         glucose_restart = !glucose_restart;
         if (!glucose_restart)
             phase_allotment += phase_allotment / 10;
@@ -1235,7 +1319,10 @@ lbool Solver::solve_()
     }else if (status == l_False && conflict.size() == 0)
         ok = false;
 
+    // Backtracking only refills the order heap of the current restart policy, but the next call
+    // starts with the other one again:
     cancelUntil(0);
+    rebuildOrderHeap();
     return status;
 }
 
@@ -1365,6 +1452,15 @@ void Solver::relocAll(ClauseAllocator& to)
             ca.reloc(clauses[i], to);
             clauses[j++] = clauses[i]; }
     clauses.shrink(i - j);
+
+    // Clauses of the round of vivification on the helper thread (deleted ones are dropped):
+    //
+    for (i = 0; i < vivify_cands.size(); i++)
+        if (vivify_cands[i] != CRef_Undef){
+            if (!ca[vivify_cands[i]].reloced() && ca[vivify_cands[i]].mark() == 1)
+                vivify_cands[i] = CRef_Undef;
+            else
+                ca.reloc(vivify_cands[i], to); }
 }
 
 
@@ -51,6 +51,8 @@ using namespace std;
 
 namespace Minisat {
 
+struct VivifyJob;
+
 //=================================================================================================
 // Solver -- the main class:
 
@@ -189,11 +191,25 @@ public:
 
     int       learntsize_adjust_start_confl;
     double    learntsize_adjust_inc;
+    bool      reuse_trail;        // Restarts keep the levels whose decisions rank above the top of the order heap.          (default false)
+
+    // Incremental interface hooks (used by the IPASIR wrapper and the portfolio driver):
+    //
+    void*     term_state;
+    int     (*term_callback)(void* state);                  // Polled by 'withinBudget()'; non-zero stops the search.
+    void*     learn_state;
+    void    (*learn_callback)(void* state, const vec<Lit>& c); // Receives each learnt clause of size <= 'learn_max_size'.
+    int       learn_max_size;
+    int       learn_max_lbd;      // Non-unit learnt clauses are only passed on if their stored LBD is at most this.         (default INT32_MAX)
+    void*     import_state;
+    bool    (*import_callback)(void* state, vec<Lit>& c);   // Polled at level 0 by 'search()'; fills 'c' and returns true while clauses are pending.
 
     // Statistics: (read-only member variable)
     //
     uint64_t solves, starts, decisions, rnd_decisions, propagations, conflicts, conflicts_glue;
     uint64_t dec_vars, clauses_literals, learnts_literals, max_literals, tot_literals;
+    uint64_t vivify_rounds, vivified, vivify_shortened, vivify_lits, vivify_props;
+    uint64_t reused_restarts, reused_levels, reused_props;
 
     vec<uint32_t> picked;
     vec<uint32_t> conflicted;
@@ -299,6 +315,14 @@ protected:
     uint64_t            next_T2_reduce,
                         next_L_reduce;
 
+    int                 glue_warmup;      // Remaining conflicts of the initial glucose-restart phase (spent over all calls to 'solve_()').
+    int                 phase_allotment;  // Conflicts per LRB phase; keeps growing across calls to 'solve_()'.
+
+    vec<CRef>           vivify_cands;     // Clauses of the current round of vivification (see 'Vivify.cc'),
+    int                 vivify_split;     // the TIER2 ones before this index, the problem clauses after it.
+    VivifyJob*          vivify_job;       // Round running on the helper thread, or NULL.
+    vec<Lit>            vivify_tmp;
+
     ClauseAllocator     ca;
 
     // Temporaries (to reduce allocation overhead). Each variable is prefixed by the method in which it is
@@ -339,6 +363,8 @@ protected:
     void     analyzeFinal     (Lit p, vec<Lit>& out_conflict);                         // COULD THIS BE IMPLEMENTED BY THE ORDINARIY "analyze" BY SOME REASONABLE GENERALIZATION?
     bool     litRedundant     (Lit p, uint32_t abstract_levels);                       // (helper method for 'analyze()')
     lbool    search           (int& nof_conflicts);                                    // Search for a given number of conflicts.
+    int      reuseTrailLevel  ();                                                      // The level a restart backtracks to (see 'reuse_trail').
+    bool     importClauses    ();                                                      // Add the clauses offered by 'import_callback'.
     lbool    solve_           ();                                                      // Main solve method (assumptions given in 'assumptions').
     void     reduceDB         ();                                                      // Reduce the set of learnt clauses.
     void     reduceDB_Tier2   ();
@@ -346,6 +372,18 @@ protected:
     void     safeRemoveSatisfiedCompact(vec<CRef>& cs, unsigned valid_mark);
     void     rebuildOrderHeap ();
     bool     binResMinimize   (vec<Lit>& out_learnt);                                  // Further learnt clause minimization by binary resolution.
+    bool     vivifyDue        () const;                                                // A round of vivification is due (see 'Vivify.cc').
+    bool     vivifyReady      () const;                                                // A round is due, or the one of the helper thread can be committed.
+    bool     vivify           ();                                                      // Vivify problem and TIER2 clauses at level 0. FALSE if unsatisfiable.
+    void     vivifyCandidates ();                                                      // (helper methods for 'vivify()')
+    bool     vivifyLits       (vec<Lit>& lits);
+    void     vivifyEnqueue    (Lit p, CRef from);
+    CRef     vivifyPropagate  ();
+    void     vivifyBacktrack  ();
+    bool     vivifyReplace    (CRef cr, const vec<Lit>& lits);
+    bool     vivifyCommit     ();
+    void     vivifyStop       ();
+    static void* vivifyThread (void* job);
 
     // Maintaining Variable/Clause activity:
     //
@@ -528,7 +566,7 @@ inline void     Solver::interrupt(){ asynch_interrupt = true; }
 inline void     Solver::clearInterrupt(){ asynch_interrupt = false; }
 inline void     Solver::budgetOff(){ conflict_budget = propagation_budget = -1; }
 inline bool     Solver::withinBudget() const {
-    return !asynch_interrupt &&
+    return !asynch_interrupt && (term_callback == NULL || !term_callback(term_state)) &&
            (conflict_budget    < 0 || conflicts < (uint64_t)conflict_budget) &&
            (propagation_budget < 0 || propagations < (uint64_t)propagation_budget); }
 
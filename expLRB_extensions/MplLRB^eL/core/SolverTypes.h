@@ -128,8 +128,10 @@ class Clause {
         unsigned learnt    : 1;
         unsigned has_extra : 1;
         unsigned reloced   : 1;
-        unsigned lbd       : 26;
+        unsigned lbd       : 24;
         unsigned removable : 1;
+        unsigned used      : 1;
+        unsigned vivified  : 1;
         unsigned size      : 32; }                            header;
     union { Lit lit; float act; uint32_t abs; uint32_t touched; CRef rel; } data[0];
 
@@ -145,6 +147,8 @@ class Clause {
         header.size      = ps.size();
         header.lbd       = 0;
         header.removable = 1;
+        header.used      = 0;
+        header.vivified  = 0;
 
         for (int i = 0; i < ps.size(); i++) 
             data[i].lit = ps[i];
@@ -183,6 +187,10 @@ public:
     void         set_lbd     (int lbd)       { header.lbd = lbd; }
     bool         removable   ()      const   { return header.removable; }
     void         removable   (bool b)        { header.removable = b; }
+    bool         used        ()      const   { return header.used; }
+    void         used        (bool b)        { header.used = b; }
+    bool         vivified    ()      const   { return header.vivified; }
+    void         vivified    (bool b)        { header.vivified = b; }
 
     // NOTE: somewhat unsafe to change the clause in-place! Must manually call 'calcAbstraction' afterwards for
     //       subsumption operations to behave correctly.
@@ -257,6 +265,8 @@ class ClauseAllocator : public RegionAllocator<uint32_t>
         // Copy extra data-fields: 
         // (This could be cleaned-up. Generalize Clause-constructor to be applicable here instead?)
         to[cr].mark(c.mark());
+        to[cr].used(c.used());
+        to[cr].vivified(c.vivified());
         if (to[cr].learnt()){
             to[cr].touched() = c.touched();
             to[cr].activity() = c.activity();
@@ -0,0 +1,142 @@
+/***************************************************************************************[ipasir.cc]
+IPASIR wrapper around the core solver, so that the solver can be linked as the incremental oracle
+of other tools (build with 'make' in this directory, which produces 'libipasirmpllrbel.a').
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+**************************************************************************************************/
+
+#include <stdlib.h>
+
+#include "ipasir/ipasir.h"
+#include "core/Solver.h"
+
+using namespace Minisat;
+
+//=================================================================================================
+// Wrapper state:
+
+
+namespace {
+
+struct IpasirSolver {
+    Solver      S;
+    vec<Lit>    clause;     // Clause under construction by 'ipasir_add()'.
+    vec<Lit>    assumps;    // Assumptions for the next call to 'ipasir_solve()'.
+    vec<char>   failed;     // 'failed[toInt(p)]' is set if assumption 'p' was used in the final conflict.
+    lbool       status;
+
+    void*       learn_state;
+    void      (*learn)(void* state, int* clause);
+    vec<int>    learn_buf;
+
+    IpasirSolver() : status(l_Undef), learn_state(NULL), learn(NULL) {}
+
+    Lit import(int lit) {
+        Var v = abs(lit) - 1;
+        while (v >= S.nVars()) S.newVar();
+        return mkLit(v, lit < 0); }
+};
+
+static void forwardLearnt(void* state, const vec<Lit>& c)
+{
+    IpasirSolver* s = (IpasirSolver*)state;
+    s->learn_buf.clear();
+    for (int i = 0; i < c.size(); i++)
+        s->learn_buf.push(sign(c[i]) ? -(var(c[i]) + 1) : var(c[i]) + 1);
+    s->learn_buf.push(0);
+    s->learn(s->learn_state, (int*)s->learn_buf);
+}
+
+}
+
+
+//=================================================================================================
+// IPASIR interface:
+
+
+extern "C" {
+
+const char* ipasir_signature() { return "MplLRB^eL"; }
+
+void* ipasir_init() { return new IpasirSolver(); }
+
+void ipasir_release(void* solver) { delete (IpasirSolver*)solver; }
+
+void ipasir_add(void* solver, int lit)
+{
+    IpasirSolver* s = (IpasirSolver*)solver;
+    if (lit != 0)
+        s->clause.push(s->import(lit));
+    else{
+        s->S.addClause_(s->clause);
+        s->clause.clear(); }
+}
+
+void ipasir_assume(void* solver, int lit)
+{
+    IpasirSolver* s = (IpasirSolver*)solver;
+    s->assumps.push(s->import(lit));
+}
+
+int ipasir_solve(void* solver)
+{
+    IpasirSolver* s = (IpasirSolver*)solver;
+    s->status = s->S.solveLimited(s->assumps);
+    s->assumps.clear();
+
+    s->failed.clear();
+    if (s->status == l_False){
+        s->failed.growTo(2 * s->S.nVars(), 0);
+        for (int i = 0; i < s->S.conflict.size(); i++)
+            s->failed[toInt(~s->S.conflict[i])] = 1; }
+
+    return s->status == l_True ? 10 : s->status == l_False ? 20 : 0;
+}
+
+int ipasir_val(void* solver, int lit)
+{
+    IpasirSolver* s = (IpasirSolver*)solver;
+    Var v = abs(lit) - 1;
+    if (s->status != l_True || v >= s->S.model.size() || s->S.model[v] == l_Undef)
+        return 0;
+    return (s->S.model[v] == l_True) == (lit > 0) ? lit : -lit;
+}
+
+int ipasir_failed(void* solver, int lit)
+{
+    IpasirSolver* s = (IpasirSolver*)solver;
+    Lit p = mkLit(abs(lit) - 1, lit < 0);
+    return toInt(p) < s->failed.size() && s->failed[toInt(p)];
+}
+
+void ipasir_set_terminate(void* solver, void* state, int (*terminate)(void* state))
+{
+    IpasirSolver* s = (IpasirSolver*)solver;
+    s->S.term_state    = state;
+    s->S.term_callback = terminate;
+}
+
+void ipasir_set_learn(void* solver, void* state, int max_length, void (*learn)(void* state, int* clause))
+{
+    IpasirSolver* s = (IpasirSolver*)solver;
+    s->learn_state         = state;
+    s->learn               = learn;
+    s->S.learn_state       = s;
+    s->S.learn_callback    = learn != NULL ? forwardLearnt : NULL;
+    s->S.learn_max_size    = max_length;
+}
+
+}
@@ -77,6 +77,8 @@ static BoolOption    opt_rnd_init_act      (_cat, "rnd-init",    "Randomize the
 static IntOption     opt_restart_first     (_cat, "rfirst",      "The base restart interval", 100, IntRange(1, INT32_MAX));
 static DoubleOption  opt_restart_inc       (_cat, "rinc",        "Restart interval increase factor", 2, DoubleRange(1, false, HUGE_VAL, false));
 static DoubleOption  opt_garbage_frac      (_cat, "gc-frac",     "The fraction of wasted memory allowed before a garbage collection is triggered",  0.20, DoubleRange(0, false, HUGE_VAL, false));
+static DoubleOption  opt_switch_time       (_cat, "switch-time", "CPU seconds of CHB search before switching to VSIDS", 2500, DoubleRange(0, true, HUGE_VAL, false));
+static BoolOption    opt_reuse_trail       (_cat, "reuse-trail", "Restart only to the first level whose decision ranks below the top of the order heap", false);
 
 
 //=================================================================================================
@@ -114,11 +116,25 @@ Solver::Solver() :
   //
   , learntsize_adjust_start_confl (100)
   , learntsize_adjust_inc         (1.5)
+  , switch_time                   (opt_switch_time)
+  , reuse_trail                   (opt_reuse_trail)
+
+    // Incremental interface hooks:
+    //
+  , term_state         (NULL)
+  , term_callback      (NULL)
+  , learn_state        (NULL)
+  , learn_callback     (NULL)
+  , learn_max_size     (0)
+  , learn_max_lbd      (INT32_MAX)
+  , import_state       (NULL)
+  , import_callback    (NULL)
 
   // Statistics: (formerly in 'SolverStats')
   //
   , solves(0), starts(0), decisions(0), rnd_decisions(0), propagations(0), conflicts(0), conflicts_VSIDS(0)
   , dec_vars(0), clauses_literals(0), learnts_literals(0), max_literals(0), tot_literals(0)
+  , reused_restarts(0), reused_levels(0), reused_props(0)
 
   , ok                 (true)
   , totalCDPhaseLen         (0) 
@@ -161,6 +177,7 @@ Solver::Solver() :
   , next_T2_reduce     (10000)
   , next_L_reduce      (15000)
 
+  , switch_deadline    (-1)
   , counter            (0)
 
   // Resource constraints:
@@ -1659,6 +1676,57 @@ bool Solver::simplify()
 }
 
 
+/*_________________________________________________________________________________________________
+|
+|  importClauses : [void]  ->  [bool]
+|  
+|  Description:
+|    Adds the clauses handed over by 'import_callback' (if any) as problem clauses. Must be called
+|    at decision level 0. Returns FALSE if an imported clause made the formula unsatisfiable.
+|________________________________________________________________________________________________@*/
+bool Solver::importClauses()
+{
+    if (import_callback == NULL) return true;
+    assert(decisionLevel() == 0);
+
+    for (;;){
+        add_tmp.clear();
+        if (!import_callback(import_state, add_tmp)) break;
+        if (!addClause_(add_tmp)) return false;
+    }
+    return true;
+}
+
+
+// Partial restarts: a full restart would decide the variables above the top of the order heap again
+// (phase saving repeats their values), so the levels whose decisions rank above it are kept, as are
+// the levels of the assumptions. A due round of 'simplifyAll()' makes it a full restart; imported
+// clauses wait for one.
+int Solver::reuseTrailLevel()
+{
+    if (!reuse_trail || conflicts >= curSimplify * nbconfbeforesimplify)
+        return 0;
+
+    Heap<VarOrderLt>&  order_heap = VSIDS ? order_heap_VSIDS : order_heap_CHB;
+    const vec<double>& activity   = VSIDS ? activity_VSIDS   : activity_CHB;
+    while (!order_heap.empty() && (value(order_heap[0]) != l_Undef || !decision[order_heap[0]]))
+        order_heap.removeMin();
+    if (order_heap.empty())
+        return 0;
+
+    double top   = activity[order_heap[0]];
+    int    level = assumptions.size() < decisionLevel() ? assumptions.size() : decisionLevel();
+    while (level < decisionLevel() && activity[var(trail[trail_lim[level]])] > top)
+        level++;
+
+    if (level > 0){
+        reused_restarts++;
+        reused_levels += level;
+        reused_props  += (level < decisionLevel() ? trail_lim[level] : trail.size()) - trail_lim[0]; }
+    return level;
+}
+
+
 /*_________________________________________________________________________________________________
  |
  |  search : (nof_conflicts : int) (params : const SearchParams&)  ->  [lbool]
@@ -1679,6 +1747,9 @@ lbool Solver::search(int& nof_conflicts)
     vec<Lit>    learnt_clause;
     bool        cached = false;
     starts++;
+
+    if (decisionLevel() == 0 && !importClauses())
+        return l_False;
     
     // simplify
     //
@@ -1752,6 +1823,10 @@ lbool Solver::search(int& nof_conflicts)
 #endif
             }
             
+            if (learn_callback != NULL && learnt_clause.size() <= learn_max_size &&
+                (learnt_clause.size() == 1 || lbd <= learn_max_lbd))
+                learn_callback(learn_state, learnt_clause);
+
             if (VSIDS) varDecayActivity();
             claDecayActivity();
             
@@ -1776,12 +1851,12 @@ lbool Solver::search(int& nof_conflicts)
                 restart = lbd_queue.full() && (lbd_queue.avg() * 0.8 > global_lbd_sum / conflicts_VSIDS);
                 cached = true;
             }
-            if (restart /*|| !withinBudget()*/){
+            if (restart || !withinBudget()){
                 lbd_queue.clear();
                 cached = false;
                 // Reached bound on number of conflicts:
                 progress_estimate = progressEstimate();
-                cancelUntil(0);
+                cancelUntil(restart && withinBudget() ? reuseTrailLevel() : 0);
                 return l_Undef; }
             
             // Simplify the set of problem clauses:
@@ -1883,33 +1958,11 @@ static double luby(double y, int x){
 }
 
 
-static bool switch_mode = false;
-
-#ifdef _MSC_VER_Sleep
-void sleep(int time)
-{
-    Sleep(time * 1000);
-    switch_mode = true;
-    printf("switch_mode = true\n");
-}
-
-#else
-
-static void SIGALRM_switch(int signum) { switch_mode = true; }
-#endif
-
-
 // NOTE: assumptions passed in member-variable 'assumptions'.
 lbool Solver::solve_()
 {
-#ifdef _MSC_VER_Sleep
-    std::thread t(sleep, 2500);
-    t.detach();
-#else
-    signal(SIGALRM, SIGALRM_switch);
-    alarm(2500);
-#endif
-    
+    switch_deadline = cpuTime() + switch_time;
+
     model.clear(); usedClauses.clear();
     conflict.clear();
     if (!ok) return l_False;
@@ -1942,13 +1995,15 @@ lbool Solver::solve_()
     phase1Done=false;
     
     int init = 10000;
-    while (status == l_Undef && init > 0 /*&& withinBudget()*/)
+    while (status == l_Undef && init > 0 && withinBudget())
         status = search(init);
+    // Each mode refills its own order heap when backtracking:
+    if (status == l_Undef) cancelUntil(0);
     VSIDS = false;
     phase1Done=true;
     // Search:
     int curr_restarts = 0;
-    while (status == l_Undef /*&& withinBudget()*/){
+    while (status == l_Undef && withinBudget()){
         if (VSIDS){
             int weighted = INT32_MAX;
             status = search(weighted);
@@ -1957,7 +2012,8 @@ lbool Solver::solve_()
             curr_restarts++;
             status = search(nof_conflicts);
         }
-        if (!VSIDS && switch_mode){
+        if (status == l_Undef && !VSIDS && cpuTime() >= switch_deadline){
+            cancelUntil(0);
             phase1Done=true;            
             VSIDS = true;
            // printf("c Switched to VSIDS.\n");
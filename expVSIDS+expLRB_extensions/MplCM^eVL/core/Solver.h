@@ -191,10 +191,25 @@ public:
     int       learntsize_adjust_start_confl;
     double    learntsize_adjust_inc;
 
+    double    switch_time;        // CPU seconds of CHB search before switching to VSIDS for good.                           (default 2500)
+    bool      reuse_trail;        // Restarts keep the levels whose decisions rank above the top of the order heap.          (default false)
+
+    // Incremental interface hooks (used by the IPASIR wrapper and the portfolio driver):
+    //
+    void*     term_state;
+    int     (*term_callback)(void* state);                  // Polled by 'withinBudget()'; non-zero stops the search.
+    void*     learn_state;
+    void    (*learn_callback)(void* state, const vec<Lit>& c); // Receives each learnt clause of size <= 'learn_max_size'.
+    int       learn_max_size;
+    int       learn_max_lbd;      // Non-unit learnt clauses are only passed on if their stored LBD is at most this.         (default INT32_MAX)
+    void*     import_state;
+    bool    (*import_callback)(void* state, vec<Lit>& c);   // Polled at level 0 by 'search()'; fills 'c' and returns true while clauses are pending.
+
     // Statistics: (read-only member variable)
     //
     uint64_t solves, starts, decisions, rnd_decisions, propagations, conflicts, conflicts_VSIDS;
     uint64_t dec_vars, clauses_literals, learnts_literals, max_literals, tot_literals;
+    uint64_t reused_restarts, reused_levels, reused_props;
 
     vec<uint32_t> picked;
     vec<uint32_t> conflicted;
@@ -282,6 +297,8 @@ protected:
     uint64_t            next_T2_reduce,
                         next_L_reduce;
 
+    double              switch_deadline;  // CPU time at which the CHB phase ends; set by 'solve_()'.
+
     ClauseAllocator     ca;
 
     // Temporaries (to reduce allocation overhead). Each variable is prefixed by the method in which it is
@@ -352,6 +369,8 @@ protected:
     void     analyzeFinal     (Lit p, vec<Lit>& out_conflict);                         // COULD THIS BE IMPLEMENTED BY THE ORDINARIY "analyze" BY SOME REASONABLE GENERALIZATION?
     bool     litRedundant     (Lit p, uint32_t abstract_levels);                       // (helper method for 'analyze()')
     lbool    search           (int& nof_conflicts);                                    // Search for a given number of conflicts.
+    int      reuseTrailLevel  ();                                                      // The level a restart backtracks to (see 'reuse_trail').
+    bool     importClauses    ();                                                      // Add the clauses offered by 'import_callback'.
     lbool    solve_           ();                                                      // Main solve method (assumptions given in 'assumptions').
     void     reduceDB         ();                                                      // Reduce the set of learnt clauses.
     void     reduceDB_Tier2   ();
@@ -567,7 +586,7 @@ inline void     Solver::interrupt(){ asynch_interrupt = true; }
 inline void     Solver::clearInterrupt(){ asynch_interrupt = false; }
 inline void     Solver::budgetOff(){ conflict_budget = propagation_budget = -1; }
 inline bool     Solver::withinBudget() const {
-    return !asynch_interrupt &&
+    return !asynch_interrupt && (term_callback == NULL || !term_callback(term_state)) &&
            (conflict_budget    < 0 || conflicts < (uint64_t)conflict_budget) &&
            (propagation_budget < 0 || propagations < (uint64_t)propagation_budget); }
 
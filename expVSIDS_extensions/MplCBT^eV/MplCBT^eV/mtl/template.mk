@@ -25,7 +25,7 @@ LFLAGS    ?= -Wall
 COPTIMIZE ?= -O3
 
 CFLAGS    += -I$(MROOT) -D __STDC_LIMIT_MACROS -D __STDC_FORMAT_MACROS
-LFLAGS    += -lz
+LFLAGS    += -lz -lpthread
 
 .PHONY : s p d r rs clean 
 
@@ -0,0 +1,269 @@
+/***********************************************************************************[Checkpoint.cc]
+Checkpoint and resume of the search state: the clause arena, the original and tiered learnt clause
+lists, the top-level trail, the CHB/VSIDS activities, the saved polarities, the exploration
+statistics and the random seed.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+**************************************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#include "core/Solver.h"
+#include "core/CheckpointIO.h"
+
+using namespace Minisat;
+
+//=================================================================================================
+// File format:
+//
+// A checkpoint is the magic "MCKP", a format version and the number of variables, followed by the
+// fields listed in 'transferState()' in native byte order. Vectors are stored as their size
+// followed by their elements; the clause arena is stored as its raw region, so clause references
+// in the clause lists stay valid. Lists that are rebuilt from the clauses (watches, order heaps)
+// and short-lived search data (the LBD queue, the Luby restart index) are not stored.
+
+static const char     checkpoint_magic[4] = { 'M', 'C', 'K', 'P' };
+static const uint32_t checkpoint_version  = 2;
+
+
+//=================================================================================================
+// Reading and writing:
+
+
+void Solver::transferState(CheckpointIO& io)
+{
+    // Clause arena:
+    uint32_t arena_size = ca.size(), arena_wasted = ca.wasted();
+    io.field(arena_size);
+    io.field(arena_wasted);
+    io.field(ca.extra_clause_field);
+    if (io.writing)
+        io.bytes((void*)ca.raw(), sizeof(uint32_t) * arena_size);
+    else if (io.ok)
+        io.bytes(ca.setRaw(arena_size, arena_wasted), sizeof(uint32_t) * arena_size);
+
+    io.array(clauses);
+    io.array(learnts_core);
+    io.array(learnts_tier2);
+    io.array(learnts_local);
+    io.array(trail);
+
+    // Heuristic state:
+    io.array(activity_CHB);
+    io.array(activity_VSIDS);
+    io.array(polarity);
+    io.array(picked);
+    io.array(conflicted);
+    io.array(almost_conflicted);
+#ifdef ANTI_EXPLORATION
+    io.array(canceled);
+#endif
+    io.field(random_seed);
+    io.field(var_inc);
+    io.field(cla_inc);
+    io.field(var_decay);
+    io.field(timer);
+    io.field(step_size);
+    io.field(VSIDS);
+    io.field(phase1Done);
+    io.field(vsids_warmup);
+    io.field(core_lbd_cut);
+    io.field(global_lbd_sum);
+    io.field(next_T2_reduce);
+    io.field(next_L_reduce);
+
+    // Statistics:
+    io.field(starts);
+    io.field(decisions);
+    io.field(rnd_decisions);
+    io.field(propagations);
+    io.field(conflicts);
+    io.field(conflicts_VSIDS);
+    io.field(max_literals);
+    io.field(tot_literals);
+    io.field(numGlueClauses);
+    io.field(totalLBD);
+
+    // Exploration statistics:
+    io.field(decisions_CDPhase);
+    io.field(decisions_NonCDPhase);
+    io.field(totalCDPhaseLen);
+    io.field(CDPhaseCount);
+    io.field(numExpConflicts);
+    io.field(expTotalLBD);
+    io.field(expGlueClauses);
+    io.field(numExpEpisodes);
+    io.field(numExpSteps);
+    io.field(numMissedExpSteps);
+    io.field(expInc);
+    io.field(topReplaced);
+    io.field(explorationOverhead);
+    io.field(decisionsWithoutConflicts);
+    io.field(decisionsWithConflicts);
+    io.field(phase2Decisions);
+    io.field(lastDecisionHadConflicts);
+    io.field(avgCDPhaseLen);
+    io.field(toReachConflict);
+    io.field(successiveDecisionsWithoutConfs);
+}
+
+
+bool Solver::writeCheckpoint(const char* file)
+{
+    assert(decisionLevel() == 0);
+    FILE* f = fopen(file, "wb");
+    if (f == NULL) return false;
+
+    CheckpointIO io(f, true);
+    uint32_t     version = checkpoint_version;
+    int          vars    = nVars();
+    // The CHB phase is timed in CPU seconds, which start over in the resumed process:
+    double       switch_left = switch_deadline - cpuTime();
+
+    io.bytes((void*)checkpoint_magic, sizeof(checkpoint_magic));
+    io.field(version);
+    io.field(vars);
+    io.field(switch_left);
+    transferState(io);
+
+    return fclose(f) == 0 && io.ok;
+}
+
+
+bool Solver::readCheckpoint(const char* file)
+{
+    assert(decisionLevel() == 0);
+    if (!ok) return false;
+    FILE* f = fopen(file, "rb");
+    if (f == NULL) return false;
+
+    CheckpointIO io(f, false);
+    char         magic[4];
+    uint32_t     version;
+    int          vars;
+    double       switch_left;
+
+    io.bytes(magic, sizeof(magic));
+    io.field(version);
+    io.field(vars);
+    io.field(switch_left);
+    if (!io.ok || memcmp(magic, checkpoint_magic, sizeof(magic)) != 0 || version != checkpoint_version || vars != nVars()){
+        fclose(f);
+        return false; }
+
+    // Drop the current clause database; the restored one replaces it wholesale:
+    watches.cleanAll();
+    watches_bin.cleanAll();
+    for (Var v = 0; v < nVars(); v++)
+        for (int s = 0; s < 2; s++){
+            watches    [mkLit(v, s)].clear();
+            watches_bin[mkLit(v, s)].clear(); }
+    vec<Lit> units;
+    trail.copyTo(units);
+
+    transferState(io);
+    fclose(f);
+    if (!io.ok || activity_CHB.size() != nVars() || activity_VSIDS.size() != nVars() || polarity.size() != nVars())
+        return false;
+
+    // Re-establish the top-level assignment (reasons are not needed at level 0) and the watches:
+    vec<Lit> restored;
+    trail.moveTo(restored);
+    trail.capacity(nVars());
+    for (int i = 0; i < units.size(); i++)
+        assigns[var(units[i])] = l_Undef;
+    for (int i = 0; i < units.size(); i++)
+        if (value(units[i]) == l_Undef)
+            uncheckedEnqueue(units[i]);
+    for (int i = 0; i < restored.size(); i++)
+        if (value(restored[i]) == l_Undef)
+            uncheckedEnqueue(restored[i]);
+        else if (value(restored[i]) == l_False)
+            return ok = false;
+
+    // The tier lists are filtered lazily, so they may still hold deleted clauses and clauses that
+    // have moved to another tier; only the entries matching the clause's mark are kept:
+    vec<CRef>* lists[] = { &clauses, &learnts_core, &learnts_tier2, &learnts_local };
+    unsigned   marks[] = { 0, CORE, TIER2, LOCAL };
+    clauses_literals = learnts_literals = 0;
+    for (int l = 0; l < 4; l++){
+        vec<CRef>& cs = *lists[l];
+        int i, j;
+        for (i = j = 0; i < cs.size(); i++)
+            if (ca[cs[i]].mark() == marks[l]){
+                attachClause(cs[i]);
+                cs[j++] = cs[i]; }
+        cs.shrink(i - j);
+    }
+
+    qhead           = 0;
+    gauss_dirty     = xors.size() > 0;
+    simpDB_assigns  = -1;
+    simpDB_props    = 0;
+    switch_deadline = cpuTime() + switch_left;
+    next_checkpoint = conflicts + checkpoint_interval;
+    rebuildOrderHeap();
+
+    if (propagate() != CRef_Undef)
+        ok = false;
+    return true;
+}
+
+
+// Forks a child that writes the checkpoint while the parent carries on searching. The file is
+// written under a temporary name and renamed, so an interrupted write never clobbers the previous
+// checkpoint. Only one writer runs at a time; a request made while it runs is kept pending.
+void Solver::checkpoint()
+{
+    if (checkpoint_child != -1){
+        int   status;
+        pid_t done = waitpid(checkpoint_child, &status, WNOHANG);
+        if (done == 0) return;
+        if (done == checkpoint_child && (!WIFEXITED(status) || WEXITSTATUS(status) != 0))
+            fprintf(stderr, "c WARNING! Could not write checkpoint %s\n", checkpoint_file);
+        checkpoint_child = -1; }
+
+    checkpoint_requested = 0;
+    next_checkpoint      = conflicts + checkpoint_interval;
+
+    char tmp[4096];
+    snprintf(tmp, sizeof(tmp), "%s.tmp", checkpoint_file);
+
+    // Only the calling thread lives on in the child, which could block forever on a lock (e.g. in
+    // malloc) held by the vivification helper at the time of the fork:
+    vivifyWait();
+
+    double cpu = cpuTime();
+    fflush(stdout);
+    pid_t pid = fork();
+    if (pid == 0){
+        // The child's CPU time starts from zero; keep the remaining CHB time as seen by the parent.
+        switch_deadline -= cpu - cpuTime();
+        bool written = writeCheckpoint(tmp) && rename(tmp, checkpoint_file) == 0;
+        _exit(written ? 0 : 1);
+    }else if (pid < 0){
+        // Could not fork: write the checkpoint in this process.
+        if (!writeCheckpoint(tmp) || rename(tmp, checkpoint_file) != 0)
+            fprintf(stderr, "c WARNING! Could not write checkpoint %s\n", checkpoint_file);
+    }else
+        checkpoint_child = pid;
+
+    if (verbosity >= 1)
+        printf("c Checkpoint at %" PRIu64 " conflicts%s\n", conflicts, pid > 0 ? " (background)" : "");
+}
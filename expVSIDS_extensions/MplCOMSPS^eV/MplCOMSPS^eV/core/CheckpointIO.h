@@ -0,0 +1,57 @@
+/**********************************************************************************[CheckpointIO.h]
+Binary reading and writing of solver state, shared by the checkpoints (see 'Checkpoint.cc') and
+the preprocessing cache (see 'simp/PreCache.cc').
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+**************************************************************************************************/
+
+#ifndef Minisat_CheckpointIO_h
+#define Minisat_CheckpointIO_h
+
+#include <stdio.h>
+
+#include "mtl/Vec.h"
+
+namespace Minisat {
+
+// Fields are stored in native byte order; vectors as their size followed by their elements.
+struct CheckpointIO {
+    FILE* f;
+    bool  writing;
+    bool  ok;
+
+    CheckpointIO(FILE* file, bool w) : f(file), writing(w), ok(true) {}
+
+    void bytes(void* p, size_t n) {
+        if (!ok || n == 0) return;
+        ok = writing ? fwrite(p, 1, n, f) == n : fread(p, 1, n, f) == n; }
+
+    template<class T>
+    void field(T& x) { bytes(&x, sizeof(T)); }
+
+    template<class T>
+    void array(vec<T>& v) {
+        int n = v.size();
+        field(n);
+        if (!ok || n < 0){ ok = false; return; }
+        if (!writing){ v.clear(); v.growTo(n); }
+        if (n > 0) bytes(&v[0], sizeof(T) * n); }
+};
+
+//=================================================================================================
+}
+
+#endif
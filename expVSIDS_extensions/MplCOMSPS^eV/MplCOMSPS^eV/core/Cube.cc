@@ -0,0 +1,390 @@
+/*****************************************************************************************[Cube.cc]
+Cube and conquer: the problem is split into cubes (sets of assumptions) by a lookahead on the
+variables that the exploration walks find close to short conflicts, and the cubes are solved on
+several threads, each with an incremental copy of the problem.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+**************************************************************************************************/
+
+#include <math.h>
+#include <pthread.h>
+#include <unistd.h>
+
+#include "mtl/Sort.h"
+#include "utils/Options.h"
+#include "utils/System.h"
+#include "core/Solver.h"
+
+using namespace Minisat;
+
+//=================================================================================================
+// Options:
+
+
+static const char* _cat = "CUBE";
+
+static IntOption opt_cube_depth  (_cat, "cube-depth",      "Maximal number of branching decisions in a cube", 10, IntRange(1, 30));
+static IntOption opt_cube_cands  (_cat, "cube-cands",      "Variables looked ahead at each node of the splitting tree", 16, IntRange(1, INT32_MAX));
+static IntOption opt_cube_walks  (_cat, "cube-walks",      "Exploration walks run at each node to pick the candidates", 32, IntRange(0, INT32_MAX));
+static IntOption opt_cube_warmup (_cat, "cube-warmup",     "Conflicts of ordinary search before splitting", 10000, IntRange(0, INT32_MAX));
+static IntOption opt_conq_threads(_cat, "conquer-threads", "Threads solving cubes (0 = one per processor)", 0, IntRange(0, 1024));
+
+
+//=================================================================================================
+// Cubing:
+//
+// At each node of the splitting tree, 'mW' is raised to '-cube-walks' and the exploration walks
+// are run from the node. Every walk that ends in a conflict scores the variables it decided on
+// as in 'computeExplorationScore()': 1/LBD of the conflict, decayed by 0.9 per step away from
+// it. The best scored variables (topped up with the most active ones) are looked ahead, both
+// polarities, and the node branches on the one maximizing 'pos * neg + pos + neg' (the number of
+// literals each polarity implies), weighted up by its walk score. A polarity that fails makes the
+// other one part of the cube; a node where both fail is refuted and emits no cube.
+
+
+struct ScoreGt {
+    const vec<double>& score;
+    bool operator () (Var x, Var y) const { return score[x] > score[y]; }
+    ScoreGt(const vec<double>& s) : score(s) {}
+};
+
+
+// Propagates 'p' on a new decision level and backtracks. Returns the number of literals assigned
+// (including 'p'), or -1 on a conflict.
+int Solver::lookahead(Lit p)
+{
+    int before = trail.size();
+    newDecisionLevel();
+    uncheckedEnqueue(p);
+    CRef confl = propagate();
+    int  props = trail.size() - before;
+    cancelUntil(decisionLevel() - 1);
+    return confl == CRef_Undef ? props : -1;
+}
+
+
+// Picks the variable to branch on at the current node, assigning the failed literals found on the
+// way (one decision level each, appended to 'path'). Returns 'var_Undef' if no variable is left to
+// branch on, and sets 'refuted' if the node turned out to be unsatisfiable.
+Var Solver::splitVariable(vec<Lit>& path, vec<double>& score, bool& refuted)
+{
+    refuted = false;
+
+    // Walk scores:
+    vec<Var> cands;
+    if (opt_cube_walks > 0 && !order_heap_VSIDS.empty()){
+        uint32_t walks = mW;
+        mW = opt_cube_walks;
+        explore();
+        mW = walks;
+        for (int w = 0; w < walkWithConf.size(); w++){
+            if (!walkWithConf[w]) continue;
+            std::map<int,uint32_t>& steps = stepVarMap[w];
+            int    n   = steps.size();
+            double lbd = stepLBDMap[w][n - 1] > 0 ? stepLBDMap[w][n - 1] : 1;
+            for (int k = n - 1; k >= 0; k--){
+                Var v = steps[k];
+                if (score[v] == 0) cands.push(v);
+                score[v] += pow(0.9, n - 1 - k) / lbd; } }
+        sort(cands, ScoreGt(score));
+    }
+    double best_walk = cands.size() > 0 ? score[cands[0]] : 1;
+
+    // Topped up with the most active variables (the first entries of the heap are among them):
+    int want = opt_cube_cands;
+    for (int i = 0; i < order_heap_VSIDS.size() && cands.size() < want + 8 && i < 4 * want; i++){
+        Var v = order_heap_VSIDS[i];
+        if (score[v] == 0){ score[v] = -1; cands.push(v); } }
+
+    // Lookahead:
+    Var    best       = var_Undef;
+    double best_score = -1;
+    int    looked     = 0;
+    for (int i = 0; i < cands.size() && looked < want && !refuted; i++){
+        Var v = cands[i];
+        if (value(v) != l_Undef || !decision[v]) continue;
+        looked++;
+        int pos = lookahead(mkLit(v, false));
+        int neg = lookahead(mkLit(v, true));
+        if (pos < 0 && neg < 0)
+            refuted = true;
+        else if (pos < 0 || neg < 0){
+            Lit forced = mkLit(v, pos < 0);
+            newDecisionLevel();
+            uncheckedEnqueue(forced);
+            path.push(forced);
+            refuted = propagate() != CRef_Undef;
+            best = var_Undef, best_score = -1;   // (earlier scores were taken before 'forced')
+        }else{
+            double s = ((double)pos * neg + pos + neg) * (1 + (score[v] > 0 ? score[v] / best_walk : 0));
+            if (s > best_score) best = v, best_score = s; }
+    }
+    for (int i = 0; i < cands.size(); i++)
+        score[cands[i]] = 0;
+
+    // Nothing looked ahead but unassigned variables left (all candidates were assigned): any will do.
+    if (best == var_Undef && !refuted)
+        for (int i = 0; i < order_heap_VSIDS.size() && best == var_Undef; i++)
+            if (value(order_heap_VSIDS[i]) == l_Undef)
+                best = order_heap_VSIDS[i];
+    return best;
+}
+
+
+// Appends the cubes below 'path' to 'out', each ended by 'lit_Undef', and counts them in 'n_out'.
+void Solver::cubeNode(int depth, vec<Lit>& path, vec<Lit>& out, int& n_out, vec<double>& score, int& refuted)
+{
+    if (depth >= opt_cube_depth){
+        for (int i = 0; i < path.size(); i++)
+            out.push(path[i]);
+        out.push(lit_Undef);
+        n_out++;
+        return; }
+
+    int  level = decisionLevel(), size = path.size();
+    bool node_refuted;
+    Var  v = splitVariable(path, score, node_refuted);
+
+    if (node_refuted)
+        refuted++;
+    else if (v == var_Undef){
+        for (int i = 0; i < path.size(); i++)
+            out.push(path[i]);
+        out.push(lit_Undef);
+        n_out++;
+    }else{
+        int branch_level = decisionLevel();
+        for (int b = 0; b < 2; b++){
+            Lit p = mkLit(v, b == 0 ? polarity[v] : !polarity[v]);
+            newDecisionLevel();
+            uncheckedEnqueue(p);
+            if (propagate() != CRef_Undef)
+                refuted++;
+            else{
+                path.push(p);
+                cubeNode(depth + 1, path, out, n_out, score, refuted);
+                path.pop(); }
+            cancelUntil(branch_level);
+        }
+    }
+    cancelUntil(level);
+    path.shrink(path.size() - size);
+}
+
+
+lbool Solver::cube(vec<Lit>& out_cubes)
+{
+    double start = cpuTime();
+    out_cubes.clear();
+
+    // A short ordinary search first settles the activities, polarities and average LBD (and may
+    // well solve easy problems):
+    if (opt_cube_warmup > 0){
+        vec<Lit> none;
+        setConfBudget(opt_cube_warmup);
+        lbool status = solveLimited(none);
+        budgetOff();
+        if (status != l_Undef) return status;
+    }else if (!simplify())
+        return l_False;
+
+    initExpParameters();
+    vec<double> score(nVars(), 0);
+    vec<Lit>    path;
+    int         refuted = 0, n_cubes = 0;
+    cubeNode(0, path, out_cubes, n_cubes, score, refuted);
+
+    if (verbosity > 0)
+        printf("c Cubes: %d (%d refuted while splitting) of depth <= %d in %.2f s\n", n_cubes, refuted, (int)opt_cube_depth, cpuTime() - start);
+    return n_cubes == 0 ? l_False : l_Undef;
+}
+
+
+//=================================================================================================
+// Conquering:
+//
+// Every thread builds its own copy of the problem, then takes the next unsolved cube and solves
+// under it as assumptions. A thread keeps its solver from cube to cube, so the clauses it learnt
+// carry over, and adds the final conflict of each refuted cube as a clause (it usually refutes a
+// prefix shared with the following cubes). An empty final conflict, or a model, ends all threads.
+
+
+void Solver::copyProblemTo(Solver& to) const
+{
+    vec<Lit> c;
+    while (to.nVars() < nVars()){
+        Var v = to.nVars();
+        to.newVar(polarity[v], decision[v]);
+        to.setAuxiliary(v, auxiliary[v]); }
+
+    for (int i = 0; i < trail.size(); i++)
+        to.addClause(trail[i]);
+
+    for (int k = 0; k < 2; k++){
+        const vec<CRef>& cs = k == 0 ? clauses : learnts_core;
+        for (int i = 0; i < cs.size(); i++){
+            const Clause& cl = ca[cs[i]];
+            if (cl.mark() != 0) continue;
+            bool satisfied = false;
+            c.clear();
+            for (int j = 0; j < cl.size() && !satisfied; j++)
+                if (value(cl[j]) == l_True)
+                    satisfied = true;
+                else if (value(cl[j]) == l_Undef)
+                    c.push(cl[j]);
+            if (!satisfied && !to.addClause(c)) return;
+        }
+    }
+}
+
+
+namespace {
+
+struct Conquest;
+
+struct ConquerWorker {
+    Conquest* conquest;
+    int       id;
+    Solver*   solver;
+    int       solved;       // Cubes refuted or satisfied by this thread.
+};
+
+struct Conquest {
+    const Solver*          master;
+    const vec<Lit>*        cubes;    // One after the other, each ended by 'lit_Undef',
+    vec<int>               cube_at;  // where each starts.
+    volatile int           next;     // Index of the next cube to hand out.
+    volatile int           stop;
+    lbool                  result;
+    vec<lbool>             model;
+    pthread_mutex_t        lock;
+};
+
+int conquestStopped(void* state) { return ((Conquest*)state)->stop; }
+
+void finishConquest(Conquest& c, lbool result, const vec<lbool>* model)
+{
+    pthread_mutex_lock(&c.lock);
+    if (c.result == l_Undef){
+        c.result = result;
+        if (model != NULL) model->copyTo(c.model); }
+    c.stop = 1;
+    pthread_mutex_unlock(&c.lock);
+}
+
+void* conquerThread(void* arg)
+{
+    ConquerWorker& w = *(ConquerWorker*)arg;
+    Conquest&      c = *w.conquest;
+    Solver&        S = *w.solver;
+
+    S.verbosity     = 0;
+    S.mWDefault     = c.master->mWDefault;
+    S.mSDefault     = c.master->mSDefault;
+    S.prThDefault   = c.master->prThDefault;
+    S.random_seed  += w.id;
+    S.term_state    = &c;
+    S.term_callback = conquestStopped;
+    c.master->copyProblemTo(S);
+    if (!S.okay()){
+        finishConquest(c, l_False, NULL);
+        return NULL; }
+
+    vec<Lit> assumps;
+    while (!c.stop){
+        int i = __sync_fetch_and_add(&c.next, 1);
+        if (i >= c.cube_at.size()) break;
+
+        assumps.clear();
+        for (int k = c.cube_at[i]; (*c.cubes)[k] != lit_Undef; k++)
+            assumps.push((*c.cubes)[k]);
+        lbool status = S.solveLimited(assumps);
+        if (status == l_True){
+            w.solved++;
+            finishConquest(c, l_True, &S.model);
+        }else if (status == l_False){
+            w.solved++;
+            if (S.conflict.size() == 0 || !S.addClause(S.conflict))
+                finishConquest(c, l_False, NULL);
+        }
+    }
+    return NULL;
+}
+
+}
+
+
+lbool Solver::conquer(const vec<Lit>& cubes)
+{
+    Conquest c;
+    for (int k = 0; k < cubes.size(); k++)
+        if (k == 0 || cubes[k - 1] == lit_Undef)
+            c.cube_at.push(k);
+    int    n_cubes = c.cube_at.size();
+
+    double start = cpuTime();
+    int    threads = opt_conq_threads;
+    if (threads == 0){
+        long procs = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = procs > 0 ? (int)procs : 1; }
+    if (threads > n_cubes) threads = n_cubes;
+    if (threads < 1)       threads = 1;
+
+    c.master = this;
+    c.cubes  = &cubes;
+    c.next   = 0;
+    c.stop   = 0;
+    c.result = l_Undef;
+    pthread_mutex_init(&c.lock, NULL);
+
+    ConquerWorker* workers = new ConquerWorker[threads];
+    pthread_t*     ids     = new pthread_t[threads];
+    int            started = 0;
+    for (int t = 0; t < threads; t++){
+        workers[t].conquest = &c;
+        workers[t].id       = t;
+        workers[t].solver   = new Solver;
+        workers[t].solved   = 0; }
+    for (; started < threads; started++)
+        if (pthread_create(&ids[started], NULL, conquerThread, &workers[started]) != 0) break;
+    if (started == 0)               // Could not start a thread: conquer here.
+        conquerThread(&workers[started++]);
+    for (int t = 0; t < started; t++)
+        pthread_join(ids[t], NULL);
+
+    // No model and no empty conflict: every cube was refuted.
+    lbool    result  = c.result == l_Undef && c.next >= n_cubes ? l_False : c.result;
+    int      solved  = 0;
+    uint64_t confls  = 0;
+    for (int t = 0; t < started; t++){
+        solved += workers[t].solved;
+        confls += workers[t].solver->conflicts; }
+    if (result == l_True)
+        c.model.copyTo(model);
+
+    if (verbosity > 0)
+        printf("c Conquer: %d of %d cubes solved on %d threads, %" PRIu64 " conflicts, %.2f s CPU\n", solved, n_cubes, started, confls, cpuTime() - start);
+    if (verbosity > 1)
+        for (int t = 0; t < started; t++)
+            printf("c   thread %2d: %6d cubes %12" PRIu64 " conflicts\n", t, workers[t].solved, workers[t].solver->conflicts);
+
+    for (int t = 0; t < threads; t++)
+        delete workers[t].solver;
+    delete [] workers;
+    delete [] ids;
+    pthread_mutex_destroy(&c.lock);
+    return result;
+}
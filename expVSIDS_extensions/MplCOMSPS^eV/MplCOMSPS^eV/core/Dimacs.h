@@ -44,8 +44,18 @@ static void readClause(B& in, Solver& S, vec<Lit>& lits) {
     }
 }
 
+// Folds the clause 'lits' into 'hash', a 64-bit FNV-1a hash of the clause stream (start it with
+// 'dimacs_hash_init').
+static const uint64_t dimacs_hash_init = 14695981039346656037ULL;
+static inline void hashClause(uint64_t& hash, const vec<Lit>& lits) {
+    for (int i = 0; i <= lits.size(); i++){
+        uint32_t x = i < lits.size() ? (uint32_t)toInt(lits[i]) + 1 : 0;
+        for (int b = 0; b < 4; b++, x >>= 8)
+            hash = (hash ^ (x & 0xff)) * 1099511628211ULL; }
+}
+
 template<class B, class Solver>
-static void parse_DIMACS_main(B& in, Solver& S) {
+static void parse_DIMACS_main(B& in, Solver& S, uint64_t* hash = NULL) {
     vec<Lit> lits;
     int vars    = 0;
     int clauses = 0;
@@ -68,6 +78,7 @@ static void parse_DIMACS_main(B& in, Solver& S) {
         else{
             cnt++;
             readClause(in, S, lits);
+            if (hash != NULL) hashClause(*hash, lits);
             S.addClause_(lits); }
     }
     if (vars != S.nVars())
@@ -76,12 +87,12 @@ static void parse_DIMACS_main(B& in, Solver& S) {
         fprintf(stderr, "WARNING! DIMACS header mismatch: wrong number of clauses.\n");
 }
 
-// Inserts problem into solver.
+// Inserts problem into solver. If 'hash' is given, the clauses are folded into it as read.
 //
 template<class Solver>
-static void parse_DIMACS(gzFile input_stream, Solver& S) {
+static void parse_DIMACS(gzFile input_stream, Solver& S, uint64_t* hash = NULL) {
     StreamBuffer in(input_stream);
-    parse_DIMACS_main(in, S); }
+    parse_DIMACS_main(in, S, hash); }
 
 //=================================================================================================
 }
@@ -0,0 +1,377 @@
+/****************************************************************************************[Gauss.cc]
+Gauss-Jordan elimination over the XOR constraints found by the simplifier: an additional source of
+propagations and conflicts next to the clauses, run by the search after 'propagate()'.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+**************************************************************************************************/
+
+#include <string.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include "utils/Options.h"
+#include "core/Solver.h"
+
+using namespace Minisat;
+
+//=================================================================================================
+// Options:
+
+
+static const char* _cat = "GAUSS";
+
+static BoolOption opt_gauss      (_cat, "gauss",      "Propagate the XOR constraints found by the simplifier by Gauss-Jordan elimination.", true);
+static IntOption  opt_gauss_rows (_cat, "gauss-rows", "Largest number of XOR constraints in a matrix", 1024, IntRange(2, INT32_MAX));
+static IntOption  opt_gauss_cols (_cat, "gauss-cols", "Largest number of variables in a matrix", 1024, IntRange(2, INT32_MAX));
+
+
+//=================================================================================================
+// Gauss-Jordan elimination:
+//
+// The XOR constraints are split into connected components (by shared variables), and every
+// component with at least two of them and within '-gauss-rows' and '-gauss-cols' becomes a matrix
+// over GF(2): one bit-packed row per constraint, one column per variable and one for the
+// right-hand side. The rows are kept in reduced row echelon form with respect to the columns not
+// assigned yet: every row has a pivot column, unassigned, that no other row contains. When the
+// pivot of a row gets assigned, another unassigned column of the row becomes its pivot and is
+// eliminated from the other rows. Only the rows containing the assigned column, or changed by the
+// elimination, can then have a single unassigned column left (which is implied), or none with the
+// wrong parity (a conflict).
+//
+// Implications and conflicts get a clause made from the row: the implied literal first, then the
+// negations of the other assignments of the row. These clauses are no part of the clause database;
+// they are freed on backtracking. The rows are saved at the first change on every decision level,
+// and restored on backtracking.
+//
+// A row is a sum of the constraints, so its clauses follow from the problem, but not by unit
+// propagation; the matrices are not built while a proof is written.
+
+
+// Declares an XOR constraint over 'vs' implied by the clauses; the matrices are rebuilt at the
+// next restart.
+void Solver::addXor(const vec<Var>& vs, bool rhs)
+{
+    for (int i = 0; i < vs.size(); i++)
+        xors.push(vs[i]);
+    xors.push(var_Undef);
+    xor_rhs.push(rhs);
+    gauss_dirty = true;
+}
+
+
+static inline void xorRow(uint64_t* to, const uint64_t* from, int words)
+{
+    int k = 0;
+#ifdef __SSE2__
+    for (; k + 2 <= words; k += 2){
+        __m128i a = _mm_loadu_si128((const __m128i*)(to + k));
+        __m128i b = _mm_loadu_si128((const __m128i*)(from + k));
+        _mm_storeu_si128((__m128i*)(to + k), _mm_xor_si128(a, b)); }
+#endif
+    for (; k < words; k++)
+        to[k] ^= from[k];
+}
+
+
+static inline bool hasCol(const uint64_t* row, int c) { return (row[c >> 6] >> (c & 63)) & 1; }
+
+
+static int findRoot(vec<int>& parent, int x)
+{
+    while (parent[x] != x)
+        x = parent[x] = parent[parent[x]];
+    return x;
+}
+
+
+bool Solver::gaussBuild()
+{
+    assert(decisionLevel() == 0);
+    gauss_dirty = false;
+    for (int i = 0; i < gauss_mats.size(); i++)
+        delete gauss_mats[i];
+    gauss_mats.clear();
+    for (int i = 0; i < gauss_reasons.size(); i++)
+        ca.free(gauss_reasons[i]);
+    gauss_reasons.clear();
+    gauss_levels .clear();
+    for (Var v = 0; v < nVars(); v++)
+        gauss_mat[v] = gauss_col[v] = -1;
+    gauss_qhead = trail.size();
+
+    if (!opt_gauss || drup_file || xor_rhs.size() < 2)
+        return true;
+
+    // Substitute the top-level assignment, and group the constraints by shared variables. Row 'i'
+    // is 'rows[row_at[i]]' to 'rows[row_at[i+1]-1]':
+    int            n_rows = xor_rhs.size();
+    vec<Var>       rows;
+    vec<int>       row_at;
+    vec<char>      rhs (n_rows);
+    vec<int>       parent(nVars());
+    for (Var v = 0; v < nVars(); v++)
+        parent[v] = v;
+    for (int i = 0, k = 0; i < n_rows; i++, k++){
+        row_at.push(rows.size());
+        rhs[i] = xor_rhs[i];
+        for (; xors[k] != var_Undef; k++){
+            Var v = xors[k];
+            if (value(v) == l_Undef)
+                rows.push(v);
+            else
+                rhs[i] ^= value(v) == l_True; }
+        if (rows.size() == row_at[i] && rhs[i])
+            return ok = false;
+        for (int j = row_at[i] + 1; j < rows.size(); j++)
+            parent[findRoot(parent, rows[j])] = findRoot(parent, rows[row_at[i]]);
+    }
+    row_at.push(rows.size());
+
+    vec<int> comp_rows(nVars(), 0), comp_cols(nVars(), 0), comp_mat(nVars(), -1);
+    for (int i = 0; i < n_rows; i++)
+        if (row_at[i] < row_at[i + 1])
+            comp_rows[findRoot(parent, rows[row_at[i]])]++;
+    for (int j = 0; j < rows.size(); j++){
+        Var v = rows[j];
+        if (gauss_col[v] == -1){
+            gauss_col[v] = -2;
+            comp_cols[findRoot(parent, v)]++; } }
+
+    for (int i = 0; i < n_rows; i++){
+        if (row_at[i] == row_at[i + 1]) continue;
+        int root = findRoot(parent, rows[row_at[i]]);
+        if (comp_rows[root] < 2 || comp_rows[root] > opt_gauss_rows || comp_cols[root] > opt_gauss_cols)
+            continue;
+        if (comp_mat[root] == -1){
+            comp_mat[root] = gauss_mats.size();
+            gauss_mats.push(new GaussMatrix);
+            GaussMatrix& m = *gauss_mats.last();
+            m.n_cols = comp_cols[root];
+            m.words  = (m.n_cols + 1 + 63) / 64;
+            m.rows.growTo(comp_rows[root] * m.words, 0); }
+
+        int          mi = comp_mat[root];
+        GaussMatrix& m  = *gauss_mats[mi];
+        uint64_t*    r  = m.row(m.n_rows++);
+        for (int j = row_at[i]; j < row_at[i + 1]; j++){
+            Var v = rows[j];
+            if (gauss_mat[v] != mi){
+                gauss_mat[v] = mi;
+                gauss_col[v] = m.vars.size();
+                m.vars.push(v); }
+            r[gauss_col[v] >> 6] ^= (uint64_t)1 << (gauss_col[v] & 63); }
+        if (rhs[i])
+            r[m.n_cols >> 6] ^= (uint64_t)1 << (m.n_cols & 63);
+    }
+    for (Var v = 0; v < nVars(); v++)
+        if (gauss_mat[v] == -1)
+            gauss_col[v] = -1;
+
+    // Reduce every matrix; rows left without columns are dropped (or contradict the others):
+    for (int mi = 0; mi < gauss_mats.size(); mi++){
+        GaussMatrix& m = *gauss_mats[mi];
+        int n = 0;
+        m.pivot_row.growTo(m.n_cols, -1);
+        for (int c = 0; c < m.n_cols && n < m.n_rows; c++){
+            int i;
+            for (i = n; i < m.n_rows && !hasCol(m.row(i), c); i++);
+            if (i == m.n_rows) continue;
+            for (int k = 0; k < m.words; k++){
+                uint64_t tmp = m.row(i)[k]; m.row(i)[k] = m.row(n)[k]; m.row(n)[k] = tmp; }
+            for (i = 0; i < m.n_rows; i++)
+                if (i != n && hasCol(m.row(i), c))
+                    xorRow(m.row(i), m.row(n), m.words);
+            m.pivot.push(c);
+            m.pivot_row[c] = n++;
+        }
+        for (int i = n; i < m.n_rows; i++)
+            if (hasCol(m.row(i), m.n_cols))
+                return ok = false;
+        m.n_rows = n;
+        m.rows.shrink(m.rows.size() - n * m.words);
+
+        m.assigned.growTo(m.words, 0);
+        m.truth   .growTo(m.words, 0);
+        m.assigned[m.n_cols >> 6] |= (uint64_t)1 << (m.n_cols & 63);
+        m.truth   [m.n_cols >> 6] |= (uint64_t)1 << (m.n_cols & 63);
+        gauss_rows += n;
+
+        // Rows over a single variable are units:
+        for (int i = 0; i < m.n_rows; i++){
+            const uint64_t* r = m.row(i);
+            int cols = 0;
+            for (int k = 0; k < m.words; k++)
+                cols += __builtin_popcountll(r[k] & ~m.assigned[k]);
+            if (cols == 1){
+                gauss_props++;
+                uncheckedEnqueue(mkLit(m.vars[m.pivot[i]], !hasCol(r, m.n_cols))); }
+        }
+    }
+
+    return true;
+}
+
+
+void Solver::gaussSave(GaussMatrix& m)
+{
+    int level = decisionLevel();
+    if (level == 0 || (m.saved_level.size() > 0 && m.saved_level.last() == level))
+        return;
+
+    int rows  = m.saved_rows.size();
+    int pivot = m.saved_pivot.size();
+    m.saved_level.push(level);
+    m.saved_rows .growTo(rows + m.rows.size());
+    m.saved_pivot.growTo(pivot + m.n_rows);
+    memcpy(&m.saved_rows [rows],  &m.rows[0],  m.rows.size() * sizeof(uint64_t));
+    memcpy(&m.saved_pivot[pivot], &m.pivot[0], m.n_rows * sizeof(int));
+}
+
+
+// Makes the clause of row 'r': 'implied' (if any) first, then the false literals of the other
+// columns.
+CRef Solver::gaussClause(const GaussMatrix& m, int r, Lit implied)
+{
+    const uint64_t* row = m.row(r);
+    gauss_tmp.clear();
+    if (implied != lit_Undef)
+        gauss_tmp.push(implied);
+    for (int k = 0; k < m.words; k++)
+        for (uint64_t bits = row[k]; bits != 0; bits &= bits - 1){
+            int c = k * 64 + __builtin_ctzll(bits);
+            if (c == m.n_cols || (implied != lit_Undef && m.vars[c] == var(implied))) continue;
+            Var v = m.vars[c];
+            gauss_tmp.push(mkLit(v, value(v) == l_True)); }
+
+    CRef cr = ca.alloc(gauss_tmp, false);
+    gauss_reasons.push(cr);
+    gauss_levels .push(decisionLevel());
+    return cr;
+}
+
+
+CRef Solver::gaussPropagate()
+{
+    while (gauss_qhead < trail.size()){
+        Lit p = trail[gauss_qhead++];
+        int mi = gauss_mat[var(p)];
+        if (mi < 0) continue;
+
+        GaussMatrix& m   = *gauss_mats[mi];
+        int          c   = gauss_col[var(p)];
+        uint64_t     bit = (uint64_t)1 << (c & 63);
+        m.assigned[c >> 6] |= bit;
+        if (!sign(p))
+            m.truth[c >> 6] |= bit;
+
+        // Move the pivot off 'c', eliminating the new pivot column from the other rows:
+        int r  = m.pivot_row[c];
+        int c2 = -1;
+        if (r >= 0){
+            gaussSave(m);
+            const uint64_t* row = m.row(r);
+            for (int k = 0; k < m.words && c2 == -1; k++){
+                uint64_t free = row[k] & ~m.assigned[k];
+                if (free != 0)
+                    c2 = k * 64 + __builtin_ctzll(free); }
+            m.pivot_row[c] = -1;
+            m.pivot[r]     = c2;
+            if (c2 >= 0)
+                m.pivot_row[c2] = r;
+        }
+
+        gauss_check.clear();
+        for (int i = 0; i < m.n_rows; i++){
+            uint64_t* row = m.row(i);
+            if (c2 >= 0 && i != r && hasCol(row, c2)){
+                xorRow(row, m.row(r), m.words);
+                gauss_check.push(i);
+            }else if (row[c >> 6] & bit)
+                gauss_check.push(i);
+        }
+
+        for (int k = 0; k < gauss_check.size(); k++){
+            const uint64_t* row = m.row(gauss_check[k]);
+            int  free   = 0;
+            int  col    = -1;
+            bool parity = false;
+            for (int w = 0; w < m.words && free < 2; w++){
+                uint64_t f = row[w] & ~m.assigned[w];
+                if (f != 0){
+                    free += __builtin_popcountll(f);
+                    col   = w * 64 + __builtin_ctzll(f); }
+                parity ^= __builtin_popcountll(row[w] & m.truth[w]) & 1; }
+
+            if (free >= 2)
+                continue;
+            else if (free == 0){
+                if (parity){
+                    gauss_conflicts++;
+                    return gaussClause(m, gauss_check[k], lit_Undef); }
+            }else{
+                Lit q = mkLit(m.vars[col], !parity);
+                if (value(q) == l_False){
+                    gauss_conflicts++;
+                    return gaussClause(m, gauss_check[k], lit_Undef);
+                }else if (value(q) == l_Undef){
+                    gauss_props++;
+                    uncheckedEnqueue(q, decisionLevel() == 0 ? CRef_Undef : gaussClause(m, gauss_check[k], q)); }
+            }
+        }
+    }
+
+    return CRef_Undef;
+}
+
+
+// Undoes the assignments above 'level' in the matrices (before 'cancelUntil()' does on the trail).
+void Solver::gaussBacktrack(int level)
+{
+    int lim = trail_lim[level];
+    for (int i = gauss_qhead - 1; i >= lim; i--){
+        Var v = var(trail[i]);
+        if (gauss_mat[v] < 0) continue;
+        GaussMatrix& m   = *gauss_mats[gauss_mat[v]];
+        uint64_t     bit = (uint64_t)1 << (gauss_col[v] & 63);
+        m.assigned[gauss_col[v] >> 6] &= ~bit;
+        m.truth   [gauss_col[v] >> 6] &= ~bit; }
+    if (gauss_qhead > lim)
+        gauss_qhead = lim;
+
+    for (int mi = 0; mi < gauss_mats.size(); mi++){
+        GaussMatrix& m = *gauss_mats[mi];
+        int s;
+        for (s = 0; s < m.saved_level.size() && m.saved_level[s] <= level; s++);
+        if (s == m.saved_level.size()) continue;
+
+        memcpy(&m.rows[0],  &m.saved_rows [s * m.rows.size()], m.rows.size() * sizeof(uint64_t));
+        memcpy(&m.pivot[0], &m.saved_pivot[s * m.n_rows],      m.n_rows * sizeof(int));
+        for (int c = 0; c < m.n_cols; c++)
+            m.pivot_row[c] = -1;
+        for (int r = 0; r < m.n_rows; r++)
+            if (m.pivot[r] >= 0)
+                m.pivot_row[m.pivot[r]] = r;
+        m.saved_level.shrink(m.saved_level.size() - s);
+        m.saved_rows .shrink(m.saved_rows.size()  - s * m.rows.size());
+        m.saved_pivot.shrink(m.saved_pivot.size() - s * m.n_rows);
+    }
+
+    while (gauss_levels.size() > 0 && gauss_levels.last() > level){
+        ca.free(gauss_reasons.last());
+        gauss_reasons.pop();
+        gauss_levels .pop(); }
+}
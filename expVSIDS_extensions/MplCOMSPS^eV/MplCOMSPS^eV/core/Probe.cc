@@ -0,0 +1,283 @@
+/****************************************************************************************[Probe.cc]
+Failed-literal probing with hyper-binary resolution: an inprocessing pass run at decision level 0
+between restarts, within a share of the propagations of the search.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+**************************************************************************************************/
+
+#include "utils/Options.h"
+#include "core/Solver.h"
+
+using namespace Minisat;
+
+//=================================================================================================
+// Options:
+
+
+static const char* _cat = "PROBE";
+
+static DoubleOption opt_probe_frac (_cat, "probe-frac", "Share of the propagations spent on failed-literal probing (0 = off)", 0.02, DoubleRange(0, true, 1, true));
+static IntOption    opt_probe_min  (_cat, "probe-min",  "Propagations of probing that must be due before a round starts", 20000, IntRange(1, INT32_MAX));
+
+
+//=================================================================================================
+// Probing:
+//
+// A round starts at a restart once the propagations of all earlier rounds fall behind
+// '-probe-frac' of all propagations by '-probe-min', and ends when they catch up. It probes the
+// roots of the binary implication graph (literals with outgoing but no incoming binary clauses),
+// resuming where the previous round stopped. 'probePropagate()' records the dominator of every
+// literal it implies: the literal that implies it over a binary clause, or for a longer reason
+// clause the closest common dominator of the negations of its other literals. Then:
+//
+//   - a conflict makes the negation of the common dominator of the conflicting literals a unit;
+//   - a literal implied by a longer clause gets the hyper-binary resolvent {~dominator, lit} when
+//     the dominator is not the root (a TIER2 learnt clause, so unused ones are dropped again);
+//   - a binary clause from an implied literal back to one of its dominators closes a cycle: both
+//     are equivalent, and the missing direction is added as a binary CORE clause, so that the
+//     cycle is explicit for the substitution of equivalent literals in the simplifier.
+//
+// Every added clause is a RUP consequence of the literals that its dominator implies. The probes
+// use their own enqueue and backtracking, so saved phases and CHB rewards are left alone.
+
+
+inline void Solver::probeEnqueue(Lit p, CRef from, Lit dom)
+{
+    assigns[var(p)] = lbool(!sign(p));
+    vardata[var(p)] = mkVarData(from, decisionLevel());
+    probe_dom  [var(p)] = dom;
+    probe_depth[var(p)] = dom == lit_Undef ? 0 : probe_depth[var(dom)] + 1;
+    trail.push_(p);
+}
+
+
+// Closest common dominator of two literals implied by the current probe.
+Lit Solver::probeDominator(Lit a, Lit b) const
+{
+    while (probe_depth[var(a)] > probe_depth[var(b)]) a = probe_dom[var(a)];
+    while (probe_depth[var(b)] > probe_depth[var(a)]) b = probe_dom[var(b)];
+    while (a != b) a = probe_dom[var(a)], b = probe_dom[var(b)];
+    return a;
+}
+
+
+// As 'propagate()', recording dominators on the way, and the hyper-binary resolvents and
+// equivalences to add (as pairs a, b standing for the clause {~a, b}) in 'probe_hbr' and
+// 'probe_eqv'.
+CRef Solver::probePropagate()
+{
+    CRef    confl     = CRef_Undef;
+    int     num_props = 0;
+
+    while (qhead < trail.size()){
+        Lit            p   = trail[qhead++];
+        vec<Watcher>&  ws  = watches[p];
+        Watcher        *i, *j, *end;
+        num_props++;
+
+        vec<Watcher>& ws_bin = watches_bin[p];
+        for (int k = 0; k < ws_bin.size(); k++){
+            Lit the_other = ws_bin[k].blocker;
+            if (value(the_other) == l_False){
+                confl = ws_bin[k].cref;
+                qhead = trail.size();
+                goto ExitProp;
+            }else if (value(the_other) == l_Undef)
+                probeEnqueue(the_other, ws_bin[k].cref, p);
+            else if (level(var(the_other)) > 0 && probe_depth[var(the_other)] < probe_depth[var(p)]
+                     && probeDominator(the_other, p) == the_other){
+                // 'the_other' implies 'p' and 'p' implies 'the_other':
+                CRef r = reason(var(p));
+                if (probe_dom[var(p)] != the_other || r == CRef_Undef || ca[r].size() != 2){
+                    probe_eqv.push(the_other); probe_eqv.push(p); }
+            }
+        }
+
+        for (i = j = (Watcher*)ws, end = i + ws.size();  i != end;){
+            Lit blocker = i->blocker;
+            if (value(blocker) == l_True){
+                *j++ = *i++; continue; }
+
+            CRef     cr        = i->cref;
+            Clause&  c         = ca[cr];
+            Lit      false_lit = ~p;
+            if (c[0] == false_lit)
+                c[0] = c[1], c[1] = false_lit;
+            assert(c[1] == false_lit);
+            i++;
+
+            Lit     first = c[0];
+            Watcher w     = Watcher(cr, first);
+            if (first != blocker && value(first) == l_True){
+                *j++ = w; continue; }
+
+            for (int k = 2; k < c.size(); k++)
+                if (value(c[k]) != l_False){
+                    c[1] = c[k]; c[k] = false_lit;
+                    watches[~c[1]].push(w);
+                    goto NextClause; }
+
+            *j++ = w;
+            if (value(first) == l_False){
+                confl = cr;
+                qhead = trail.size();
+                while (i < end)
+                    *j++ = *i++;
+            }else{
+                Lit root = trail[trail_lim[0]];
+                Lit dom  = lit_Undef;
+                for (int k = 1; k < c.size(); k++)
+                    if (level(var(c[k])) > 0)
+                        dom = dom == lit_Undef ? ~c[k] : probeDominator(dom, ~c[k]);
+                if (dom == lit_Undef) dom = root;
+                probeEnqueue(first, cr, dom);
+                if (dom != root){
+                    probe_hbr.push(dom); probe_hbr.push(first); }
+            }
+
+        NextClause:;
+        }
+        ws.shrink(i - j);
+    }
+
+ExitProp:;
+    propagations += num_props;
+    probe_props  += num_props;
+    simpDB_props -= num_props;
+
+    return confl;
+}
+
+
+// Undoes the probe without touching the saved phases or the CHB statistics.
+void Solver::probeBacktrack()
+{
+    for (int c = trail.size()-1; c >= trail_lim[0]; c--){
+        assigns[var(trail[c])] = l_Undef;
+        insertVarOrder(var(trail[c])); }
+    qhead = trail_lim[0];
+    trail.shrink(trail.size() - trail_lim[0]);
+    trail_lim.clear();
+}
+
+
+// Adds the clause {~a, b} at level 0 (a learnt clause of the tier 'mark' if it is binary then).
+bool Solver::probeAdd(Lit a, Lit b, unsigned mark)
+{
+    add_tmp.clear();
+    add_tmp.push(~a);
+    if (b != lit_Undef) add_tmp.push(b);
+
+    for (int i = 0; i < add_tmp.size(); i++)
+        if (value(add_tmp[i]) == l_True) return true;
+
+    if (drup_file){
+#ifdef BIN_DRUP
+        binDRUP('a', add_tmp, drup_file);
+#else
+        for (int i = 0; i < add_tmp.size(); i++)
+            fprintf(drup_file, "%i ", (var(add_tmp[i]) + 1) * (-2 * sign(add_tmp[i]) + 1));
+        fprintf(drup_file, "0\n");
+#endif
+    }
+
+    int i, j;
+    for (i = j = 0; i < add_tmp.size(); i++)
+        if (value(add_tmp[i]) != l_False)
+            add_tmp[j++] = add_tmp[i];
+    add_tmp.shrink(i - j);
+
+    if (add_tmp.size() == 0)
+        return false;
+    else if (add_tmp.size() == 1)
+        uncheckedEnqueue(add_tmp[0]);
+    else{
+        CRef cr = ca.alloc(add_tmp, true);
+        ca[cr].set_lbd(2);
+        ca[cr].mark(mark);
+        if (mark == TIER2){
+            learnts_tier2.push(cr);
+            ca[cr].touched() = conflicts;
+        }else
+            learnts_core.push(cr);
+        attachClause(cr); }
+
+    return true;
+}
+
+
+bool Solver::probeDue() const
+{
+    return opt_probe_frac > 0 && propagations * opt_probe_frac >= probe_props + opt_probe_min;
+}
+
+
+bool Solver::probe()
+{
+    assert(decisionLevel() == 0);
+    if (!ok || propagate() != CRef_Undef)
+        return ok = false;
+
+    probe_rounds++;
+    probe_dom  .growTo(nVars());
+    probe_depth.growTo(nVars());
+    watches_bin.cleanAll();
+    watches    .cleanAll();
+
+    int n = 2 * nVars();
+    if (probe_next >= n) probe_next = 0;
+
+    int k;
+    for (k = 0; k < n && propagations * opt_probe_frac > probe_props && !asynch_interrupt; k++){
+        Lit p = toLit(probe_next);
+        probe_next = probe_next + 1 < n ? probe_next + 1 : 0;
+        if (value(p) != l_Undef || !decision[var(p)] || watches_bin[p].size() == 0 || watches_bin[~p].size() > 0)
+            continue;
+
+        probed++;
+        probe_hbr.clear();
+        probe_eqv.clear();
+        newDecisionLevel();
+        probeEnqueue(p, CRef_Undef, lit_Undef);
+        CRef confl = probePropagate();
+
+        Lit failed = lit_Undef;
+        if (confl != CRef_Undef){
+            const Clause& c = ca[confl];
+            for (int i = 0; i < c.size(); i++)
+                if (level(var(c[i])) > 0)
+                    failed = failed == lit_Undef ? ~c[i] : probeDominator(failed, ~c[i]);
+            failed_lits++; }
+        probeBacktrack();
+
+        if (failed != lit_Undef && !probeAdd(failed, lit_Undef, CORE))
+            return ok = false;
+        for (int i = 0; i < probe_hbr.size(); i += 2, hyper_binaries++)
+            if (!probeAdd(probe_hbr[i], probe_hbr[i+1], TIER2))
+                return ok = false;
+        for (int i = 0; i < probe_eqv.size(); i += 2, probe_equivs++)
+            if (!probeAdd(probe_eqv[i], probe_eqv[i+1], CORE))
+                return ok = false;
+        if (propagate() != CRef_Undef)
+            return ok = false;
+    }
+
+    // After a whole sweep, wait until the budget has grown by '-probe-min' again:
+    if (k == n && propagations * opt_probe_frac > probe_props)
+        probe_props = (uint64_t)(propagations * opt_probe_frac);
+
+    return true;
+}
@@ -21,8 +21,6 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 **************************************************************************************************/
 
 #include <math.h>
-#include <signal.h>
-#include <unistd.h>
 
 #include "mtl/Sort.h"
 #include "core/Solver.h"
@@ -54,6 +52,9 @@ static BoolOption    opt_rnd_init_act      (_cat, "rnd-init",    "Randomize the
 static IntOption     opt_restart_first     (_cat, "rfirst",      "The base restart interval", 100, IntRange(1, INT32_MAX));
 static DoubleOption  opt_restart_inc       (_cat, "rinc",        "Restart interval increase factor", 2, DoubleRange(1, false, HUGE_VAL, false));
 static DoubleOption  opt_garbage_frac      (_cat, "gc-frac",     "The fraction of wasted memory allowed before a garbage collection is triggered",  0.20, DoubleRange(0, false, HUGE_VAL, false));
+static DoubleOption  opt_switch_time       (_cat, "switch-time", "CPU seconds of CHB search before switching to VSIDS", 2500, DoubleRange(0, true, HUGE_VAL, false));
+static BoolOption    opt_explore_aux       (_cat, "explore-aux", "Let exploration steps start from auxiliary variables (e.g. those of bounded variable addition)", false);
+static BoolOption    opt_reuse_trail       (_cat, "reuse-trail", "Restart only to the first level whose decision ranks below the top of the order heap", false);
 
 
 //=================================================================================================
@@ -91,11 +92,35 @@ Solver::Solver() :
     //
   , learntsize_adjust_start_confl (100)
   , learntsize_adjust_inc         (1.5)
+  , switch_time                   (opt_switch_time)
+  , explore_aux                   (opt_explore_aux)
+  , reuse_trail                   (opt_reuse_trail)
+
+    // Incremental interface hooks:
+    //
+  , term_state         (NULL)
+  , term_callback      (NULL)
+  , learn_state        (NULL)
+  , learn_callback     (NULL)
+  , learn_max_size     (0)
+  , learn_max_lbd      (INT32_MAX)
+  , import_state       (NULL)
+  , import_callback    (NULL)
+
+    // Checkpointing:
+    //
+  , checkpoint_file      (NULL)
+  , checkpoint_interval  (0)
+  , checkpoint_requested (0)
 
     // Statistics: (formerly in 'SolverStats')
     //
   , solves(0), starts(0), decisions(0), rnd_decisions(0), propagations(0), conflicts(0), conflicts_VSIDS(0)
   , dec_vars(0), clauses_literals(0), learnts_literals(0), max_literals(0), tot_literals(0)
+  , probe_rounds(0), probed(0), failed_lits(0), hyper_binaries(0), probe_equivs(0), probe_props(0)
+  , gauss_rows(0), gauss_props(0), gauss_conflicts(0)
+  , vivify_rounds(0), vivified(0), vivify_shortened(0), vivify_lits(0), vivify_props(0)
+  , reused_restarts(0), reused_levels(0), reused_props(0)
 
   , ok                 (true)
   , cla_inc            (1)
@@ -136,6 +161,15 @@ Solver::Solver() :
   , lbd_queue          (50)
   , next_T2_reduce     (10000)
   , next_L_reduce      (15000)
+  , vsids_warmup       (10000)
+  , switch_deadline    (-1)
+  , next_checkpoint    (0)
+  , checkpoint_child   (-1)
+  , probe_next         (0)
+  , vivify_split       (0)
+  , vivify_job         (NULL)
+  , gauss_dirty        (false)
+  , gauss_qhead        (0)
   , counter            (0)
 
     // Resource constraints:
@@ -148,6 +182,9 @@ Solver::Solver() :
 
 Solver::~Solver()
 {
+    vivifyStop();
+    for (int i = 0; i < gauss_mats.size(); i++)
+        delete gauss_mats[i];
 }
 
 
@@ -181,6 +218,9 @@ Var Solver::newVar(bool sign, bool dvar)
     seen2    .push(0);
     polarity .push(sign);
     decision .push();
+    auxiliary.push(0);
+    gauss_mat.push(-1);
+    gauss_col.push(-1);
     trail    .capacity(v+1);
     setDecisionVar(v, dvar);
     return v;
@@ -304,6 +344,7 @@ bool Solver::satisfied(const Clause& c) const {
 //
 void Solver::cancelUntil(int level) {
     if (decisionLevel() > level){
+        if (gauss_mats.size() > 0) gaussBacktrack(level);
         for (int c = trail.size()-1; c >= trail_lim[level]; c--){
             Var      x  = var(trail[c]);
 
@@ -435,7 +476,8 @@ void Solver::analyze(CRef confl, vec<Lit>& out_learnt, int& out_btlevel, int& ou
             else if (c.mark() == LOCAL){
                 if(exploring==false)  { claBumpActivity(c);}
             }
-        }
+        }else if (!c.learnt() && !c.used())
+            c.used(true);   // (vivification tries these problem clauses first)
 
         for (int j = (p == lit_Undef) ? 0 : 1; j < c.size(); j++){
             Lit q = c[j];
@@ -897,6 +939,57 @@ bool Solver::simplify()
 }
 
 
+/*_________________________________________________________________________________________________
+|
+|  importClauses : [void]  ->  [bool]
+|  
+|  Description:
+|    Adds the clauses handed over by 'import_callback' (if any) as problem clauses. Must be called
+|    at decision level 0. Returns FALSE if an imported clause made the formula unsatisfiable.
+|________________________________________________________________________________________________@*/
+bool Solver::importClauses()
+{
+    if (import_callback == NULL) return true;
+    assert(decisionLevel() == 0);
+
+    for (;;){
+        add_tmp.clear();
+        if (!import_callback(import_state, add_tmp)) break;
+        if (!addClause_(add_tmp)) return false;
+    }
+    return true;
+}
+
+
+// Partial restarts: a full restart would decide the variables above the top of the order heap again
+// (phase saving repeats their values), so the levels whose decisions rank above it are kept, as are
+// the levels of the assumptions. Work that needs level 0 makes it a full restart; imported clauses
+// wait for one.
+int Solver::reuseTrailLevel()
+{
+    if (!reuse_trail || probeDue() || vivifyReady() || gauss_dirty || inprocessDue())
+        return 0;
+
+    Heap<VarOrderLt>&  order_heap = VSIDS ? order_heap_VSIDS : order_heap_CHB;
+    const vec<double>& activity   = VSIDS ? activity_VSIDS   : activity_CHB;
+    while (!order_heap.empty() && (value(order_heap[0]) != l_Undef || !decision[order_heap[0]]))
+        order_heap.removeMin();
+    if (order_heap.empty())
+        return 0;
+
+    double top   = activity[order_heap[0]];
+    int    level = assumptions.size() < decisionLevel() ? assumptions.size() : decisionLevel();
+    while (level < decisionLevel() && activity[var(trail[trail_lim[level]])] > top)
+        level++;
+
+    if (level > 0){
+        reused_restarts++;
+        reused_levels += level;
+        reused_props  += (level < decisionLevel() ? trail_lim[level] : trail.size()) - trail_lim[0]; }
+    return level;
+}
+
+
 /*_________________________________________________________________________________________________
 |
 |  search : (nof_conflicts : int) (params : const SearchParams&)  ->  [lbool]
@@ -918,8 +1011,26 @@ lbool Solver::search(int& nof_conflicts)
     bool        cached = false;
     starts++;
 
+    if (decisionLevel() == 0 && !importClauses())
+        return l_False;
+
+    if (decisionLevel() == 0 && probeDue() && !probe())
+        return l_False;
+
+    if (decisionLevel() == 0 && (vivify_job != NULL || vivifyDue()) && !vivify())
+        return l_False;
+
+    if (decisionLevel() == 0 && !inprocess())
+        return l_False;
+
+    if (decisionLevel() == 0 && gauss_dirty && !gaussBuild())
+        return l_False;
+
     for (;;){
         CRef confl = propagate();
+        while (confl == CRef_Undef && gauss_mats.size() > 0 && gauss_qhead < trail.size())
+            if ((confl = gaussPropagate()) == CRef_Undef)
+                confl = propagate();
 
         if (confl != CRef_Undef){
             lastDecisionHadConflicts=true;
@@ -975,6 +1086,9 @@ lbool Solver::search(int& nof_conflicts)
                 fprintf(drup_file, "0\n");
 #endif
             }
+            if (learn_callback != NULL && learnt_clause.size() <= learn_max_size &&
+                (learnt_clause.size() == 1 || lbd <= learn_max_lbd))
+                learn_callback(learn_state, learnt_clause);
 
             if (VSIDS) varDecayActivity();
             claDecayActivity();
@@ -1000,12 +1114,12 @@ lbool Solver::search(int& nof_conflicts)
                 restart = lbd_queue.full() && (lbd_queue.avg() * 0.8 > global_lbd_sum / conflicts_VSIDS);
                 cached = true;
             }
-            if (restart /*|| !withinBudget()*/){
+            if (restart || !withinBudget()){
                 lbd_queue.clear();
                 cached = false;
                 // Reached bound on number of conflicts:
                 progress_estimate = progressEstimate();
-                cancelUntil(0);
+                cancelUntil(restart && withinBudget() ? reuseTrailLevel() : 0);
                 return l_Undef; }
 
             // Simplify the set of problem clauses:
@@ -1020,7 +1134,7 @@ lbool Solver::search(int& nof_conflicts)
                 reduceDB(); }
 
             Lit next = lit_Undef;
-            /*while (decisionLevel() < assumptions.size()){
+            while (decisionLevel() < assumptions.size()){
                 // Perform user provided assumption:
                 Lit p = assumptions[decisionLevel()];
                 if (value(p) == l_True){
@@ -1035,7 +1149,7 @@ lbool Solver::search(int& nof_conflicts)
                 }
             }
 
-            if (next == lit_Undef)*/{
+            if (next == lit_Undef){
                 // New variable decision:
                 if(phase1Done==true){
                     phase2Decisions++;
@@ -1106,15 +1220,9 @@ static double luby(double y, int x){
     return pow(y, seq);
 }
 
-static bool switch_mode = false;
-static void SIGALRM_switch(int signum) { switch_mode = true; }
-
 // NOTE: assumptions passed in member-variable 'assumptions'.
 lbool Solver::solve_()
 {
-    signal(SIGALRM, SIGALRM_switch);
-    alarm(2500);
-
     model.clear();
     conflict.clear();
     if (!ok) return l_False;
@@ -1135,16 +1243,28 @@ lbool Solver::solve_()
 
     add_tmp.clear();
     initExpParameters();
-    
-    VSIDS = true;
-    int init = 10000;
-    while (status == l_Undef && init > 0 /*&& withinBudget()*/)
-       status = search(init);
-    VSIDS = false;
+
+    // The CHB phase is timed from the first call only, so that repeated incremental calls keep
+    // the mode (and the exploration statistics) reached so far instead of starting over.
+    if (switch_deadline < 0)
+        switch_deadline = cpuTime() + switch_time;
+    if (next_checkpoint == 0)
+        next_checkpoint = conflicts + checkpoint_interval;
+
+    if (!phase1Done){
+        VSIDS = true;
+        while (status == l_Undef && vsids_warmup > 0 && withinBudget()){
+            status = search(vsids_warmup);
+            if (status == l_Undef && checkpointDue()){ cancelUntil(0); checkpoint(); }
+        }
+        // Each mode refills its own order heap when backtracking:
+        if (status == l_Undef) cancelUntil(0);
+        VSIDS = false;
+    }
 
     // Search:
     int curr_restarts = 0;
-    while (status == l_Undef /*&& withinBudget()*/){
+    while (status == l_Undef && withinBudget()){
         if (VSIDS){
             int weighted = INT32_MAX;
             status = search(weighted);
@@ -1153,7 +1273,9 @@ lbool Solver::solve_()
             curr_restarts++;
             status = search(nof_conflicts);
         }
-        if (!VSIDS && switch_mode){
+        if (status == l_Undef && checkpointDue()){ cancelUntil(0); checkpoint(); }
+        if (status == l_Undef && !VSIDS && cpuTime() >= switch_deadline){
+            cancelUntil(0);
             phase1Done=true;
             VSIDS = true;
             //printf("c Switched to VSIDS.\n");
@@ -1181,7 +1303,10 @@ lbool Solver::solve_()
     }else if (status == l_False && conflict.size() == 0)
         ok = false;
 
+    // Backtracking only refills the order heap of the current mode, but the next call may start
+    // in the other one (e.g. a call that ended during the VSIDS warm-up):
     cancelUntil(0);
+    rebuildOrderHeap();
     return status;
 }
 
@@ -1294,6 +1419,11 @@ void Solver::relocAll(ClauseAllocator& to)
             ca.reloc(vardata[v].reason, to);
     }
 
+    // Clauses made from the rows of the XOR matrices:
+    //
+    for (int i = 0; i < gauss_reasons.size(); i++)
+        ca.reloc(gauss_reasons[i], to);
+
     // All learnt:
     //
     for (int i = 0; i < learnts_core.size(); i++)
@@ -1311,6 +1441,15 @@ void Solver::relocAll(ClauseAllocator& to)
             ca.reloc(clauses[i], to);
             clauses[j++] = clauses[i]; }
     clauses.shrink(i - j);
+
+    // Clauses of the round of vivification on the helper thread (deleted ones are dropped):
+    //
+    for (i = 0; i < vivify_cands.size(); i++)
+        if (vivify_cands[i] != CRef_Undef){
+            if (!ca[vivify_cands[i]].reloced() && ca[vivify_cands[i]].mark() == 1)
+                vivify_cands[i] = CRef_Undef;
+            else
+                ca.reloc(vivify_cands[i], to); }
 }
 
 
@@ -1411,13 +1550,13 @@ void Solver::explore(){
     
 }
 
-//performs a random step selection 
+//performs a random step selection (an auxiliary variable counts as a missed step, unless 'explore_aux')
 CRef Solver::performStep(bool &flag, Var& next_var){
     CRef confl;
     if (!order_heap_VSIDS.empty()) {
         next_var = order_heap_VSIDS[irand(random_seed, order_heap_VSIDS.size())];
         Lit next = mkLit(next_var, polarity[next_var]);
-        if(value(next)==l_Undef){
+        if(value(next)==l_Undef && (explore_aux || !auxiliary[next_var])){
            newDecisionLevel();
            uncheckedEnqueue(next);
            confl = propagate();
@@ -43,6 +43,9 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 #include "utils/System.h"
 
 
+#include <signal.h>
+#include <sys/types.h>
+
 #include<map>
 #include<iostream>
 using namespace std;
@@ -56,6 +59,9 @@ using namespace std;
 
 namespace Minisat {
 
+struct CheckpointIO;
+struct VivifyJob;
+
 //=================================================================================================
 // Solver -- the main class:
 
@@ -103,6 +109,7 @@ public:
     bool    addClause (Lit p, Lit q, Lit r);                    // Add a ternary clause to the solver. 
     bool    addClause_(      vec<Lit>& ps);                     // Add a clause to the solver without making superflous internal copy. Will
                                                                 // change the passed vector 'ps'.
+    void    addXor    (const vec<Var>& vs, bool rhs);           // Declare that the clauses imply vs[0] ^ ... ^ vs[n-1] = rhs (see 'Gauss.cc').
 
     // Solving:
     //
@@ -129,6 +136,8 @@ public:
     // 
     void    setPolarity    (Var v, bool b); // Declare which polarity the decision heuristic should use for a variable. Requires mode 'polarity_user'.
     void    setDecisionVar (Var v, bool b); // Declare if a variable should be eligible for selection in the decision heuristic.
+    void    setAuxiliary   (Var v, bool b); // Declare a variable as introduced by the solver (see 'explore_aux'); it is left out of models.
+    bool    isAuxiliary    (Var v) const;
 
     // Read state:
     //
@@ -155,6 +164,18 @@ public:
     virtual void garbageCollect();
     void    checkGarbage(double gf);
     void    checkGarbage();
+    void    recycleArena(Solver& from); // Reuse the clause arena of 'from', which must not be used afterwards.
+
+    // Checkpointing:
+    //
+    bool    writeCheckpoint(const char* file);  // Write the search state to 'file'. Only valid at decision level 0.
+    bool    readCheckpoint (const char* file);  // Restore a state written for the same (preprocessed) problem.
+
+    // Cube and conquer (see 'Cube.cc'):
+    //
+    lbool   cube         (vec<Lit>& out_cubes);         // Split the problem into cubes, each ended by 'lit_Undef'. l_Undef unless solved on the way. Only valid at decision level 0.
+    lbool   conquer      (const vec<Lit>& cubes);       // Solve the cubes on '-conquer-threads' threads: l_True (with 'model') or l_False.
+    void    copyProblemTo(Solver& to) const;            // Copy the variables, root-level units and problem (and core learnt) clauses into the empty solver 'to'.
 
     // Extra results: (read-only member variable)
     //
@@ -189,10 +210,35 @@ public:
     int       learntsize_adjust_start_confl;
     double    learntsize_adjust_inc;
 
+    double    switch_time;        // CPU seconds of CHB search before switching to VSIDS for good.                           (default 2500)
+    bool      explore_aux;        // Let exploration steps start from auxiliary variables.                                    (default false)
+    bool      reuse_trail;        // Restarts keep the levels whose decisions rank above the top of the order heap.          (default false)
+
+    // Incremental interface hooks (used by the IPASIR wrapper and the portfolio driver):
+    //
+    void*     term_state;
+    int     (*term_callback)(void* state);                  // Polled by 'withinBudget()'; non-zero stops the search.
+    void*     learn_state;
+    void    (*learn_callback)(void* state, const vec<Lit>& c); // Receives each learnt clause of size <= 'learn_max_size'.
+    int       learn_max_size;
+    int       learn_max_lbd;      // Non-unit learnt clauses are only passed on if their stored LBD is at most this.         (default INT32_MAX)
+    void*     import_state;
+    bool    (*import_callback)(void* state, vec<Lit>& c);   // Polled at level 0 by 'search()'; fills 'c' and returns true while clauses are pending.
+
+    // Checkpointing (see 'Checkpoint.cc'):
+    //
+    const char* checkpoint_file;                // Written by 'solve_()' at restarts; NULL disables checkpoints.
+    uint64_t    checkpoint_interval;            // Conflicts between periodic checkpoints (0 = only on request).
+    volatile sig_atomic_t checkpoint_requested; // Set (e.g. from a signal handler) to checkpoint at the next restart.
+
     // Statistics: (read-only member variable)
     //
     uint64_t solves, starts, decisions, rnd_decisions, propagations, conflicts, conflicts_VSIDS;
     uint64_t dec_vars, clauses_literals, learnts_literals, max_literals, tot_literals;
+    uint64_t probe_rounds, probed, failed_lits, hyper_binaries, probe_equivs, probe_props;
+    uint64_t gauss_rows, gauss_props, gauss_conflicts;
+    uint64_t vivify_rounds, vivified, vivify_shortened, vivify_lits, vivify_props;
+    uint64_t reused_restarts, reused_levels, reused_props;
 
     vec<uint32_t> picked;
     vec<uint32_t> conflicted;
@@ -249,6 +295,21 @@ protected:
         VarOrderLt(const vec<double>&  act) : activity(act) { }
     };
 
+    struct GaussMatrix {
+        int           n_rows, n_cols, words;   // Column 'n_cols' holds the right-hand sides.
+        vec<uint64_t> rows;                    // 'n_rows' rows of 'words' words each.
+        vec<Var>      vars;                    // The variable of each column.
+        vec<int>      pivot;                   // The pivot column of each row (-1 if none),
+        vec<int>      pivot_row;               // and the row of each pivot column (-1 if none).
+        vec<uint64_t> assigned, truth;         // Columns assigned (and true) on the trail up to 'gauss_qhead'.
+        vec<int>      saved_level;             // Decision levels that changed the rows,
+        vec<uint64_t> saved_rows;              // and the rows and pivots before the first change.
+        vec<int>      saved_pivot;
+        GaussMatrix() : n_rows(0), n_cols(0), words(0) { }
+        uint64_t*       row(int r)       { return &rows[r * words]; }
+        const uint64_t* row(int r) const { return &rows[r * words]; }
+    };
+
     // Solver state:
     //
     bool                ok;               // If FALSE, the constraints are already unsatisfiable. No part of the solver state may be used!
@@ -266,6 +327,7 @@ protected:
     vec<lbool>          assigns;          // The current assignments.
     vec<char>           polarity;         // The preferred polarity of each variable.
     vec<char>           decision;         // Declares if a variable is eligible for selection in the decision heuristic.
+    vec<char>           auxiliary;        // Declares if a variable was introduced by the solver rather than the user.
     vec<Lit>            trail;            // Assignment stack; stores all assigments made in the order they were made.
     vec<int>            trail_lim;        // Separator indices for different decision levels in 'trail'.
     vec<VarData>        vardata;          // Stores reason and level for each variable.
@@ -285,6 +347,35 @@ protected:
     uint64_t            next_T2_reduce,
                         next_L_reduce;
 
+    int                 vsids_warmup;     // Remaining conflicts of the initial VSIDS phase (spent over all calls to 'solve_()').
+    double              switch_deadline;  // CPU time at which the CHB phase ends; set by the first call to 'solve_()'.
+
+    uint64_t            next_checkpoint;  // Conflict count at which the next periodic checkpoint is due.
+    pid_t               checkpoint_child; // Process still writing the previous checkpoint, or -1.
+
+    vec<Lit>            probe_dom;        // Dominator of each literal implied by the current probe (see 'Probe.cc').
+    vec<int>            probe_depth;      // Its depth in the tree of dominators, 0 for the probed root.
+    vec<Lit>            probe_hbr;        // Hyper-binary resolvents found by the current probe.
+    vec<Lit>            probe_eqv;        // Binary clauses closing the cycles of equivalent literals it found.
+    int                 probe_next;       // Literal at which the next round of probing resumes.
+
+    vec<CRef>           vivify_cands;     // Clauses of the current round of vivification (see 'Vivify.cc'),
+    int                 vivify_split;     // the TIER2 ones before this index, the problem clauses after it.
+    VivifyJob*          vivify_job;       // Round running on the helper thread, or NULL.
+    vec<Lit>            vivify_tmp;
+
+    vec<Var>            xors;             // XOR constraints implied by the clauses (see 'Gauss.cc'), each ended by 'var_Undef',
+    vec<char>           xor_rhs;          // and their right-hand sides.
+    bool                gauss_dirty;      // 'xors' changed since the matrices were built.
+    vec<GaussMatrix*>   gauss_mats;       // One matrix per connected component of the XOR constraints (owned).
+    vec<int>            gauss_mat;        // Matrix of each variable (-1 if none),
+    vec<int>            gauss_col;        // and its column there.
+    int                 gauss_qhead;      // Head of the trail as processed by the matrices.
+    vec<CRef>           gauss_reasons;    // Clauses made from rows (reasons and conflicts), freed on backtracking,
+    vec<int>            gauss_levels;     // and the decision levels they were made at.
+    vec<int>            gauss_check;      // Rows to check for propagation (temporary).
+    vec<Lit>            gauss_tmp;
+
     ClauseAllocator     ca;
 
     // Temporaries (to reduce allocation overhead). Each variable is prefixed by the method in which it is
@@ -354,6 +445,10 @@ protected:
     void     analyzeFinal     (Lit p, vec<Lit>& out_conflict);                         // COULD THIS BE IMPLEMENTED BY THE ORDINARIY "analyze" BY SOME REASONABLE GENERALIZATION?
     bool     litRedundant     (Lit p, uint32_t abstract_levels);                       // (helper method for 'analyze()')
     lbool    search           (int& nof_conflicts);                                    // Search for a given number of conflicts.
+    int      reuseTrailLevel  ();                                                      // The level a restart backtracks to (see 'reuse_trail').
+    bool     importClauses    ();                                                      // Add the clauses offered by 'import_callback'.
+    virtual bool inprocess    () { return true; }                                      // Simplify between restarts at level 0 (see 'SimpSolver'). FALSE if unsatisfiable.
+    virtual bool inprocessDue () const { return false; }                               // A round of 'inprocess()' would run.
     lbool    solve_           ();                                                      // Main solve method (assumptions given in 'assumptions').
     void     reduceDB         ();                                                      // Reduce the set of learnt clauses.
     void     reduceDB_Tier2   ();
@@ -361,6 +456,36 @@ protected:
     void     safeRemoveSatisfied(vec<CRef>& cs, unsigned valid_mark);
     void     rebuildOrderHeap ();
     bool     binResMinimize   (vec<Lit>& out_learnt);                                  // Further learnt clause minimization by binary resolution.
+    void     checkpoint       ();                                                      // Write a checkpoint from a forked child process.
+    void     transferState    (CheckpointIO& io);                                      // (helper method for reading and writing checkpoints)
+    bool     probeDue         () const;                                                // A round of probing is due (see 'Probe.cc').
+    bool     probe            ();                                                      // Probe the roots of the binary implication graph at level 0.
+    void     probeEnqueue     (Lit p, CRef from, Lit dom);                             // (helper methods for 'probe()')
+    Lit      probeDominator   (Lit a, Lit b) const;
+    CRef     probePropagate   ();
+    void     probeBacktrack   ();
+    bool     probeAdd         (Lit a, Lit b, unsigned mark);
+    bool     vivifyDue        () const;                                                // A round of vivification is due (see 'Vivify.cc').
+    bool     vivifyReady      () const;                                                // A round is due, or the one of the helper thread can be committed.
+    bool     vivify           ();                                                      // Vivify problem and TIER2 clauses at level 0. FALSE if unsatisfiable.
+    void     vivifyCandidates ();                                                      // (helper methods for 'vivify()')
+    bool     vivifyLits       (vec<Lit>& lits);
+    void     vivifyEnqueue    (Lit p, CRef from);
+    CRef     vivifyPropagate  ();
+    void     vivifyBacktrack  ();
+    bool     vivifyReplace    (CRef cr, const vec<Lit>& lits);
+    bool     vivifyCommit     ();
+    void     vivifyStop       ();
+    void     vivifyWait       ();
+    static void* vivifyThread (void* job);
+    bool     gaussBuild       ();                                                      // Build the matrices at level 0 (see 'Gauss.cc'). FALSE if the XORs are inconsistent.
+    CRef     gaussPropagate   ();                                                      // Propagate the trail through the matrices. Returns possibly conflicting clause.
+    void     gaussBacktrack   (int level);                                             // (helper methods for 'gaussPropagate()' and 'cancelUntil()')
+    void     gaussSave        (GaussMatrix& m);
+    CRef     gaussClause      (const GaussMatrix& m, int r, Lit implied);
+    int      lookahead        (Lit p);                                                 // (helper methods for 'cube()')
+    Var      splitVariable    (vec<Lit>& path, vec<double>& score, bool& refuted);
+    void     cubeNode         (int depth, vec<Lit>& path, vec<Lit>& out, int& n_out, vec<double>& score, int& refuted);
 
     // Maintaining Variable/Clause activity:
     //
@@ -387,6 +512,7 @@ protected:
     int      level            (Var x) const;
     double   progressEstimate ()      const; // DELETE THIS ?? IT'S NOT VERY USEFUL ...
     bool     withinBudget     ()      const;
+    bool     checkpointDue    ()      const; // A checkpoint was requested or the periodic one is due.
 
     template<class V> int computeLBD(const V& c) {
         int lbd = 0;
@@ -492,6 +618,7 @@ inline void Solver::claBumpActivity (Clause& c) {
                 ca[learnts_local[i]].activity() *= 1e-20;
             cla_inc *= 1e-20; } }
 
+inline void Solver::recycleArena(Solver& from) { ca.recycle(from.ca); }
 inline void Solver::checkGarbage(void){ return checkGarbage(garbage_frac); }
 inline void Solver::checkGarbage(double gf){
     if (ca.wasted() > ca.size() * gf)
@@ -532,16 +659,22 @@ inline void     Solver::setDecisionVar(Var v, bool b)
         order_heap_CHB.insert(v);
         order_heap_VSIDS.insert(v); }
 }
+inline void     Solver::setAuxiliary  (Var v, bool b) { auxiliary[v] = b; }
+inline bool     Solver::isAuxiliary   (Var v) const   { return auxiliary[v]; }
 inline void     Solver::setConfBudget(int64_t x){ conflict_budget    = conflicts    + x; }
 inline void     Solver::setPropBudget(int64_t x){ propagation_budget = propagations + x; }
 inline void     Solver::interrupt(){ asynch_interrupt = true; }
 inline void     Solver::clearInterrupt(){ asynch_interrupt = false; }
 inline void     Solver::budgetOff(){ conflict_budget = propagation_budget = -1; }
 inline bool     Solver::withinBudget() const {
-    return !asynch_interrupt &&
+    return !asynch_interrupt && (term_callback == NULL || !term_callback(term_state)) &&
            (conflict_budget    < 0 || conflicts < (uint64_t)conflict_budget) &&
            (propagation_budget < 0 || propagations < (uint64_t)propagation_budget); }
 
+inline bool     Solver::checkpointDue() const {
+    return checkpoint_file != NULL &&
+           (checkpoint_requested || (checkpoint_interval > 0 && conflicts >= next_checkpoint)); }
+
 // FIXME: after the introduction of asynchronous interrruptions the solve-versions that return a
 // pure bool do not give a safe interface. Either interrupts must be possible to turn off here, or
 // all calls to solve must return an 'lbool'. I'm not yet sure which I prefer.
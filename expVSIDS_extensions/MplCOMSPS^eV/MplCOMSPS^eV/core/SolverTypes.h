@@ -25,12 +25,16 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 #define Minisat_SolverTypes_h
 
 #include <assert.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 
 #include "mtl/IntTypes.h"
 #include "mtl/Alg.h"
 #include "mtl/Vec.h"
 #include "mtl/Map.h"
 #include "mtl/Alloc.h"
+#include "mtl/Sort.h"
 
 namespace Minisat {
 
@@ -128,8 +132,10 @@ class Clause {
         unsigned learnt    : 1;
         unsigned has_extra : 1;
         unsigned reloced   : 1;
-        unsigned lbd       : 26;
+        unsigned lbd       : 24;
         unsigned removable : 1;
+        unsigned used      : 1;
+        unsigned vivified  : 1;
         unsigned size      : 32; }                            header;
     union { Lit lit; float act; uint32_t abs; uint32_t touched; CRef rel; } data[0];
 
@@ -145,6 +151,8 @@ class Clause {
         header.size      = ps.size();
         header.lbd       = 0;
         header.removable = 1;
+        header.used      = 0;
+        header.vivified  = 0;
 
         for (int i = 0; i < ps.size(); i++) 
             data[i].lit = ps[i];
@@ -158,16 +166,20 @@ class Clause {
     }
 
 public:
+    // The abstraction of a problem clause is a 64-bit signature of its variables (stored in the two
+    // extra words that learnt clauses use for activity and touched). The variables are hashed, so
+    // that large instances do not crowd the low bits as 'var & 63' would.
     void calcAbstraction() {
         assert(header.has_extra);
-        uint32_t abstraction = 0;
+        uint64_t abstraction = 0;
         for (int i = 0; i < size(); i++)
-            abstraction |= 1 << (var(data[i].lit) & 31);
-        data[header.size].abs = abstraction;  }
+            abstraction |= (uint64_t)1 << (((uint32_t)var(data[i].lit) * 0x9E3779B1u) >> 26);
+        data[header.size  ].abs = (uint32_t)abstraction;
+        data[header.size+1].abs = (uint32_t)(abstraction >> 32); }
 
 
     int          size        ()      const   { return header.size; }
-    void         shrink      (int i)         { assert(i <= size()); if (header.has_extra) data[header.size-i] = data[header.size]; header.size -= i; }
+    void         shrink      (int i)         { assert(i <= size()); if (header.has_extra){ data[header.size-i] = data[header.size]; data[header.size-i+1] = data[header.size+1]; } header.size -= i; }
     void         pop         ()              { shrink(1); }
     bool         learnt      ()      const   { return header.learnt; }
     bool         has_extra   ()      const   { return header.has_extra; }
@@ -183,6 +195,10 @@ public:
     void         set_lbd     (int lbd)       { header.lbd = lbd; }
     bool         removable   ()      const   { return header.removable; }
     void         removable   (bool b)        { header.removable = b; }
+    bool         used        ()      const   { return header.used; }
+    void         used        (bool b)        { header.used = b; }
+    bool         vivified    ()      const   { return header.vivified; }
+    void         vivified    (bool b)        { header.vivified = b; }
 
     // NOTE: somewhat unsafe to change the clause in-place! Must manually call 'calcAbstraction' afterwards for
     //       subsumption operations to behave correctly.
@@ -192,7 +208,7 @@ public:
 
     uint32_t&    touched     ()              { assert(header.has_extra && header.learnt); return data[header.size+1].touched; }
     float&       activity    ()              { assert(header.has_extra); return data[header.size].act; }
-    uint32_t     abstraction () const        { assert(header.has_extra); return data[header.size].abs; }
+    uint64_t     abstraction () const        { assert(header.has_extra && !header.learnt); return data[header.size].abs | (uint64_t)data[header.size+1].abs << 32; }
 
     Lit          subsumes    (const Clause& other) const;
     void         strengthen  (Lit p);
@@ -223,7 +239,7 @@ class ClauseAllocator : public RegionAllocator<uint32_t>
     {
         assert(sizeof(Lit)      == sizeof(uint32_t));
         assert(sizeof(float)    == sizeof(uint32_t));
-        int extras = learnt ? 2 : (int)extra_clause_field;
+        int extras = learnt || extra_clause_field ? 2 : 0;
 
         CRef cid = RegionAllocator<uint32_t>::alloc(clauseWord32Size(ps.size(), extras));
         new (lea(cid)) Clause(ps, extra_clause_field, learnt);
@@ -241,7 +257,7 @@ class ClauseAllocator : public RegionAllocator<uint32_t>
     void free(CRef cid)
     {
         Clause& c = operator[](cid);
-        int extras = c.learnt() ? 2 : (int)c.has_extra();
+        int extras = c.has_extra() ? 2 : 0;
         RegionAllocator<uint32_t>::free(clauseWord32Size(c.size(), extras));
     }
 
@@ -257,6 +273,8 @@ class ClauseAllocator : public RegionAllocator<uint32_t>
         // Copy extra data-fields: 
         // (This could be cleaned-up. Generalize Clause-constructor to be applicable here instead?)
         to[cr].mark(c.mark());
+        to[cr].used(c.used());
+        to[cr].vivified(c.vivified());
         if (to[cr].learnt()){
             to[cr].touched() = c.touched();
             to[cr].activity() = c.activity();
@@ -328,6 +346,175 @@ void OccLists<Idx,Vec,Deleted>::clean(const Idx& idx)
 }
 
 
+//=================================================================================================
+// CsrOccLists -- occurence lists with lazy deletion in one flat array (compressed sparse rows):
+//
+// Each list is a range of 'data' with some slack at its end. A list that outgrows its range is
+// moved to the end of 'data', leaving a gap behind; when the gaps take more than half of 'data',
+// all lists are cleaned and compacted. 'trim()' compacts them at once and gives the memory beyond
+// them back. The 'List' views returned by 'operator[]' and 'lookup()' follow removals from their
+// list, and are invalidated by 'init()', 'push()', 'reserve()' and 'trim()'.
+
+template<class Idx, class T, class Deleted>
+class CsrOccLists
+{
+    struct Range {
+        int start, size, cap;
+        Range() : start(0), size(0), cap(0) {} };
+
+    vec<T>     data;
+    vec<Range> ranges;
+    vec<char>  dirty;
+    vec<Idx>   dirties;
+    int        wasted;              // Elements of 'data' outside of all ranges.
+    Deleted    deleted;
+
+    static int slack(int size) { return (size >> 2) + 2; }
+
+    struct StartLt {
+        const vec<Range>& ranges;
+        StartLt(const vec<Range>& r) : ranges(r) {}
+        bool operator()(int i, int j) const { return ranges[i].start < ranges[j].start; } };
+
+    void       relocate(Range& r, int need);
+
+ public:
+    class List {
+        T*         elems;
+        const int* sz;
+     public:
+        List(T* e, const int* s) : elems(e), sz(s) {}
+        int      size      ()      const { return *sz; }
+        T&       operator[](int i) const { return elems[i]; }
+        operator T*        ()      const { return elems; }
+    };
+
+    CsrOccLists(const Deleted& d) : wasted(0), deleted(d) {}
+
+    void  init      (const Idx& idx){ ranges.growTo(toInt(idx)+1); dirty.growTo(toInt(idx)+1, 0); }
+    List  operator[](const Idx& idx){ Range& r = ranges[toInt(idx)]; return List((T*)data + r.start, &r.size); }
+    List  lookup    (const Idx& idx){ if (dirty[toInt(idx)]) clean(idx); return (*this)[idx]; }
+    int   size      (const Idx& idx) const { return ranges[toInt(idx)].size; }
+
+    void  push      (const Idx& idx, const T& elem){
+        Range& r = ranges[toInt(idx)];
+        if (r.size == r.cap) relocate(r, r.size + 1);
+        data[r.start + r.size++] = elem; }
+    void  reserve   (const Idx& idx, int cap){ Range& r = ranges[toInt(idx)]; if (r.cap < cap) relocate(r, cap); }
+    void  remove    (const Idx& idx, const T& elem);
+    void  clear     (const Idx& idx){ Range& r = ranges[toInt(idx)]; wasted += r.cap; r = Range(); }
+
+    void  cleanAll  ();
+    void  clean     (const Idx& idx);
+    void  smudge    (const Idx& idx){
+        if (dirty[toInt(idx)] == 0){
+            dirty[toInt(idx)] = 1;
+            dirties.push(idx);
+        }
+    }
+    void  compact   ();
+    void  trim      (){ compact(); data.fit(); }
+
+    void  clear(bool free = true){
+        data   .clear(free);
+        ranges .clear(free);
+        dirty  .clear(free);
+        dirties.clear(free);
+        wasted = 0;
+    }
+};
+
+
+// Gives 'r' room for at least 'need' elements: grows it in place if it ends 'data', else moves it
+// to the end, compacting first if the gaps would take more than half of 'data'.
+template<class Idx, class T, class Deleted>
+void CsrOccLists<Idx,T,Deleted>::relocate(Range& r, int need)
+{
+    if (!(r.cap > 0 && r.start + r.cap == data.size()) && 2 * ((int64_t)wasted + r.cap) > data.size()){
+        compact();
+        if (r.cap >= need) return; }
+
+    int cap = need + slack(need);
+    if (r.cap > 0 && r.start + r.cap == data.size()){
+        data.growTo(r.start + cap);
+        r.cap = cap;
+        return; }
+
+    int start = data.size();
+    data.growTo(start + cap);
+    for (int i = 0; i < r.size; i++)
+        data[start + i] = data[r.start + i];
+    wasted += r.cap;
+    r.start = start;
+    r.cap   = cap;
+}
+
+
+template<class Idx, class T, class Deleted>
+void CsrOccLists<Idx,T,Deleted>::remove(const Idx& idx, const T& elem)
+{
+    Range& r = ranges[toInt(idx)];
+    T*     e = (T*)data + r.start;
+    int    j = 0;
+    for (; j < r.size && e[j] != elem; j++);
+    assert(j < r.size);
+    for (; j < r.size-1; j++) e[j] = e[j+1];
+    r.size--;
+}
+
+
+template<class Idx, class T, class Deleted>
+void CsrOccLists<Idx,T,Deleted>::cleanAll()
+{
+    for (int i = 0; i < dirties.size(); i++)
+        // Dirties may contain duplicates so check here if a variable is already cleaned:
+        if (dirty[toInt(dirties[i])])
+            clean(dirties[i]);
+    dirties.clear();
+}
+
+
+template<class Idx, class T, class Deleted>
+void CsrOccLists<Idx,T,Deleted>::clean(const Idx& idx)
+{
+    Range& r = ranges[toInt(idx)];
+    T*     e = (T*)data + r.start;
+    int    i, j;
+    for (i = j = 0; i < r.size; i++)
+        if (!deleted(e[i]))
+            e[j++] = e[i];
+    r.size = j;
+    dirty[toInt(idx)] = 0;
+}
+
+
+// Slides the lists, cleaned, down over the gaps in the order of their positions (in place, so that
+// compacting takes no second array), keeping the slack that fits.
+template<class Idx, class T, class Deleted>
+void CsrOccLists<Idx,T,Deleted>::compact()
+{
+    cleanAll();
+    vec<int> order;
+    for (int i = 0; i < ranges.size(); i++)
+        if (ranges[i].cap > 0)
+            order.push(i);
+    sort(order, StartLt(ranges));
+
+    int pos = 0;
+    for (int k = 0; k < order.size(); k++){
+        Range& r   = ranges[order[k]];
+        int    end = k+1 < order.size() ? ranges[order[k+1]].start : data.size();
+        for (int j = 0; j < r.size; j++)
+            data[pos + j] = data[r.start + j];
+        r.start = pos;
+        r.cap   = r.size + slack(r.size) < end - pos ? r.size + slack(r.size) : end - pos;
+        pos    += r.cap; }
+
+    data.shrink(data.size() - pos);
+    wasted = 0;
+}
+
+
 //=================================================================================================
 // CMap -- a class for mapping clauses to values:
 
@@ -389,16 +576,32 @@ inline Lit Clause::subsumes(const Clause& other) const
     //if (other.size() < size() || (!learnt() && !other.learnt() && (extra.abst & ~other.extra.abst) != 0))
     assert(!header.learnt);   assert(!other.header.learnt);
     assert(header.has_extra); assert(other.header.has_extra);
-    if (other.header.size < header.size || (data[header.size].abs & ~other.data[other.header.size].abs) != 0)
+    if (other.header.size < header.size || (abstraction() & ~other.abstraction()) != 0)
         return lit_Error;
 
     Lit        ret = lit_Undef;
     const Lit* c   = (const Lit*)(*this);
     const Lit* d   = (const Lit*)other;
+    unsigned   n   = other.header.size;
 
     for (unsigned i = 0; i < header.size; i++) {
         // search for c[i] or ~c[i]
-        for (unsigned j = 0; j < other.header.size; j++)
+        unsigned j = 0;
+#ifdef __SSE2__
+        // Four literals of 'other' at a time:
+        const __m128i pos = _mm_set1_epi32(toInt(c[i]));
+        const __m128i neg = _mm_set1_epi32(toInt(~c[i]));
+        for (; j + 4 <= n; j += 4){
+            __m128i dj = _mm_loadu_si128((const __m128i*)(d + j));
+            if (_mm_movemask_epi8(_mm_cmpeq_epi32(dj, pos)))
+                goto ok;
+            else if (ret == lit_Undef && _mm_movemask_epi8(_mm_cmpeq_epi32(dj, neg))){
+                ret = c[i];
+                goto ok;
+            }
+        }
+#endif
+        for (; j < n; j++)
             if (c[i] == d[j])
                 goto ok;
             else if (ret == lit_Undef && c[i] == ~d[j]){
@@ -0,0 +1,521 @@
+/***************************************************************************************[Vivify.cc]
+Vivification of problem and TIER2 clauses: an inprocessing pass run at decision level 0 between
+restarts, within a share of the propagations of the search, optionally on a helper thread.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+**************************************************************************************************/
+
+#include <pthread.h>
+
+#include "mtl/Sort.h"
+#include "utils/Options.h"
+#include "core/Solver.h"
+
+using namespace Minisat;
+
+//=================================================================================================
+// Options:
+
+
+static const char* _cat = "VIVIFY";
+
+static DoubleOption opt_vivify_frac   (_cat, "vivify-frac",   "Share of the propagations spent on vivification (0 = off)", 0.05, DoubleRange(0, true, 1, true));
+static IntOption    opt_vivify_min    (_cat, "vivify-min",    "Propagations of vivification that must be due before a round starts", 50000, IntRange(1, INT32_MAX));
+static BoolOption   opt_vivify_thread (_cat, "vivify-thread", "Vivify a snapshot of the clauses on a helper thread (not with a proof)", false);
+
+
+//=================================================================================================
+// Vivification:
+//
+// A round starts at a restart once the propagations of all earlier rounds fall behind
+// '-vivify-frac' of all propagations by '-vivify-min', and ends when they catch up: the first half
+// of the budget goes to the TIER2 clauses not vivified yet, most recently used first, the rest to
+// the problem clauses not vivified in the current sweep, those used in conflict analysis since
+// the last sweep first. 'vivifyLits()' assigns the negations of the literals of a clause one after
+// the other until propagation conflicts or makes a remaining literal true; the decisions that the
+// conflict (or that literal) depends on, plus that literal, form a sub-clause that is a RUP
+// consequence of the clauses. A shorter sub-clause replaces the clause in place.
+//
+// With '-vivify-thread', a round copies the clauses into a fresh solver that a helper thread
+// vivifies, and the search goes on meanwhile. The results are committed at the first restart after
+// the thread has finished, for the clauses that are still there unchanged.
+
+
+struct Minisat::VivifyJob {
+    Solver          snap;         // Copy of the clauses at level 0, built and used by the helper thread.
+    int             vars;
+    vec<Lit>        formula;      // Units and clauses to copy into 'snap', each ended by 'lit_Undef',
+    vec<Lit>        cands;        // and the candidates (as in 'vivify_cands').
+    int             split;
+    double          half, budget; // Propagations to spend on the TIER2 candidates, and in all.
+    vec<char>       tried;        // Candidates the thread got to,
+    vec<int>        outAt;        // and where the shorter version of each starts in 'out', or -1.
+    vec<Lit>        out;
+    bool            swept;        // All candidates were tried.
+    pthread_t       id;
+    bool            joined;       // 'id' has been joined already (see 'vivifyWait()').
+    volatile bool   done;
+
+    VivifyJob() : vars(0), split(0), half(0), budget(0), swept(false), joined(false), done(false) {}
+};
+
+
+inline void Solver::vivifyEnqueue(Lit p, CRef from)
+{
+    assigns[var(p)] = lbool(!sign(p));
+    vardata[var(p)] = mkVarData(from, decisionLevel());
+    trail.push_(p);
+}
+
+
+// As 'propagate()', but without touching the statistics of the branching heuristics.
+CRef Solver::vivifyPropagate()
+{
+    CRef    confl     = CRef_Undef;
+    int     num_props = 0;
+
+    while (qhead < trail.size()){
+        Lit            p   = trail[qhead++];
+        vec<Watcher>&  ws  = watches[p];
+        Watcher        *i, *j, *end;
+        num_props++;
+
+        vec<Watcher>& ws_bin = watches_bin[p];
+        for (int k = 0; k < ws_bin.size(); k++){
+            Lit the_other = ws_bin[k].blocker;
+            if (value(the_other) == l_False){
+                confl = ws_bin[k].cref;
+                qhead = trail.size();
+                goto ExitProp;
+            }else if (value(the_other) == l_Undef)
+                vivifyEnqueue(the_other, ws_bin[k].cref);
+        }
+
+        for (i = j = (Watcher*)ws, end = i + ws.size();  i != end;){
+            Lit blocker = i->blocker;
+            if (value(blocker) == l_True){
+                *j++ = *i++; continue; }
+
+            CRef     cr        = i->cref;
+            Clause&  c         = ca[cr];
+            Lit      false_lit = ~p;
+            if (c[0] == false_lit)
+                c[0] = c[1], c[1] = false_lit;
+            assert(c[1] == false_lit);
+            i++;
+
+            Lit     first = c[0];
+            Watcher w     = Watcher(cr, first);
+            if (first != blocker && value(first) == l_True){
+                *j++ = w; continue; }
+
+            for (int k = 2; k < c.size(); k++)
+                if (value(c[k]) != l_False){
+                    c[1] = c[k]; c[k] = false_lit;
+                    watches[~c[1]].push(w);
+                    goto NextClause; }
+
+            *j++ = w;
+            if (value(first) == l_False){
+                confl = cr;
+                qhead = trail.size();
+                while (i < end)
+                    *j++ = *i++;
+            }else
+                vivifyEnqueue(first, cr);
+
+        NextClause:;
+        }
+        ws.shrink(i - j);
+    }
+
+ExitProp:;
+    propagations += num_props;
+    vivify_props += num_props;
+    simpDB_props -= num_props;
+
+    return confl;
+}
+
+
+// Undoes the assignments of 'vivifyLits()' without touching the saved phases.
+void Solver::vivifyBacktrack()
+{
+    for (int c = trail.size()-1; c >= trail_lim[0]; c--){
+        assigns[var(trail[c])] = l_Undef;
+        insertVarOrder(var(trail[c])); }
+    qhead = trail_lim[0];
+    trail.shrink(trail.size() - trail_lim[0]);
+    trail_lim.clear();
+}
+
+
+// Shrinks the literals 'lits' of a clause to a sub-clause implied by the clauses at level 0.
+// Returns FALSE if nothing was removed (or the clause is satisfied).
+bool Solver::vivifyLits(vec<Lit>& lits)
+{
+    assert(decisionLevel() == 0);
+    int i, j, size = lits.size();
+    for (i = j = 0; i < lits.size(); i++)
+        if (value(lits[i]) == l_True)
+            return false;
+        else if (value(lits[i]) == l_Undef)
+            lits[j++] = lits[i];
+    lits.shrink(i - j);
+
+    CRef confl   = CRef_Undef;
+    Lit  implied = lit_Undef;
+    newDecisionLevel();
+    for (i = 0; i < lits.size() && confl == CRef_Undef; i++)
+        if (value(lits[i]) == l_True){
+            implied = lits[i];
+            break;
+        }else if (value(lits[i]) == l_Undef){
+            vivifyEnqueue(~lits[i], CRef_Undef);
+            confl = vivifyPropagate(); }
+
+    if (confl != CRef_Undef || implied != lit_Undef){
+        // Keep the decisions that the conflict or the implied literal depends on (marked 2 in 'seen'):
+        if (confl != CRef_Undef){
+            const Clause& c = ca[confl];
+            for (int k = 0; k < c.size(); k++)
+                if (level(var(c[k])) > 0) seen[var(c[k])] = 1;
+        }else
+            seen[var(implied)] = 1;
+
+        for (int k = trail.size()-1; k >= trail_lim[0]; k--){
+            Var v = var(trail[k]);
+            if (seen[v] != 1) continue;
+            CRef r = reason(v);
+            if (r == CRef_Undef){
+                seen[v] = 2; continue; }
+            seen[v] = 0;
+            const Clause& c = ca[r];
+            for (int l = 0; l < c.size(); l++)
+                if (var(c[l]) != v && level(var(c[l])) > 0 && seen[var(c[l])] == 0)
+                    seen[var(c[l])] = 1;
+        }
+
+        for (i = j = 0; i < lits.size(); i++){
+            if (seen[var(lits[i])] == 2 || lits[i] == implied)
+                lits[j++] = lits[i];
+            seen[var(lits[i])] = 0; }
+        lits.shrink(i - j);
+    }else{
+        // Every literal is false now; keep the ones that were assigned as decisions:
+        for (i = j = 0; i < lits.size(); i++)
+            if (reason(var(lits[i])) == CRef_Undef)
+                lits[j++] = lits[i];
+        lits.shrink(i - j);
+    }
+
+    vivifyBacktrack();
+    return lits.size() < size;
+}
+
+
+// Replaces the clause 'cr' by its sub-clause 'lits' (no literal of which is assigned).
+bool Solver::vivifyReplace(CRef cr, const vec<Lit>& lits)
+{
+    Clause& c = ca[cr];
+    vivify_shortened++;
+    vivify_lits += c.size() - lits.size();
+
+    if (drup_file){
+#ifdef BIN_DRUP
+        binDRUP('a', lits, drup_file);
+#else
+        for (int i = 0; i < lits.size(); i++)
+            fprintf(drup_file, "%i ", (var(lits[i]) + 1) * (-2 * sign(lits[i]) + 1));
+        fprintf(drup_file, "0\n");
+#endif
+    }
+
+    if (lits.size() <= 1){
+        removeClause(cr);
+        if (lits.size() == 0)
+            return false;
+        uncheckedEnqueue(lits[0]);
+        return propagate() == CRef_Undef; }
+
+    if (drup_file){
+#ifdef BIN_DRUP
+        binDRUP('d', c, drup_file);
+#else
+        fprintf(drup_file, "d ");
+        for (int i = 0; i < c.size(); i++)
+            fprintf(drup_file, "%i ", (var(c[i]) + 1) * (-2 * sign(c[i]) + 1));
+        fprintf(drup_file, "0\n");
+#endif
+    }
+
+    detachClause(cr, true);
+    for (int i = 0; i < lits.size(); i++)
+        c[i] = lits[i];
+    c.shrink(c.size() - lits.size());
+    if (c.learnt()){
+        if (c.lbd() > c.size()) c.set_lbd(c.size());
+        if (c.lbd() <= core_lbd_cut && c.mark() != CORE){
+            learnts_core.push(cr);
+            c.mark(CORE); }
+    }else if (c.has_extra())
+        c.calcAbstraction();
+    attachClause(cr);
+
+    return true;
+}
+
+
+struct vivify_lt {
+    ClauseAllocator& ca;
+    vivify_lt(ClauseAllocator& ca_) : ca(ca_) {}
+    bool operator () (CRef x, CRef y) const { return ca[x].touched() > ca[y].touched(); }
+};
+
+
+// Collects the candidates of a round in 'vivify_cands', starting a new sweep over the problem
+// clauses when all have been vivified.
+void Solver::vivifyCandidates()
+{
+    vivify_cands.clear();
+    for (int i = 0; i < learnts_tier2.size(); i++){
+        const Clause& c = ca[learnts_tier2[i]];
+        if (c.mark() == TIER2 && !c.vivified() && c.size() > 2)
+            vivify_cands.push(learnts_tier2[i]); }
+    sort(vivify_cands, vivify_lt(ca));
+    vivify_split = vivify_cands.size();
+
+    for (int sweep = 0; sweep < 2 && vivify_cands.size() == vivify_split; sweep++){
+        if (sweep == 1)
+            for (int i = 0; i < clauses.size(); i++)
+                ca[clauses[i]].vivified(false);
+        for (int used = 1; used >= 0; used--)
+            for (int i = 0; i < clauses.size(); i++){
+                const Clause& c = ca[clauses[i]];
+                if (c.mark() == 0 && !c.vivified() && c.used() == (bool)used && c.size() > 2)
+                    vivify_cands.push(clauses[i]); }
+    }
+}
+
+
+void* Solver::vivifyThread(void* arg)
+{
+    VivifyJob& job = *(VivifyJob*)arg;
+    Solver&    s   = job.snap;
+    vec<Lit>   lits;
+
+    while (s.nVars() < job.vars)
+        s.newVar();
+    for (int i = 0; i < job.formula.size() && s.okay(); i++)
+        if (job.formula[i] == lit_Undef){
+            s.addClause_(lits);
+            lits.clear();
+        }else
+            lits.push(job.formula[i]);
+
+    int i = 0, k = 0;
+    if (s.okay() && s.propagate() == CRef_Undef)
+        for (; k < job.cands.size() && !s.asynch_interrupt; i++, k++){
+            lits.clear();
+            for (; job.cands[k] != lit_Undef; k++)
+                lits.push(job.cands[k]);
+            if (s.vivify_props >= (i < job.split ? job.half : job.budget)){
+                if (i >= job.split) break;
+                continue; }
+            s.vivified++;
+            job.tried[i] = 1;
+            if (s.vivifyLits(lits)){
+                job.outAt[i] = job.out.size();
+                for (int j = 0; j < lits.size(); j++)
+                    job.out.push(lits[j]);
+                job.out.push(lit_Undef); }
+        }
+    job.swept = k == job.cands.size();
+    job.done  = true;
+
+    return NULL;
+}
+
+
+// Commits the results of the helper thread, which has finished.
+bool Solver::vivifyCommit()
+{
+    assert(decisionLevel() == 0 && vivify_job != NULL && vivify_job->done);
+    VivifyJob* job = vivify_job;
+    if (!job->joined) pthread_join(job->id, NULL);
+    vivify_job = NULL;
+
+    vivified     += job->snap.vivified;
+    vivify_props += job->snap.vivify_props;
+    if (job->swept && propagations * opt_vivify_frac > vivify_props)
+        vivify_props = (uint64_t)(propagations * opt_vivify_frac);
+
+    bool result = true;
+    for (int i = 0, k = 0; i < vivify_cands.size() && result; i++, k++){
+        int start = k;
+        while (job->cands[k] != lit_Undef) k++;
+        if (vivify_cands[i] == CRef_Undef) continue;
+
+        // Candidates that the thread did not get to are left for later rounds:
+        Clause& c = ca[vivify_cands[i]];
+        if (c.mark() == 1) continue;
+        if (!job->tried[i]){
+            c.vivified(false); continue; }
+        c.used(false);
+        if (job->outAt[i] < 0 || c.size() != k - start) continue;
+
+        // Commit only if the clause is unchanged since the snapshot:
+        for (int j = start; j < k; j++)
+            seen[var(job->cands[j])] = 1 + sign(job->cands[j]);
+        bool same = true;
+        for (int j = 0; j < c.size() && same; j++)
+            same = seen[var(c[j])] == 1 + sign(c[j]);
+        for (int j = start; j < k; j++)
+            seen[var(job->cands[j])] = 0;
+        if (!same) continue;
+
+        vivify_tmp.clear();
+        int l;
+        for (l = job->outAt[i]; job->out[l] != lit_Undef; l++)
+            if (value(job->out[l]) == l_True) break;
+            else if (value(job->out[l]) == l_Undef) vivify_tmp.push(job->out[l]);
+        if (job->out[l] != lit_Undef) continue;
+        if (!vivifyReplace(vivify_cands[i], vivify_tmp))
+            result = false;
+    }
+
+    vivify_cands.clear();
+    delete job;
+    return result;
+}
+
+
+// Waits for the helper thread, dropping its results.
+void Solver::vivifyStop()
+{
+    if (vivify_job == NULL) return;
+    vivify_job->snap.interrupt();
+    if (!vivify_job->joined) pthread_join(vivify_job->id, NULL);
+    delete vivify_job;
+    vivify_job = NULL;
+    vivify_cands.clear();
+}
+
+
+// Waits for the helper thread to finish its round (e.g. before a 'fork()', whose child would
+// otherwise inherit locks the thread may hold); the results are committed by the next 'vivify()'.
+void Solver::vivifyWait()
+{
+    if (vivify_job == NULL || vivify_job->joined) return;
+    pthread_join(vivify_job->id, NULL);
+    vivify_job->joined = true;
+}
+
+
+bool Solver::vivifyDue() const
+{
+    return opt_vivify_frac > 0 && propagations * opt_vivify_frac >= vivify_props + opt_vivify_min;
+}
+
+
+bool Solver::vivifyReady() const
+{
+    return vivify_job != NULL ? vivify_job->done : vivifyDue();
+}
+
+
+bool Solver::vivify()
+{
+    assert(decisionLevel() == 0);
+    if (!ok || propagate() != CRef_Undef)
+        return ok = false;
+
+    if (vivify_job != NULL){
+        if (!vivify_job->done) return true;
+        if (!vivifyCommit() || propagate() != CRef_Undef)
+            return ok = false;
+        if (!vivifyDue()) return true; }
+
+    vivify_rounds++;
+    watches_bin.cleanAll();
+    watches    .cleanAll();
+    vivifyCandidates();
+    double budget = propagations * opt_vivify_frac;
+    double half   = vivify_props + (budget - vivify_props) / 2;
+
+    if (opt_vivify_thread && drup_file == NULL){
+        VivifyJob* job = new VivifyJob;
+        job->vars   = nVars();
+        job->split  = vivify_split;
+        job->half   = half - vivify_props;
+        job->budget = budget - vivify_props;
+        for (int i = 0; i < trail.size(); i++){
+            job->formula.push(trail[i]);
+            job->formula.push(lit_Undef); }
+        for (int t = 0; t < 3; t++){
+            const vec<CRef>& cs = t == 0 ? clauses : t == 1 ? learnts_core : learnts_tier2;
+            for (int i = 0; i < cs.size(); i++){
+                const Clause& c = ca[cs[i]];
+                if (c.mark() == 1 || (t == 2 && c.mark() != TIER2)) continue;
+                for (int k = 0; k < c.size(); k++)
+                    job->formula.push(c[k]);
+                job->formula.push(lit_Undef); }
+        }
+        for (int i = 0; i < vivify_cands.size(); i++){
+            Clause& c = ca[vivify_cands[i]];
+            c.vivified(true);
+            for (int k = 0; k < c.size(); k++)
+                job->cands.push(c[k]);
+            job->cands.push(lit_Undef); }
+        job->tried.growTo(vivify_cands.size(), 0);
+        job->outAt.growTo(vivify_cands.size(), -1);
+
+        if (pthread_create(&job->id, NULL, vivifyThread, job) == 0){
+            vivify_job = job;
+            return true; }
+        delete job;   // (no thread: vivify right here)
+        for (int i = 0; i < vivify_cands.size(); i++)
+            ca[vivify_cands[i]].vivified(false);
+    }
+
+    int i;
+    for (i = 0; i < vivify_cands.size() && !asynch_interrupt; i++){
+        if (vivify_props >= (i < vivify_split ? half : budget)){
+            if (i >= vivify_split) break;
+            i = vivify_split - 1;
+            continue; }
+
+        CRef    cr = vivify_cands[i];
+        Clause& c  = ca[cr];
+        if (c.mark() == 1) continue;
+        c.vivified(true);
+        c.used(false);
+        vivified++;
+
+        vivify_tmp.clear();
+        for (int k = 0; k < c.size(); k++)
+            vivify_tmp.push(c[k]);
+        if (vivifyLits(vivify_tmp) && !vivifyReplace(cr, vivify_tmp))
+            return ok = false;
+    }
+
+    // After a whole sweep, wait until the budget has grown by '-vivify-min' again:
+    if (i == vivify_cands.size() && budget > vivify_props)
+        vivify_props = (uint64_t)budget;
+    vivify_cands.clear();
+
+    return true;
+}
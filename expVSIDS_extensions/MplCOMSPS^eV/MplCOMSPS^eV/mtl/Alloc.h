@@ -21,6 +21,8 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 #ifndef Minisat_Alloc_h
 #define Minisat_Alloc_h
 
+#include <string.h>
+
 #include "mtl/XAlloc.h"
 #include "mtl/Vec.h"
 
@@ -79,6 +81,27 @@ class RegionAllocator
         sz = cap = wasted_ = 0;
     }
 
+    // Take over the buffer of 'from' whenever it can hold the current contents, keeping them (and
+    // thus all references into them). 'from' is left empty and the buffer of this region, of
+    // which only the first 'sz' units were used, is released.
+    void     recycle(RegionAllocator& from) {
+        if (from.memory == NULL || from.cap < sz) return;
+        memcpy(from.memory, memory, sizeof(T)*sz);
+        from.sz = sz;
+        from.wasted_ = wasted_;
+        from.moveTo(*this);
+    }
+
+    // Raw contents of the region, for writing and reading checkpoints. 'setRaw()' resizes the
+    // region to 'size' units and returns the memory to be filled in.
+    const T* raw       () const      { return memory; }
+    T*       setRaw    (uint32_t size, uint32_t wasted) {
+        capacity(size);
+        sz = size;
+        wasted_ = wasted;
+        return memory;
+    }
+
 
 };
 
@@ -65,6 +65,7 @@ public:
     void     shrink_  (int nelems)     { assert(nelems <= sz); sz -= nelems; }
     int      capacity (void) const     { return cap; }
     void     capacity (int min_cap);
+    void     fit      (void);          // Releases the capacity beyond 'size()'.
     void     growTo   (int size);
     void     growTo   (int size, const T& pad);
     void     clear    (bool dealloc = false);
@@ -101,6 +102,14 @@ void vec<T>::capacity(int min_cap) {
  }
 
 
+template<class T>
+void vec<T>::fit(void) {
+    if (sz == cap) return;
+    if (sz == 0){ clear(true); return; }
+    T* shrunk = (T*)::realloc(data, sz * sizeof(T));
+    if (shrunk != NULL) data = shrunk, cap = sz; }
+
+
 template<class T>
 void vec<T>::growTo(int size, const T& pad) {
     if (sz >= size) return;
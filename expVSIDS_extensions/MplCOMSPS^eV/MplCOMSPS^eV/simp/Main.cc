@@ -23,13 +23,16 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 #include <errno.h>
 
 #include <signal.h>
+#include <unistd.h>
 #include <zlib.h>
 #include <sys/resource.h>
+#include <sys/stat.h>
 
 #include "utils/System.h"
 #include "utils/ParseUtils.h"
 #include "utils/Options.h"
 #include "core/Dimacs.h"
+#include "core/ModelWriter.h"
 #include "simp/SimpSolver.h"
 #include<iostream>
 using namespace std;
@@ -86,8 +89,11 @@ using namespace Minisat;
 //         );
 // }
 
+static double instance_start = 0; // CPU time at which the current instance was started (batch mode).
+static const char* pre_cache = NULL; // Directory of the preprocessing cache (-pre-cache), or NULL.
+
 void printStats(Solver& solver){
-    double cpu_time = cpuTime();
+    double cpu_time = cpuTime() - instance_start;
    //double mem_used = memUsedPeak();
    // (solving_state, probeTime, cpu_time, decisions, conflicts, #gCluases, averageLBD, GLR, inc)
 //    printf("%d %f %"PRIu64" %"PRIu64" %"PRIu64" %f %"PRIu64" %"PRIu64" %f %f %"PRIu64" %f %f %f %f %"PRIu64" %"PRIu64" %"PRIu64" %"PRIu64" %"PRIu64" %f %f %f %"PRIu64" %"PRIu64"\n"
@@ -162,6 +168,310 @@ static void SIGINT_exit(int signum) {
         printf("c *** INTERRUPTED ***\n"); }
     _exit(1); }
 
+// Asks the solver to write a checkpoint at its next restart (see '-checkpoint').
+static void SIGUSR2_checkpoint(int signum) { solver->checkpoint_requested = 1; }
+
+
+//=================================================================================================
+// Cube files:
+
+
+// Writes 'cubes' (each ended by 'lit_Undef') as an iCNF file: the header "p inccnf", then one
+// "a <lits> 0" line per cube. Returns the number of cubes, or -1 on error.
+static int writeCubes(const char* file, const vec<Lit>& cubes)
+{
+    FILE* f = fopen(file, "wb");
+    if (f == NULL) return -1;
+    fprintf(f, "p inccnf\n");
+    int n = 0;
+    for (int i = 0; i < cubes.size(); i++){
+        if (i == 0 || cubes[i - 1] == lit_Undef)
+            fputc('a', f);
+        if (cubes[i] == lit_Undef){
+            fprintf(f, " 0\n");
+            n++;
+        }else
+            fprintf(f, " %s%d", sign(cubes[i]) ? "-" : "", var(cubes[i]) + 1); }
+    return fclose(f) == 0 ? n : -1;
+}
+
+
+// Reads the cubes ("a <lits> 0" lines) of the iCNF file 'file'. Clause lines are added to the
+// formula. Cubes refer to the simplified formula, so they must not mention eliminated variables.
+static bool readCubes(SimpSolver& S, const char* file, vec<Lit>& cubes)
+{
+    gzFile in = gzopen(file, "rb");
+    if (in == NULL){
+        printf("c ERROR! Could not open cube file: %s\n", file);
+        return false; }
+
+    StreamBuffer buf(in);
+    vec<Lit>     lits;
+    bool         ok = true;
+    while (ok){
+        skipWhitespace(buf);
+        if (*buf == EOF) break;
+        if (*buf == 'p' || *buf == 'c'){ skipLine(buf); continue; }
+        bool is_cube = *buf == 'a';
+        if (is_cube) ++buf;
+        lits.clear();
+        for (int x; ok && (x = parseInt(buf)) != 0; ){
+            Var v = abs(x) - 1;
+            if (v >= S.nVars() || S.isEliminated(v)){
+                printf("c ERROR! Cube file %s: variable %d is %s (use the preprocessing options of the run that wrote the cubes).\n",
+                       file, v + 1, v >= S.nVars() ? "unknown" : "eliminated");
+                ok = false; }
+            lits.push(x > 0 ? mkLit(v) : ~mkLit(v)); }
+        if (is_cube){
+            for (int i = 0; i < lits.size(); i++)
+                cubes.push(lits[i]);
+            cubes.push(lit_Undef);
+        }else if (ok)
+            S.addClause(lits);
+    }
+    gzclose(in);
+    return ok;
+}
+
+
+//=================================================================================================
+// Solving one instance:
+
+
+// Parses, simplifies and solves 'input', prints the statistics record of the instance and writes the
+// answer (and model) to 'output' if given. If 'resume' is given, the search continues from that
+// checkpoint. With 'cube' the problem is split and the cubes are written there, and solved too with
+// 'cnc'; with 'conquer' the cubes read from that file are solved. Returns the exit code of the
+// solver (10, 20 or 0), or -1 if a file could not be read.
+//
+static int solveInstance(SimpSolver& S, const char* input, const char* output, const char* dimacs, const char* resume,
+                         const char* cube = NULL, const char* conquer = NULL, bool cnc = false)
+{
+    double initial_time = cpuTime();
+
+    gzFile in = (input == NULL) ? gzdopen(0, "rb") : gzopen(input, "rb");
+    if (in == NULL){
+        printf("c ERROR! Could not open file: %s\n", input == NULL ? "<stdin>" : input);
+        return -1; }
+
+    printf("%s ", input);
+
+    if (S.verbosity > 0){
+        printf("c ============================[ Problem Statistics ]=============================\n");
+        printf("c |                                                                             |\n"); }
+
+    uint64_t hash = dimacs_hash_init;
+    parse_DIMACS(in, S, pre_cache != NULL ? &hash : NULL);
+    gzclose(in);
+    FILE* res = (output != NULL) ? fopen(output, "wb") : NULL;
+
+    if (S.verbosity > 0){
+        printf("c |  Number of variables:  %12d                                         |\n", S.nVars());
+        printf("c |  Number of clauses:    %12d                                         |\n", S.nClauses()); }
+
+    double parsed_time = cpuTime();
+    if (S.verbosity > 0)
+        printf("c |  Parse time:           %12.2f s                                       |\n", parsed_time - initial_time);
+
+    // Change to signal-handlers that will only notify the solver and allow it to terminate
+    // voluntarily:
+    signal(SIGINT, SIGINT_interrupt);
+    signal(SIGXCPU,SIGINT_interrupt);
+
+    S.parsing = false;
+    bool cached = false;
+    if (pre_cache != NULL){
+        // The cache entry is written under a temporary name and renamed, so that concurrent runs
+        // never read a partial entry:
+        uint64_t key = S.preprocessKey(hash);
+        char     file[4096], tmp[4096 + 32];
+        snprintf(file, sizeof(file), "%s/%016" PRIx64 ".pre", pre_cache, key);
+        snprintf(tmp,  sizeof(tmp),  "%s.%d.tmp", file, (int)getpid());
+        if (!(cached = S.readPreprocessed(file, key))){
+            S.eliminate(true);
+            mkdir(pre_cache, 0777);
+            if (!S.writePreprocessed(tmp, key) || rename(tmp, file) != 0){
+                remove(tmp);
+                printf("c WARNING! Could not write the preprocessing cache entry %s\n", file); }
+        }
+    }else
+        S.eliminate(true);
+    double simplified_time = cpuTime();
+    if (S.verbosity > 0){
+        if (pre_cache != NULL)
+            printf("c |  Preprocessing cache:  %12s                                         |\n", cached ? "hit" : "miss");
+        printf("c |  Simplification time:  %12.2f s                                       |\n", simplified_time - parsed_time);
+        if (S.elim_rounds > 0)
+            printf("c |    parallel elim:      %12.2f s (wall clock, %6d rounds)           |\n", S.elim_time, S.elim_rounds);
+        if (S.subsumption_checks > 0)
+            printf("c |    subsumption:        %12.2f s (%11.0f checks, %8.3g /s)     |\n", S.subsumption_time,
+                   (double)S.subsumption_checks, S.subsumption_time > 0 ? S.subsumption_checks / S.subsumption_time : 0.0);
+        printf("c |                                                                             |\n"); }
+
+    if (!S.okay()){
+        if (res != NULL) fprintf(res, "UNSAT\n"), fclose(res);
+        if (S.verbosity > -1){
+            printf("c ===============================================================================\n");
+            printf("c Solved by simplification\n");
+            printStats(S);
+            printf("\n"); }
+        printf("s UNSATISFIABLE\n");
+        if (S.drup_file){
+#ifdef BIN_DRUP
+            fputc('a', S.drup_file); fputc(0, S.drup_file);
+#else
+            fprintf(S.drup_file, "0\n");
+#endif
+        }
+        if (S.drup_file && S.drup_file != stdout) fclose(S.drup_file);
+        return 20;
+    }
+
+    if (dimacs){
+        if (S.verbosity > 0)
+            printf("c ==============================[ Writing DIMACS ]===============================\n");
+        S.toDimacs(dimacs);
+        if (S.verbosity > 0)
+            printStats(S);
+        return 0;
+    }
+
+    if (resume != NULL && !S.readCheckpoint(resume)){
+        printf("c ERROR! Could not resume from checkpoint: %s\n", resume);
+        if (res != NULL) fclose(res);
+        return -1; }
+
+    lbool ret;
+    if (conquer != NULL){
+        vec<Lit> cubes;
+        if (!readCubes(S, conquer, cubes)){
+            if (res != NULL) fclose(res);
+            return -1; }
+        ret = S.conquer(cubes);
+    }else if (cube != NULL || cnc){
+        vec<Lit> cubes;
+        ret = S.cube(cubes);
+        if (ret == l_Undef && cube != NULL){
+            int n = writeCubes(cube, cubes);
+            if (n < 0){
+                printf("c ERROR! Could not write cube file: %s\n", cube);
+                if (res != NULL) fclose(res);
+                return -1; }
+            if (S.verbosity > 0)
+                printf("c Wrote %d cubes to %s\n", n, cube); }
+        if (ret == l_Undef && cnc)
+            ret = S.conquer(cubes);
+        else if (ret == l_Undef){     // Only splitting
+            if (res != NULL) fclose(res);
+            return 0; }
+        else if (cube != NULL && S.verbosity > 0)
+            printf("c Solved while splitting: no cube file written\n");
+    }else{
+        vec<Lit> dummy;
+        ret = S.solveLimited(dummy);
+    }
+    S.state = ret==l_True ? 1 : (ret==l_False ? 0 : -1);        
+
+    if (S.verbosity > 0 && S.probe_rounds > 0)
+        printf("c probing: %.0f rounds, %.0f probes, %.0f failed literals, %.0f hyper-binary resolvents, %.0f equivalences\n",
+               (double)S.probe_rounds, (double)S.probed, (double)S.failed_lits, (double)S.hyper_binaries, (double)S.probe_equivs);
+    if (S.verbosity > 0 && S.vivify_rounds > 0)
+        printf("c vivification: %.0f rounds, %.0f clauses, %.0f shortened, %.0f literals removed\n",
+               (double)S.vivify_rounds, (double)S.vivified, (double)S.vivify_shortened, (double)S.vivify_lits);
+    if (S.verbosity > 0 && S.gauss_rows > 0)
+        printf("c gauss: %.0f rows, %.0f propagations, %.0f conflicts\n",
+               (double)S.gauss_rows, (double)S.gauss_props, (double)S.gauss_conflicts);
+    if (S.verbosity > 0 && S.reused_restarts > 0)
+        printf("c trail reuse: %.0f of %.0f restarts, %.0f levels kept, %.0f propagations saved\n",
+               (double)S.reused_restarts, (double)S.starts, (double)S.reused_levels, (double)S.reused_props);
+    if (S.verbosity > 0 && S.inproc_rounds > 0)
+        printf("c inprocessing: %d rounds, %.2f s, %d variables removed, %d clauses removed\n",
+               S.inproc_rounds, S.inproc_time, S.inproc_vars, S.inproc_removed);
+    
+    if (S.verbosity > -1){
+        printStats(S);
+        //printf("\n"); 
+    }
+    //printf(ret == l_True ? "s SATISFIABLE\n" : ret == l_False ? "s UNSATISFIABLE\n" : "s UNKNOWN\n");
+    // if (ret == l_True){
+    //     printf("v ");
+    //     for (int i = 0; i < S.nVars(); i++)
+    //         if (S.model[i] != l_Undef)
+    //             printf("%s%s%d", (i==0)?"":" ", (S.model[i]==l_True)?"":"-", i+1);
+    //     printf(" 0\n");
+    // }
+
+    if (S.drup_file && ret == l_False){
+#ifdef BIN_DRUP
+        fputc('a', S.drup_file); fputc(0, S.drup_file);
+#else
+        fprintf(S.drup_file, "0\n");
+#endif
+    }
+    if (S.drup_file && S.drup_file != stdout) fclose(S.drup_file);
+
+    if (res != NULL){
+        if (ret == l_True){
+            writeSatResult(res, S.model);
+        }else if (ret == l_False)
+            fprintf(res, "UNSAT\n");
+        else
+            fprintf(res, "INDET\n");
+        fclose(res);
+    }
+
+    return ret == l_True ? 10 : ret == l_False ? 20 : 0;
+}
+
+
+// Solves the instances listed in 'manifest' (one "<input-file> [<result-output-file>]" per line,
+// '#' starts a comment, "-" reads the list from standard input) back to back in this process. The
+// clause arena of each finished solver is handed over to the next one.
+//
+static int solveBatch(const char* manifest, bool pre, int mWDefault, int mSDefault, int prThDefault, int verb)
+{
+    FILE* list = strcmp(manifest, "-") == 0 ? stdin : fopen(manifest, "r");
+    if (list == NULL){
+        printf("c ERROR! Could not open manifest: %s\n", manifest);
+        return 1; }
+
+    SimpSolver* prev = NULL;
+    int         instances = 0, failures = 0;
+    char        line[8192], input[8192], output[8192];
+    while (fgets(line, sizeof(line), list) != NULL){
+        if (strchr(line, '#') != NULL) *strchr(line, '#') = '\0';
+        int fields = sscanf(line, "%8191s %8191s", input, output);
+        if (fields < 1) continue;
+
+        SimpSolver* S = new SimpSolver;
+        if (prev != NULL){
+            S->recycleArena(*prev);
+            delete prev; }
+
+        if (!pre) S->eliminate(true);
+        instance_start = cpuTime();
+        S->parsing     = true;
+        S->verbosity   = verb;
+        S->mWDefault   = mWDefault;
+        S->mSDefault   = mSDefault;
+        S->prThDefault = prThDefault;
+        solver = S;
+        signal(SIGINT, SIGINT_exit);
+        signal(SIGXCPU,SIGINT_exit);
+
+        if (solveInstance(*S, input, fields >= 2 ? output : NULL, NULL, NULL) < 0)
+            failures++;
+        fflush(stdout);
+        instances++;
+        prev = S;
+    }
+    delete prev;
+
+    if (list != stdin) fclose(list);
+    printf("c Batch: %d instances, %d unreadable, %g s CPU\n", instances, failures, cpuTime());
+    return failures == 0 ? 0 : 1;
+}
+
 
 //=================================================================================================
 // Main:
@@ -186,38 +496,20 @@ int main(int argc, char** argv)
         IntOption    mem_lim("MAIN", "mem-lim","Limit on memory usage in megabytes.\n", INT32_MAX, IntRange(0, INT32_MAX));
         BoolOption   drup   ("MAIN", "drup",   "Generate DRUP UNSAT proof.", false);
         StringOption drup_file("MAIN", "drup-file", "DRUP UNSAT proof ouput file.", "");
+        StringOption batch  ("MAIN", "batch",  "Solve the instances listed in this manifest file (\"-\" for standard input) in one process.");
+        StringOption checkpoint("MAIN", "checkpoint", "Write the search state to this file on SIGUSR2 (and periodically, see -checkpoint-interval).");
+        IntOption    checkpoint_int("MAIN", "checkpoint-interval", "Conflicts between periodic checkpoints (0 = only on SIGUSR2).", 0, IntRange(0, INT32_MAX));
+        StringOption resume ("MAIN", "resume", "Continue the search from this checkpoint (written for the same input and options).");
+        StringOption cube   ("MAIN", "cube",   "Split the problem into cubes and write them to this file (iCNF), then stop.");
+        StringOption conquer("MAIN", "conquer","Solve the cubes of this iCNF file (from -cube with the same preprocessing) on -conquer-threads threads.");
+        BoolOption   cnc    ("MAIN", "cnc",    "Split the problem into cubes and solve them on -conquer-threads threads.", false);
+        StringOption cache  ("MAIN", "pre-cache", "Keep the preprocessed formulas in this directory, keyed by the input clauses and the preprocessing options.");
 
         IntOption    mWDefault("MAIN", "mWDefault","Default value for mW.\n", 5, IntRange(1, INT32_MAX));
         IntOption    mSDefault("MAIN", "mWDefault","Default value for mS.\n", 5, IntRange(1, INT32_MAX));
         IntOption    prThDefault("MAIN", "prThDefault","Default value for prTh\n.\n", 2, IntRange(1, INT32_MAX));
 
         parseOptions(argc, argv, true);
-        
-        SimpSolver  S;
-        double      initial_time = cpuTime();
-
-        if (!pre) S.eliminate(true);
-
-        S.parsing = true;
-        S.verbosity = verb;
-
-        S.mWDefault = mWDefault;
-        S.mSDefault = mSDefault;
-        S.prThDefault= prThDefault;
-
-        if (drup || strlen(drup_file)){
-            S.drup_file = strlen(drup_file) ? fopen(drup_file, "wb") : stdout;
-            if (S.drup_file == NULL){
-                S.drup_file = stdout;
-                printf("c Error opening %s for write.\n", (const char*) drup_file); }
-            printf("c DRUP proof generation: %s\n", S.drup_file == stdout ? "stdout" : drup_file);
-        }
-
-        solver = &S;
-        // Use signal handlers that forcibly quit until the solver will be able to respond to
-        // interrupts:
-        signal(SIGINT, SIGINT_exit);
-        signal(SIGXCPU,SIGINT_exit);
 
         // Set limit on CPU-time:
         if (cpu_lim != INT32_MAX){
@@ -241,116 +533,64 @@ int main(int argc, char** argv)
                     printf("c WARNING! Could not set resource limit: Virtual memory.\n");
                 }
             } }
-        
-        if (argc == 1)
-            printf("c Reading from standard input... Use '--help' for help.\n");
 
-        gzFile in = (argc == 1) ? gzdopen(0, "rb") : gzopen(argv[1], "rb");
-        if (in == NULL)
-            printf("c ERROR! Could not open file: %s\n", argc == 1 ? "<stdin>" : argv[1]), exit(1);
-        
-        printf("%s ",argv[1]);
-            
-        if (S.verbosity > 0){
-            printf("c ============================[ Problem Statistics ]=============================\n");
-            printf("c |                                                                             |\n"); }
-        
-        parse_DIMACS(in, S);
-        gzclose(in);
-        FILE* res = (argc >= 3) ? fopen(argv[2], "wb") : NULL;
+        if (cache && pre){
+            if (drup || strlen(drup_file))
+                printf("c WARNING! -pre-cache is ignored while a DRUP proof is written.\n");
+            else
+                pre_cache = cache; }
 
-        if (S.verbosity > 0){
-            printf("c |  Number of variables:  %12d                                         |\n", S.nVars());
-            printf("c |  Number of clauses:    %12d                                         |\n", S.nClauses()); }
+        if (batch){
+            if (drup || strlen(drup_file) || dimacs || checkpoint || resume || cube || conquer || cnc)
+                printf("c WARNING! -drup, -drup-file, -dimacs, -checkpoint, -resume, -cube, -conquer and -cnc are ignored in batch mode.\n");
+            exit(solveBatch(batch, pre, mWDefault, mSDefault, prThDefault, verb));
+        }
         
-        double parsed_time = cpuTime();
-        if (S.verbosity > 0)
-            printf("c |  Parse time:           %12.2f s                                       |\n", parsed_time - initial_time);
+        SimpSolver  S;
 
-        // Change to signal-handlers that will only notify the solver and allow it to terminate
-        // voluntarily:
-        signal(SIGINT, SIGINT_interrupt);
-        signal(SIGXCPU,SIGINT_interrupt);
+        if (!pre) S.eliminate(true);
 
-        S.parsing = false;
-        S.eliminate(true);
-        double simplified_time = cpuTime();
-        if (S.verbosity > 0){
-            printf("c |  Simplification time:  %12.2f s                                       |\n", simplified_time - parsed_time);
-            printf("c |                                                                             |\n"); }
-
-        if (!S.okay()){
-            if (res != NULL) fprintf(res, "UNSAT\n"), fclose(res);
-            if (S.verbosity > -1){
-                printf("c ===============================================================================\n");
-                printf("c Solved by simplification\n");
-                printStats(S);
-                printf("\n"); }
-            printf("s UNSATISFIABLE\n");
-            if (S.drup_file){
-#ifdef BIN_DRUP
-                fputc('a', S.drup_file); fputc(0, S.drup_file);
-#else
-                fprintf(S.drup_file, "0\n");
-#endif
-            }
-            if (S.drup_file && S.drup_file != stdout) fclose(S.drup_file);
-            exit(20);
-        }
+        S.parsing = true;
+        S.verbosity = verb;
 
-        if (dimacs){
-            if (S.verbosity > 0)
-                printf("c ==============================[ Writing DIMACS ]===============================\n");
-            S.toDimacs((const char*)dimacs);
-            if (S.verbosity > 0)
-                printStats(S);
-            exit(0);
+        S.mWDefault = mWDefault;
+        S.mSDefault = mSDefault;
+        S.prThDefault= prThDefault;
+
+        if (drup || strlen(drup_file)){
+            S.drup_file = strlen(drup_file) ? fopen(drup_file, "wb") : stdout;
+            if (S.drup_file == NULL){
+                S.drup_file = stdout;
+                printf("c Error opening %s for write.\n", (const char*) drup_file); }
+            printf("c DRUP proof generation: %s\n", S.drup_file == stdout ? "stdout" : drup_file);
         }
 
-        vec<Lit> dummy;
-        lbool ret = S.solveLimited(dummy);
-        S.state = ret==l_True ? 1 : (ret==l_False ? 0 : -1);        
+        if (checkpoint){
+            S.checkpoint_file     = checkpoint;
+            S.checkpoint_interval = checkpoint_int;
+            signal(SIGUSR2, SIGUSR2_checkpoint); }
+
+        solver = &S;
+        // Use signal handlers that forcibly quit until the solver will be able to respond to
+        // interrupts:
+        signal(SIGINT, SIGINT_exit);
+        signal(SIGXCPU,SIGINT_exit);
         
-        if (S.verbosity > -1){
-            printStats(S);
-            //printf("\n"); 
-        }
-        //printf(ret == l_True ? "s SATISFIABLE\n" : ret == l_False ? "s UNSATISFIABLE\n" : "s UNKNOWN\n");
-        // if (ret == l_True){
-        //     printf("v ");
-        //     for (int i = 0; i < S.nVars(); i++)
-        //         if (S.model[i] != l_Undef)
-        //             printf("%s%s%d", (i==0)?"":" ", (S.model[i]==l_True)?"":"-", i+1);
-        //     printf(" 0\n");
-        // }
-
-        if (S.drup_file && ret == l_False){
-#ifdef BIN_DRUP
-            fputc('a', S.drup_file); fputc(0, S.drup_file);
-#else
-            fprintf(S.drup_file, "0\n");
-#endif
-        }
-        if (S.drup_file && S.drup_file != stdout) fclose(S.drup_file);
+        if (argc == 1)
+            printf("c Reading from standard input... Use '--help' for help.\n");
 
-        if (res != NULL){
-            if (ret == l_True){
-                fprintf(res, "SAT\n");
-                for (int i = 0; i < S.nVars(); i++)
-                    if (S.model[i] != l_Undef)
-                        fprintf(res, "%s%s%d", (i==0)?"":" ", (S.model[i]==l_True)?"":"-", i+1);
-                fprintf(res, " 0\n");
-            }else if (ret == l_False)
-                fprintf(res, "UNSAT\n");
-            else
-                fprintf(res, "INDET\n");
-            fclose(res);
-        }
+        if (conquer && (cube || cnc))
+            printf("c WARNING! -cube and -cnc are ignored with -conquer.\n");
+        if ((drup || strlen(drup_file)) && (conquer || cnc))
+            printf("c WARNING! No DRUP proof is written for the cubes solved by -conquer and -cnc.\n");
+
+        int ret = solveInstance(S, argc == 1 ? NULL : argv[1], argc >= 3 ? argv[2] : NULL, dimacs, resume, cube, conquer, cnc);
+        if (ret < 0) exit(1);
 
 #ifdef NDEBUG
-        exit(ret == l_True ? 10 : ret == l_False ? 20 : 0);     // (faster than "return", which will invoke the destructor for 'Solver')
+        exit(ret);     // (faster than "return", which will invoke the destructor for 'Solver')
 #else
-        return (ret == l_True ? 10 : ret == l_False ? 20 : 0);
+        return ret;
 #endif
     } catch (OutOfMemoryException&){
         printf("c ===============================================================================\n");
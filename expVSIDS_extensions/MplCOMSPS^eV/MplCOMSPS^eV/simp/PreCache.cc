@@ -0,0 +1,229 @@
+/*************************************************************************************[PreCache.cc]
+Preprocessing cache: the formula left by 'eliminate()' together with its elimination stack, stored
+under a key of the input clauses and the preprocessing options, so that later runs on the same
+input can skip the preprocessing.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+**************************************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+
+#include "core/CheckpointIO.h"
+#include "simp/SimpSolver.h"
+
+using namespace Minisat;
+
+//=================================================================================================
+// File format:
+//
+// A cache entry is the magic "MPRE", a format version, the key and the number of variables
+// (including those added by bounded variable addition), followed by the fields of 'PreState' as
+// in 'transfer()'. Problem clauses are stored as their literals, each clause ended by 'lit_Undef';
+// the search state (activities, learnt clauses) is not stored, so the entry is independent of the
+// search options.
+
+static const char     precache_magic[4] = { 'M', 'P', 'R', 'E' };
+static const uint32_t precache_version  = 2;
+
+namespace {
+
+struct PreState {
+    char            ok;
+    vec<Lit>        units;
+    vec<Lit>        lits;
+    vec<char>       decision;
+    vec<char>       eliminated;
+    vec<char>       auxiliary;
+    vec<uint32_t>   elimclauses;
+    vec<Var>        xors;           // XOR constraints, each ended by 'var_Undef',
+    vec<char>       xor_rhs;        // and their right-hand sides.
+    int             stats[6];       // 'eliminated_vars', 'subst_vars', 'bva_vars', 'bva_removed', 'gate_vars', 'xor_found'.
+};
+
+void transfer(CheckpointIO& io, PreState& st)
+{
+    io.field(st.ok);
+    io.array(st.units);
+    io.array(st.lits);
+    io.array(st.decision);
+    io.array(st.eliminated);
+    io.array(st.auxiliary);
+    io.array(st.elimclauses);
+    io.array(st.xors);
+    io.array(st.xor_rhs);
+    for (int i = 0; i < 6; i++)
+        io.field(st.stats[i]);
+}
+
+inline void hashWord(uint64_t& hash, uint64_t x)
+{
+    for (int b = 0; b < 8; b++, x >>= 8)
+        hash = (hash ^ (x & 0xff)) * 1099511628211ULL;
+}
+
+}
+
+
+//=================================================================================================
+// Reading and writing:
+
+
+// The options that change the result of 'eliminate()' are part of the key. Of the threads of the
+// parallel elimination, only whether there are several matters (see 'eliminateBatches()').
+uint64_t SimpSolver::preprocessKey(uint64_t input_hash) const
+{
+    uint64_t key = input_hash;
+    hashWord(key, precache_version);
+    hashWord(key, nVars());
+    hashWord(key, use_elim);
+    hashWord(key, use_asymm);
+    hashWord(key, use_rcheck);
+    hashWord(key, use_subst);
+    hashWord(key, use_bva);
+    hashWord(key, bva_steps);
+    hashWord(key, use_gates);
+    hashWord(key, use_xor);
+    hashWord(key, xor_size);
+    hashWord(key, grow);
+    hashWord(key, clause_lim);
+    hashWord(key, subsumption_lim);
+    hashWord(key, elim_threads != 1);
+    hashWord(key, elim_batch);
+    return key;
+}
+
+
+bool SimpSolver::writePreprocessed(const char* file, uint64_t key)
+{
+    assert(decisionLevel() == 0 && !use_simplification);
+    PreState st;
+    st.ok = ok;
+    trail.copyTo(st.units);
+    for (int i = 0; i < clauses.size(); i++){
+        const Clause& c = ca[clauses[i]];
+        if (c.mark() == 1 || satisfied(c)) continue;
+        for (int j = 0; j < c.size(); j++)
+            if (value(c[j]) != l_False)
+                st.lits.push(c[j]);
+        st.lits.push(lit_Undef); }
+    decision   .copyTo(st.decision);
+    eliminated .copyTo(st.eliminated);
+    auxiliary  .copyTo(st.auxiliary);
+    elimclauses.copyTo(st.elimclauses);
+    xors       .copyTo(st.xors);
+    xor_rhs.copyTo(st.xor_rhs);
+    int stats[6] = { eliminated_vars, subst_vars, bva_vars, bva_removed, gate_vars, xor_found };
+    memcpy(st.stats, stats, sizeof(stats));
+
+    FILE* f = fopen(file, "wb");
+    if (f == NULL) return false;
+    CheckpointIO io(f, true);
+    uint32_t     version = precache_version;
+    int          vars    = nVars();
+    io.bytes((void*)precache_magic, sizeof(precache_magic));
+    io.field(version);
+    io.field(key);
+    io.field(vars);
+    transfer(io, st);
+
+    return fclose(f) == 0 && io.ok;
+}
+
+
+// Must be called after parsing, in place of 'eliminate()'. Returns FALSE (leaving the parsed
+// formula alone) if 'file' is not an entry for 'key'.
+bool SimpSolver::readPreprocessed(const char* file, uint64_t key)
+{
+    assert(decisionLevel() == 0);
+    if (!use_simplification) return false;
+    FILE* f = fopen(file, "rb");
+    if (f == NULL) return false;
+
+    CheckpointIO io(f, false);
+    PreState     st;
+    char         magic[4];
+    uint32_t     version;
+    uint64_t     file_key;
+    int          vars;
+    io.bytes(magic, sizeof(magic));
+    io.field(version);
+    io.field(file_key);
+    io.field(vars);
+    if (io.ok && memcmp(magic, precache_magic, sizeof(magic)) == 0 && version == precache_version && file_key == key && vars >= nVars())
+        transfer(io, st);
+    else
+        io.ok = false;
+    fclose(f);
+    if (!io.ok || st.decision.size() != vars || st.eliminated.size() != vars || st.auxiliary.size() != vars)
+        return false;
+    int n_xors = 0;
+    for (int i = 0; i < st.xors.size(); i++)
+        if (st.xors[i] == var_Undef) n_xors++;
+        else if (st.xors[i] < 0 || st.xors[i] >= vars) return false;
+    if (n_xors != st.xor_rhs.size() || (st.xors.size() > 0 && st.xors.last() != var_Undef))
+        return false;
+
+    // Drop the parsed formula:
+    for (int i = 0; i < clauses.size(); i++)
+        Solver::removeClause(clauses[i]);
+    clauses.clear();
+    for (int i = 0; i < trail.size(); i++)
+        assigns[var(trail[i])] = l_Undef;
+    trail.clear();
+    qhead = 0;
+
+    // Install the preprocessed one:
+    while (nVars() < vars)
+        newVar();
+    for (Var v = 0; v < vars; v++){
+        setDecisionVar(v, st.decision[v]);
+        eliminated[v] = st.eliminated[v];
+        setAuxiliary(v, st.auxiliary[v]); }
+    st.elimclauses.moveTo(elimclauses);
+    xors.clear();
+    xor_rhs.clear();
+    vec<Var> vs;
+    for (int i = 0, k = 0; i < st.xors.size(); i++)
+        if (st.xors[i] == var_Undef){
+            addXor(vs, st.xor_rhs[k++]);
+            vs.clear();
+        }else
+            vs.push(st.xors[i]);
+    gauss_dirty = xors.size() > 0;
+    eliminated_vars = st.stats[0]; subst_vars  = st.stats[1]; bva_vars  = st.stats[2];
+    bva_removed     = st.stats[3]; gate_vars   = st.stats[4]; xor_found = st.stats[5];
+
+    ok = st.ok;
+    for (int i = 0; i < st.units.size() && ok; i++)
+        if (value(st.units[i]) == l_Undef)
+            uncheckedEnqueue(st.units[i]);
+        else if (value(st.units[i]) == l_False)
+            ok = false;
+    vec<Lit> lits;
+    for (int i = 0; i < st.lits.size() && ok; i++)
+        if (st.lits[i] == lit_Undef){
+            Solver::addClause_(lits);
+            lits.clear();
+        }else
+            lits.push(st.lits[i]);
+    if (ok && propagate() != CRef_Undef)
+        ok = false;
+
+    touched.clear(true);
+    stopSimplification();
+    return true;
+}
@@ -20,6 +20,8 @@ DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
 OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 **************************************************************************************************/
 
+#include <pthread.h>
+
 #include "mtl/Sort.h"
 #include "simp/SimpSolver.h"
 #include "utils/System.h"
@@ -38,6 +40,16 @@ static BoolOption   opt_use_elim         (_cat, "elim",         "Perform variabl
 static IntOption    opt_grow             (_cat, "grow",         "Allow a variable elimination step to grow by a number of clauses.", 0);
 static IntOption    opt_clause_lim       (_cat, "cl-lim",       "Variables are not eliminated if it produces a resolvent with a length above this limit. -1 means no limit", 20,   IntRange(-1, INT32_MAX));
 static IntOption    opt_subsumption_lim  (_cat, "sub-lim",      "Do not check if subsumption against a clause larger than this. -1 means no limit.", 1000, IntRange(-1, INT32_MAX));
+static IntOption    opt_elim_threads     (_cat, "elim-threads", "Threads resolving independent variables during elimination (1 = sequential, 0 = one per processor).", 1, IntRange(0, 1024));
+static IntOption    opt_elim_batch       (_cat, "elim-batch",   "Candidates selected per round of parallel elimination.", 2048, IntRange(1, INT32_MAX));
+static BoolOption   opt_use_subst        (_cat, "subst",        "Substitute equivalent literals found as cycles of binary clauses.", true);
+static BoolOption   opt_use_bva          (_cat, "bva",          "Re-encode clauses with a common structure (e.g. at-most-one constraints) by auxiliary variables.", true);
+static IntOption    opt_bva_steps        (_cat, "bva-steps",    "Clause visits allowed for bounded variable addition.", 20000000, IntRange(0, INT32_MAX));
+static BoolOption   opt_use_gates        (_cat, "gates",        "Eliminate variables defined by an AND or if-then-else gate by the resolvents with the gate clauses only.", true);
+static BoolOption   opt_use_xor          (_cat, "xor",          "Find XOR constraints encoded by the clauses, for Gauss-Jordan elimination in the search.", true);
+static IntOption    opt_xor_size         (_cat, "xor-size",     "Largest XOR constraint looked for.", 5, IntRange(3, 8));
+static IntOption    opt_inproc_interval  (_cat, "inproc-int",   "Conflicts before the first round of inprocessing, and by which the interval grows (0 = off).", 30000, IntRange(0, INT32_MAX));
+static DoubleOption opt_inproc_frac      (_cat, "inproc-frac",  "Share of the CPU time since the previous round that a round of inprocessing may take.", 0.1, DoubleRange(0, false, 1, true));
 static DoubleOption opt_simp_garbage_frac(_cat, "simp-gc-frac", "The fraction of wasted memory allowed before a garbage collection is triggered during simplification.",  0.5, DoubleRange(0, false, HUGE_VAL, false));
 
 
@@ -54,15 +66,45 @@ SimpSolver::SimpSolver() :
   , use_asymm          (opt_use_asymm)
   , use_rcheck         (opt_use_rcheck)
   , use_elim           (opt_use_elim)
+  , elim_threads       (opt_elim_threads)
+  , elim_batch         (opt_elim_batch)
+  , use_subst          (opt_use_subst)
+  , use_bva            (opt_use_bva)
+  , bva_steps          (opt_bva_steps)
+  , use_gates          (opt_use_gates)
+  , use_xor            (opt_use_xor)
+  , xor_size           (opt_xor_size)
+  , inproc_interval    (opt_inproc_interval)
+  , inproc_frac        (opt_inproc_frac)
   , merges             (0)
   , asymm_lits         (0)
   , eliminated_vars    (0)
+  , subst_vars         (0)
+  , bva_vars           (0)
+  , bva_removed        (0)
+  , gate_vars          (0)
+  , xor_found          (0)
+  , elim_rounds        (0)
+  , elim_time          (0)
+  , subsumption_checks (0)
+  , subsumption_time   (0)
+  , inproc_rounds      (0)
+  , inproc_time        (0)
+  , inproc_vars        (0)
+  , inproc_removed     (0)
   , elimorder          (1)
   , use_simplification (true)
   , occurs             (ClauseDeleted(ca))
   , elim_heap          (ElimLt(n_occ))
   , bwdsub_assigns     (0)
   , n_touched          (0)
+  , inproc_allowed     (false)
+  , next_inprocess     (inproc_interval)
+  , inproc_last        (0)
+  , simp_deadline      (0)
+  , drup_units         (0)
+  , occurs_deferred    (false)
+  , bva_budget         (0)
 {
     vec<Lit> dummy(1,lit_Undef);
     ca.extra_clause_field = true; // NOTE: must happen before allocating the dummy clause below.
@@ -98,7 +140,8 @@ lbool SimpSolver::solve_(bool do_simp, bool turn_off_simp)
     vec<Var> extra_frozen;
     lbool    result = l_True;
 
-    do_simp &= use_simplification;
+    inproc_allowed = do_simp && inproc_interval > 0;
+    do_simp       &= use_simplification;
 
     if (do_simp){
         // Assumptions must be temporarily frozen to run variable elimination:
@@ -124,6 +167,7 @@ lbool SimpSolver::solve_(bool do_simp, bool turn_off_simp)
 
     if (result == l_True)
         extendModel();
+    inproc_allowed = false;
 
     if (do_simp)
         // Unfreeze the assumptions that were frozen:
@@ -172,13 +216,15 @@ bool SimpSolver::addClause_(vec<Lit>& ps)
         // forward subsumption.
         subsumption_queue.insert(cr);
         for (int i = 0; i < c.size(); i++){
-            occurs[var(c[i])].push(cr);
+            if (!parsing) occurs.push(var(c[i]), cr);
             n_occ[toInt(c[i])]++;
             touched[var(c[i])] = 1;
             n_touched++;
             if (elim_heap.inHeap(var(c[i])))
                 elim_heap.increase(var(c[i]));
         }
+        // The occurrences of the parsed clauses are laid out at once by 'buildOccurs()':
+        occurs_deferred |= parsing;
     }
 
     return true;
@@ -238,7 +284,7 @@ bool SimpSolver::strengthenClause(CRef cr, Lit l)
         detachClause(cr, true);
         c.strengthen(l);
         attachClause(cr);
-        remove(occurs[var(l)], cr);
+        occurs.remove(var(l), cr);
         n_occ[toInt(l)]--;
         updateElimHeap(var(l));
     }
@@ -248,9 +294,8 @@ bool SimpSolver::strengthenClause(CRef cr, Lit l)
 
 
 // Returns FALSE if clause is always satisfied ('out_clause' should not be used).
-bool SimpSolver::merge(const Clause& _ps, const Clause& _qs, Var v, vec<Lit>& out_clause)
+static bool resolve(const Clause& _ps, const Clause& _qs, Var v, vec<Lit>& out_clause)
 {
-    merges++;
     out_clause.clear();
 
     bool  ps_smallest = _ps.size() < _qs.size();
@@ -279,10 +324,8 @@ bool SimpSolver::merge(const Clause& _ps, const Clause& _qs, Var v, vec<Lit>& ou
 
 
 // Returns FALSE if clause is always satisfied.
-bool SimpSolver::merge(const Clause& _ps, const Clause& _qs, Var v, int& size)
+static bool resolve(const Clause& _ps, const Clause& _qs, Var v, int& size)
 {
-    merges++;
-
     bool  ps_smallest = _ps.size() < _qs.size();
     const Clause& ps  =  ps_smallest ? _qs : _ps;
     const Clause& qs  =  ps_smallest ? _ps : _qs;
@@ -308,6 +351,20 @@ bool SimpSolver::merge(const Clause& _ps, const Clause& _qs, Var v, int& size)
 }
 
 
+bool SimpSolver::merge(const Clause& _ps, const Clause& _qs, Var v, vec<Lit>& out_clause)
+{
+    merges++;
+    return resolve(_ps, _qs, v, out_clause);
+}
+
+
+bool SimpSolver::merge(const Clause& _ps, const Clause& _qs, Var v, int& size)
+{
+    merges++;
+    return resolve(_ps, _qs, v, size);
+}
+
+
 void SimpSolver::gatherTouchedClauses()
 {
     if (n_touched == 0) return;
@@ -319,7 +376,7 @@ void SimpSolver::gatherTouchedClauses()
 
     for (i = 0; i < touched.size(); i++)
         if (touched[i]){
-            const vec<CRef>& cs = occurs.lookup(i);
+            OccList cs = occurs.lookup(i);
             for (j = 0; j < cs.size(); j++)
                 if (ca[cs[j]].mark() == 0){
                     subsumption_queue.insert(cs[j]);
@@ -360,8 +417,10 @@ bool SimpSolver::implied(const vec<Lit>& c)
 bool SimpSolver::backwardSubsumptionCheck(bool verbose)
 {
     int cnt = 0;
+    int polls = 0;
     int subsumed = 0;
     int deleted_literals = 0;
+    double start = cpuTime();
     assert(decisionLevel() == 0);
 
     while (subsumption_queue.size() > 0 || bwdsub_assigns < trail.size()){
@@ -372,6 +431,10 @@ bool SimpSolver::backwardSubsumptionCheck(bool verbose)
             bwdsub_assigns = trail.size();
             break; }
 
+        // Leave the rest of the queue to the caller when a round of inprocessing runs out of time:
+        if ((++polls & 63) == 0 && outOfTime())
+            break;
+
         // Check top-level assignments by creating a dummy clause and placing it in the queue:
         if (subsumption_queue.size() == 0 && bwdsub_assigns < trail.size()){
             Lit l = trail[bwdsub_assigns++];
@@ -392,11 +455,11 @@ bool SimpSolver::backwardSubsumptionCheck(bool verbose)
         // Find best variable to scan:
         Var best = var(c[0]);
         for (int i = 1; i < c.size(); i++)
-            if (occurs[var(c[i])].size() < occurs[best].size())
+            if (occurs.size(var(c[i])) < occurs.size(best))
                 best = var(c[i]);
 
         // Search all candidates:
-        vec<CRef>& _cs = occurs.lookup(best);
+        OccList     _cs = occurs.lookup(best);
         CRef*       cs = (CRef*)_cs;
 
         for (int j = 0; j < _cs.size(); j++)
@@ -404,14 +467,16 @@ bool SimpSolver::backwardSubsumptionCheck(bool verbose)
                 break;
             else if (!ca[cs[j]].mark() &&  cs[j] != cr && (subsumption_lim == -1 || ca[cs[j]].size() < subsumption_lim)){
                 Lit l = c.subsumes(ca[cs[j]]);
+                subsumption_checks++;
 
                 if (l == lit_Undef)
                     subsumed++, removeClause(cs[j]);
                 else if (l != lit_Error){
                     deleted_literals++;
 
-                    if (!strengthenClause(cs[j], ~l))
-                        return false;
+                    if (!strengthenClause(cs[j], ~l)){
+                        subsumption_time += cpuTime() - start;
+                        return false; }
 
                     // Did current candidate get deleted from cs? Then check candidate at index j again:
                     if (var(l) == best)
@@ -420,6 +485,7 @@ bool SimpSolver::backwardSubsumptionCheck(bool verbose)
             }
     }
 
+    subsumption_time += cpuTime() - start;
     return true;
 }
 
@@ -456,7 +522,7 @@ bool SimpSolver::asymmVar(Var v)
 {
     assert(use_simplification);
 
-    const vec<CRef>& cls = occurs.lookup(v);
+    OccList cls = occurs.lookup(v);
 
     if (value(v) != l_Undef || cls.size() == 0)
         return true;
@@ -510,11 +576,15 @@ bool SimpSolver::eliminateVar(Var v)
 
     // Split the occurrences into positive and negative:
     //
-    const vec<CRef>& cls = occurs.lookup(v);
+    OccList          cls = occurs.lookup(v);
     vec<CRef>        pos, neg;
     for (int i = 0; i < cls.size(); i++)
         (find(ca[cls[i]], mkLit(v)) ? pos : neg).push(cls[i]);
 
+    // With a gate, only the resolvents of a gate with a non-gate clause are needed:
+    vec<char> gate_pos, gate_neg;
+    bool      gate = use_gates && findGate(v, pos, neg, gate_pos, gate_neg);
+
     // Check wether the increase in number of clauses stays within the allowed ('grow'). Moreover, no
     // clause must exceed the limit on the maximal clause size (if it is set):
     //
@@ -523,11 +593,29 @@ bool SimpSolver::eliminateVar(Var v)
 
     for (int i = 0; i < pos.size(); i++)
         for (int j = 0; j < neg.size(); j++)
-            if (merge(ca[pos[i]], ca[neg[j]], v, clause_size) && 
+            if (!(gate && gate_pos[i] == gate_neg[j]) && merge(ca[pos[i]], ca[neg[j]], v, clause_size) && 
                 (++cnt > cls.size() + grow || (clause_lim != -1 && clause_size > clause_lim)))
                 return true;
 
     // Delete and store old clauses:
+    storeElimClauses(v, pos, neg);
+    if (gate) gate_vars++;
+
+    // Produce clauses in cross product:
+    vec<Lit>& resolvent = add_tmp;
+    for (int i = 0; i < pos.size(); i++)
+        for (int j = 0; j < neg.size(); j++)
+            if (!(gate && gate_pos[i] == gate_neg[j]) && merge(ca[pos[i]], ca[neg[j]], v, resolvent) && !addClause_(resolvent))
+                return false;
+
+    removeElimClauses(v);
+
+    return backwardSubsumptionCheck();
+}
+
+
+void SimpSolver::storeElimClauses(Var v, const vec<CRef>& pos, const vec<CRef>& neg)
+{
     eliminated[v] = true;
     setDecisionVar(v, false);
     eliminated_vars++;
@@ -541,27 +629,192 @@ bool SimpSolver::eliminateVar(Var v)
             mkElimClause(elimclauses, v, ca[pos[i]]);
         mkElimClause(elimclauses, ~mkLit(v));
     }
+}
 
-    // Produce clauses in cross product:
-    vec<Lit>& resolvent = add_tmp;
-    for (int i = 0; i < pos.size(); i++)
-        for (int j = 0; j < neg.size(); j++)
-            if (merge(ca[pos[i]], ca[neg[j]], v, resolvent) && !addClause_(resolvent))
-                return false;
 
+void SimpSolver::removeElimClauses(Var v)
+{
+    OccList cls = occurs.lookup(v);
     for (int i = 0; i < cls.size(); i++)
         removeClause(cls[i]); 
 
     // Free occurs list for this variable:
-    occurs[v].clear(true);
+    occurs.clear(v);
     
     // Free watchers lists for this variable, if possible:
     watches_bin[ mkLit(v)].clear(true);
     watches_bin[~mkLit(v)].clear(true);
     watches[ mkLit(v)].clear(true);
     watches[~mkLit(v)].clear(true);
+}
 
-    return backwardSubsumptionCheck();
+
+//=================================================================================================
+// Parallel elimination:
+//
+// Each round takes the cheapest candidates off 'elim_heap', skipping (and putting back after the
+// round) any candidate whose clauses share a variable with those of a candidate already taken,
+// until 'elim_batch' are taken or as many were skipped as taken. The occurrences of the selected
+// variables are then disjoint, and so are their resolvents: the threads check the bounds and
+// produce the resolvents of different variables from the clause database, read only. The
+// eliminations are then carried out in the order of selection, and backward subsumption runs once
+// per round. Neither the selection nor the order depend on the threads, so the result (and
+// 'elimclauses') is the same for any number of them.
+
+
+struct SimpSolver::ElimTask {
+    Var       v;
+    bool      eliminate;   // Within 'grow' and 'clause_lim': 'resolvents' holds the non-tautological ones.
+    bool      gate;        // Defined by the clauses flagged in 'gate_pos' and 'gate_neg'.
+    int       merges;
+    vec<CRef> pos, neg;
+    vec<char> gate_pos, gate_neg;
+    vec<Lit>  resolvents;  // One after the other, 'sizes' literals each.
+    vec<int>  sizes;
+};
+
+struct SimpSolver::ElimBatch {
+    SimpSolver*     solver;
+    vec<ElimTask*>* tasks;
+    volatile int    next;  // Index of the next task to hand out.
+};
+
+
+void* SimpSolver::elimThread(void* arg)
+{
+    ElimBatch& b = *(ElimBatch*)arg;
+    for (int i; (i = __sync_fetch_and_add(&b.next, 1)) < b.tasks->size();)
+        b.solver->resolveVar(*(*b.tasks)[i]);
+    return NULL;
+}
+
+
+// The first half of 'eliminateVar()', from several threads: reads 'ca' and 'occurs' (cleaned at
+// selection) only.
+void SimpSolver::resolveVar(ElimTask& t)
+{
+    OccList cls = occurs[t.v];
+    for (int i = 0; i < cls.size(); i++)
+        (find(ca[cls[i]], mkLit(t.v)) ? t.pos : t.neg).push(cls[i]);
+
+    int cnt         = 0;
+    int clause_size = 0;
+    t.eliminate     = false;
+    t.merges        = 0;
+    t.gate          = use_gates && findGate(t.v, t.pos, t.neg, t.gate_pos, t.gate_neg);
+    for (int i = 0; i < t.pos.size(); i++)
+        for (int j = 0; j < t.neg.size(); j++){
+            if (t.gate && t.gate_pos[i] == t.gate_neg[j]) continue;
+            t.merges++;
+            if (resolve(ca[t.pos[i]], ca[t.neg[j]], t.v, clause_size) && 
+                (++cnt > cls.size() + grow || (clause_lim != -1 && clause_size > clause_lim)))
+                return; }
+
+    vec<Lit> resolvent;
+    for (int i = 0; i < t.pos.size(); i++)
+        for (int j = 0; j < t.neg.size(); j++){
+            if (t.gate && t.gate_pos[i] == t.gate_neg[j]) continue;
+            t.merges++;
+            if (resolve(ca[t.pos[i]], ca[t.neg[j]], t.v, resolvent)){
+                for (int k = 0; k < resolvent.size(); k++)
+                    t.resolvents.push(resolvent[k]);
+                t.sizes.push(resolvent.size()); } }
+    t.eliminate = true;
+}
+
+
+bool SimpSolver::eliminateBatches()
+{
+    double start   = realTime();
+    int    threads = elim_threads;
+    if (threads == 0){
+        long procs = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = procs > 0 ? (int)procs : 1; }
+
+    vec<char>     locked(nVars(), 0);
+    vec<Var>      locked_vars, deferred;
+    vec<ElimTask*> tasks;  // (pointers: 'vec' grows by realloc(), which must not move the vectors of a task)
+    pthread_t*    ids = new pthread_t[threads];
+    bool          res = true;
+
+    while (res && !elim_heap.empty() && !asynch_interrupt){
+        // Select:
+        while (!elim_heap.empty() && tasks.size() < elim_batch && deferred.size() <= tasks.size()){
+            Var v = elim_heap.removeMin();
+            if (isEliminated(v) || value(v) != l_Undef || frozen[v]) continue;
+
+            OccList          cls = occurs.lookup(v);
+            bool             independent = true;
+            for (int i = 0; i < cls.size() && independent; i++){
+                const Clause& c = ca[cls[i]];
+                for (int j = 0; j < c.size() && independent; j++)
+                    independent = !locked[var(c[j])]; }
+            if (!independent){
+                deferred.push(v);
+                continue; }
+
+            for (int i = 0; i < cls.size(); i++){
+                const Clause& c = ca[cls[i]];
+                for (int j = 0; j < c.size(); j++)
+                    if (!locked[var(c[j])]){
+                        locked[var(c[j])] = 1;
+                        locked_vars.push(var(c[j])); } }
+            tasks.push(new ElimTask());
+            tasks.last()->v = v;
+        }
+
+        // Resolve (this thread takes part):
+        ElimBatch batch;
+        batch.solver = this;
+        batch.tasks  = &tasks;
+        batch.next   = 0;
+        int started = 0;
+        for (; started < threads - 1 && started < tasks.size() - 1; started++)
+            if (pthread_create(&ids[started], NULL, elimThread, &batch) != 0) break;
+        elimThread(&batch);
+        for (int t = 0; t < started; t++)
+            pthread_join(ids[t], NULL);
+
+        // Eliminate, in the order of selection:
+        for (int k = 0; k < tasks.size() && res; k++){
+            ElimTask& t = *tasks[k];
+            merges += t.merges;
+            // A unit resolvent of an earlier variable may have assigned this one:
+            if (!t.eliminate || value(t.v) != l_Undef) continue;
+
+            storeElimClauses(t.v, t.pos, t.neg);
+            if (t.gate) gate_vars++;
+            for (int i = 0, offset = 0; i < t.sizes.size() && res; offset += t.sizes[i++]){
+                add_tmp.clear();
+                for (int j = 0; j < t.sizes[i]; j++)
+                    add_tmp.push(t.resolvents[offset + j]);
+                res = addClause_(add_tmp); }
+            if (res)
+                removeElimClauses(t.v);
+        }
+
+        for (int k = 0; k < tasks.size(); k++)
+            delete tasks[k];
+        tasks.clear();
+        for (int i = 0; i < locked_vars.size(); i++)
+            locked[locked_vars[i]] = 0;
+        locked_vars.clear();
+        for (int i = 0; i < deferred.size(); i++)
+            updateElimHeap(deferred[i]);
+        deferred.clear();
+        elim_rounds++;
+
+        if (res)
+            res = backwardSubsumptionCheck();
+        checkGarbage(simp_garbage_frac);
+
+        if (verbosity >= 2)
+            printf("c elimination left: %10d\r", elim_heap.size());
+    }
+
+    delete [] ids;
+    elim_time += realTime() - start;
+    return res;
 }
 
 
@@ -572,11 +825,17 @@ bool SimpSolver::substitute(Var v, Lit x)
     assert(value(v) == l_Undef);
 
     if (!ok) return false;
+    if (occurs_deferred) buildOccurs();
 
     eliminated[v] = true;
     setDecisionVar(v, false);
-    const vec<CRef>& cls = occurs.lookup(v);
-    
+
+    // A copy, as adding the substituted clauses moves the occurrence lists:
+    vec<CRef> cls;
+    OccList   occ = occurs.lookup(v);
+    for (int i = 0; i < occ.size(); i++)
+        cls.push(occ[i]);
+
     vec<Lit>& subst_clause = add_tmp;
     for (int i = 0; i < cls.size(); i++){
         Clause& c = ca[cls[i]];
@@ -597,6 +856,247 @@ bool SimpSolver::substitute(Var v, Lit x)
 }
 
 
+//=================================================================================================
+// Equivalent literal substitution:
+//
+// Literals on a cycle of binary clauses (a strongly connected component of the binary implication
+// graph) are equivalent. Each component is replaced by one representative literal throughout the
+// problem and learnt clauses; the other variables are removed like eliminated ones, storing the
+// two binary clauses that define them for 'extendModel()'.
+
+
+// Maps every unassigned literal to the representative of its component ('lit_Undef' for assigned
+// and eliminated ones), with an iterative Tarjan over the edges p -> q of the binary clauses
+// {~p, q} in 'watches_bin'. The representative is the literal of the smallest variable, frozen
+// variables first. Returns FALSE if a literal is equivalent to its negation.
+bool SimpSolver::findEquivalences(vec<Lit>& rep)
+{
+    int            n = 2 * nVars();
+    int            counter = 0;
+    vec<int>       index(n, -1);
+    vec<int>       low  (n, 0);
+    vec<char>      on_stack(n, 0);
+    vec<char>      in_comp (nVars(), 0);
+    vec<int>       stack;
+    vec<SccFrame>  dfs;
+
+    rep.clear();
+    rep.growTo(n, lit_Undef);
+    watches_bin.cleanAll();
+
+    for (int root = 0; root < n; root++){
+        if (index[root] != -1 || value(toLit(root)) != l_Undef || isEliminated(var(toLit(root))))
+            continue;
+
+        SccFrame f = { root, 0 };
+        dfs.push(f);
+        index[root] = low[root] = counter++;
+        stack.push(root);
+        on_stack[root] = 1;
+
+        while (dfs.size() > 0){
+            int            u  = dfs.last().lit;
+            vec<Watcher>&  ws = watches_bin[toLit(u)];
+
+            if (dfs.last().next < ws.size()){
+                Lit q = ws[dfs.last().next++].blocker;
+                int w = toInt(q);
+                if (value(q) != l_Undef || isEliminated(var(q)))
+                    continue;
+                if (index[w] == -1){
+                    SccFrame g = { w, 0 };
+                    dfs.push(g);
+                    index[w] = low[w] = counter++;
+                    stack.push(w);
+                    on_stack[w] = 1;
+                }else if (on_stack[w] && index[w] < low[u])
+                    low[u] = index[w];
+                continue; }
+
+            dfs.pop();
+            if (dfs.size() > 0 && low[u] < low[dfs.last().lit])
+                low[dfs.last().lit] = low[u];
+            if (low[u] != index[u])
+                continue;
+
+            // 'u' is the root of a component: it is on the stack from 'u' upwards.
+            int first = stack.size() - 1;
+            while (stack[first] != u) first--;
+
+            Lit r = lit_Undef;
+            for (int i = first; i < stack.size(); i++){
+                Lit p = toLit(stack[i]);
+                if (in_comp[var(p)]){
+                    // 'p' and '~p' are on the same cycle, so '~p' can be derived (by propagating 'p'):
+                    if (drup_file){
+                        vec<Lit> unit; unit.push(~p);
+#ifdef BIN_DRUP
+                        binDRUP('a', unit, drup_file);
+#else
+                        fprintf(drup_file, "%i 0\n", (var(~p) + 1) * (-2 * sign(~p) + 1));
+#endif
+                    }
+                    return false; }
+                in_comp[var(p)] = 1;
+                if (r == lit_Undef || frozen[var(p)] > frozen[var(r)] || (frozen[var(p)] == frozen[var(r)] && var(p) < var(r)))
+                    r = p;
+            }
+
+            // The mirrored component {~p} has the negated representative, if it was found first:
+            Lit mirror = rep[toInt(~toLit(u))];
+            for (int i = first; i < stack.size(); i++){
+                Lit p = toLit(stack[i]);
+                rep[stack[i]]   = mirror != lit_Undef ? ~rep[toInt(~p)] : r;
+                on_stack[stack[i]] = 0;
+                in_comp[var(p)] = 0;
+            }
+            stack.shrink(stack.size() - first);
+        }
+    }
+
+    return true;
+}
+
+
+// Copies 'c' into 'out' with every literal replaced by its representative, sorted, without
+// duplicates and false literals. Returns FALSE if the result is satisfied or a tautology.
+bool SimpSolver::substituted(const Clause& c, const vec<Lit>& rep, vec<Lit>& out) const
+{
+    out.clear();
+    for (int i = 0; i < c.size(); i++)
+        out.push(rep[toInt(c[i])] == lit_Undef ? c[i] : rep[toInt(c[i])]);
+    sort(out);
+
+    Lit p; int i, j;
+    for (i = j = 0, p = lit_Undef; i < out.size(); i++)
+        if (value(out[i]) == l_True || out[i] == ~p)
+            return false;
+        else if (value(out[i]) != l_False && out[i] != p)
+            out[j++] = p = out[i];
+    out.shrink(i - j);
+    return true;
+}
+
+
+// Adds the substituted copy of every clause of 'cs' (with mark 'valid_mark') that changes, keeping
+// its tier and statistics, and stores the originals in 'old' to be removed afterwards.
+bool SimpSolver::substituteLearnts(vec<CRef>& cs, unsigned valid_mark, const vec<Lit>& rep, vec<CRef>& old)
+{
+    vec<Lit> lits;
+    int      n = cs.size();
+
+    for (int i = 0; i < n; i++){
+        Clause& c = ca[cs[i]];
+        int     k;
+        if (c.mark() != valid_mark) continue;
+        for (k = 0; k < c.size() && (rep[toInt(c[k])] == lit_Undef || rep[toInt(c[k])] == c[k]); k++);
+        if (k == c.size()) continue;
+
+        old.push(cs[i]);
+        if (!substituted(c, rep, lits))
+            continue;
+
+        if (drup_file){
+#ifdef BIN_DRUP
+            binDRUP('a', lits, drup_file);
+#else
+            for (int j = 0; j < lits.size(); j++)
+                fprintf(drup_file, "%i ", (var(lits[j]) + 1) * (-2 * sign(lits[j]) + 1));
+            fprintf(drup_file, "0\n");
+#endif
+        }
+
+        if (lits.size() == 0)
+            return false;
+        else if (lits.size() == 1)
+            uncheckedEnqueue(lits[0]);
+        else{
+            CRef cr = ca.alloc(lits, true);
+            Clause& d = ca[cr];
+            Clause& e = ca[cs[i]];    // (the allocation may have moved the arena)
+            d.mark(e.mark());
+            d.set_lbd(e.lbd() < lits.size() ? e.lbd() : lits.size());
+            d.activity() = e.activity();
+            d.touched()  = e.touched();
+            d.removable(e.removable());
+            attachClause(cr);
+            cs.push(cr); }
+    }
+
+    return true;
+}
+
+
+static void purgeDeleted(vec<CRef>& cs, const ClauseAllocator& ca)
+{
+    int i, j;
+    for (i = j = 0; i < cs.size(); i++)
+        if (ca[cs[i]].mark() != 1)
+            cs[j++] = cs[i];
+    cs.shrink(i - j);
+}
+
+
+bool SimpSolver::substituteEquivalences()
+{
+    vec<Lit> rep;
+    if (!findEquivalences(rep))
+        return ok = false;
+
+    // Keep frozen variables (they are only chosen as representative if no other one is frozen):
+    int n = 0;
+    for (Var v = 0; v < nVars(); v++){
+        Lit p = mkLit(v);
+        if (rep[toInt(p)] == lit_Undef || var(rep[toInt(p)]) == v || frozen[v])
+            rep[toInt(p)] = p, rep[toInt(~p)] = ~p;
+        else
+            n++; }
+    if (n == 0) return true;
+
+    // Add all substituted clauses first, so that the binary clauses that make each of them a RUP
+    // consequence are still there, then remove the originals:
+    vec<CRef> old, old_learnts;
+    vec<Lit>  lits;
+    for (int i = 0; i < clauses.size(); i++){
+        const Clause& c = ca[clauses[i]];
+        if (c.mark()) continue;
+        for (int k = 0; k < c.size(); k++)
+            if (rep[toInt(c[k])] != c[k]){ old.push(clauses[i]); break; } }
+
+    for (int i = 0; i < old.size(); i++)
+        if (substituted(ca[old[i]], rep, lits) && !addClause_(lits))
+            return ok = false;
+
+    if (!substituteLearnts(learnts_core,  CORE,  rep, old_learnts) ||
+        !substituteLearnts(learnts_tier2, TIER2, rep, old_learnts) ||
+        !substituteLearnts(learnts_local, LOCAL, rep, old_learnts))
+        return ok = false;
+
+    for (Var v = 0; v < nVars(); v++){
+        Lit x = rep[toInt(mkLit(v))];
+        if (var(x) == v) continue;
+
+        // 'v' takes the value of 'x' in the model: store {v, ~x} and {~v, x}.
+        eliminated[v] = true;
+        setDecisionVar(v, false);
+        subst_vars++;
+        elimclauses.push(toInt(mkLit(v)));  elimclauses.push(toInt(~x)); elimclauses.push(2);
+        elimclauses.push(toInt(~mkLit(v))); elimclauses.push(toInt(x));  elimclauses.push(2);
+    }
+
+    for (int i = 0; i < old.size(); i++)
+        if (!ca[old[i]].mark())
+            removeClause(old[i]);
+    for (int i = 0; i < old_learnts.size(); i++)
+        Solver::removeClause(old_learnts[i]);
+    purgeDeleted(learnts_core,  ca);
+    purgeDeleted(learnts_tier2, ca);
+    purgeDeleted(learnts_local, ca);
+
+    return ok = propagate() == CRef_Undef;
+}
+
+
 void SimpSolver::extendModel()
 {
     int i, j;
@@ -611,6 +1111,13 @@ void SimpSolver::extendModel()
         model[var(x)] = lbool(!sign(x));
     next:;
     }
+
+    // Auxiliary variables are not part of the problem:
+    for (Var v = 0; v < model.size(); v++)
+        if (isAuxiliary(v))
+            model[v] = l_Undef;
+    while (model.size() > 0 && model.last() == l_Undef && isAuxiliary(model.size()-1))
+        model.pop();
 }
 
 // Almost duplicate of Solver::removeSatisfied. Didn't want to make the base method 'virtual'.
@@ -645,6 +1152,11 @@ bool SimpSolver::eliminate(bool turn_off_elim)
     res = eliminate_(); // The first, usual variable elimination of MiniSat.
     if (!res) goto cleanup;
 
+    if (use_bva && !addBvaVariables()){
+        res = false; goto cleanup; }
+    if (verbosity >= 1 && bva_vars > 0)
+        printf("c |  BVA variables:          %10d  (%10d clauses saved)             |\n", bva_vars, bva_removed);
+
     n_cls  = nClauses();
     n_vars = nFreeVars();
 
@@ -686,8 +1198,27 @@ bool SimpSolver::eliminate(bool turn_off_elim)
     //printf("c No. effective iterative eliminations: %d\n", iter);
 
 cleanup:
-    touched  .clear(true);
+    if (res && use_xor && use_simplification)
+        extractXors();
+    if (verbosity >= 1 && (gate_vars > 0 || xor_found > 0))
+        printf("c |  Gate eliminations:      %10d  (%10d XOR constraints)           |\n", gate_vars, xor_found);
+    touched.clear(true);
+    stopSimplification();
+
+#ifdef BIN_DRUP
+    // The caller appends the empty clause after the lemmas of the simplification:
+    if (!res && drup_file) binDRUP_flush(drup_file);
+#endif
+
+    return res;
+}
+
+
+// Drops the occurrence lists and the extra clause fields, and hands the clauses back to the search.
+void SimpSolver::stopSimplification()
+{
     occurs   .clear(true);
+    occurs_deferred = false;
     n_occ    .clear(true);
     elim_heap.clear(true);
     subsumption_queue.clear(true);
@@ -696,11 +1227,9 @@ cleanup:
     remove_satisfied      = true;
     ca.extra_clause_field = false;
 
-    // Force full cleanup (this is safe and desirable since it only happens once):
+    // Force full cleanup (this is safe and desirable since it only happens once per round):
     rebuildOrderHeap();
     garbageCollect();
-
-    return res;
 }
 
 
@@ -711,8 +1240,14 @@ bool SimpSolver::eliminate_()
     else if (!use_simplification)
         return true;
 
+    if (occurs_deferred)
+        buildOccurs();
+
     int trail_size_last = trail.size();
 
+    if (use_subst && !substituteEquivalences())
+        goto cleanup;
+
     // Main simplification loop:
     //
     while (n_touched > 0 || bwdsub_assigns < trail.size() || elim_heap.size() > 0){
@@ -732,6 +1267,11 @@ bool SimpSolver::eliminate_()
             goto cleanup; }
 
         // printf("  ## (time = %6.2f s) ELIM: vars = %d\n", cpuTime(), elim_heap.size());
+        if (elim_threads != 1 && use_elim && !use_asymm){
+            if (!eliminateBatches()){
+                ok = false; goto cleanup; }
+            continue; }
+
         for (int cnt = 0; !elim_heap.empty(); cnt++){
             Var elim = elim_heap.removeMin();
             
@@ -773,6 +1313,8 @@ bool SimpSolver::eliminate_()
     }
     checkGarbage();
 
+    if (verbosity >= 1 && subst_vars > 0)
+        printf("c |  Substituted variables:  %10d                                         |\n", subst_vars);
     if (verbosity >= 1 && elimclauses.size() > 0){
         printf("c |  Eliminated clauses:     %10.2f Mb                                      |\n", 
                double(elimclauses.size() * sizeof(uint32_t)) / (1024*1024));
@@ -781,6 +1323,608 @@ bool SimpSolver::eliminate_()
 }
 
 
+//=================================================================================================
+// Bounded variable addition:
+//
+// Following Manthey, Heule and Biere ("Automated Reencoding of Boolean Formulas"), a set of
+// literals L and a set of clauses C containing a literal l of L, such that the problem contains
+// (c \ {l}) | m for every m in L and c in C, is replaced by x | (c \ {l}) for every c in C and
+// ~x | m for every m in L over a new variable x. This saves |L|*|C| - |L| - |C| clauses; on the
+// pairwise encoding of an at-most-one constraint over n literals, repeated steps leave O(n)
+// clauses in place of n*(n-1)/2. Literals l are taken most occurrences first, and L grows
+// greedily by the literal that matches most clauses of C (dropping the others from C), as long
+// as the saving grows.
+//
+// The new variables are frozen, as eliminating them again would undo the step, and auxiliary:
+// they are left out of the model and, unless '-explore-aux', of the exploration steps. Their
+// clauses are RAT rather than RUP steps (on x, and then on ~x), written to the proof with the
+// pivot first as 'drat-trim' expects.
+
+
+// Collects in 'bva_match' the unassigned literals m such that (c \ {l}) | m is a problem clause,
+// where c is the clause 'cr' containing 'l', and these clauses in 'bva_match_cls'.
+void SimpSolver::bvaMatch(CRef cr, Lit l)
+{
+    const Clause& c    = ca[cr];
+    Lit           lmin = lit_Undef;
+
+    bva_match    .clear();
+    bva_match_cls.clear();
+    for (int i = 0; i < c.size(); i++)
+        if (c[i] != l){
+            bva_mark[toInt(c[i])] = 1;
+            if (lmin == lit_Undef || n_occ[toInt(c[i])] < n_occ[toInt(lmin)])
+                lmin = c[i]; }
+    if (lmin == lit_Undef) return;
+
+    OccList cs = occurs.lookup(var(lmin));
+    bva_budget -= cs.size();
+    for (int i = 0; i < cs.size(); i++){
+        const Clause& d = ca[cs[i]];
+        if (cs[i] == cr || d.mark() != 0 || d.size() != c.size()) continue;
+
+        Lit m = lit_Undef;
+        for (int j = 0; j < d.size(); j++)
+            if (!bva_mark[toInt(d[j])]){
+                if (m != lit_Undef){ m = lit_Error; break; }
+                m = d[j]; }
+        if (m != lit_Undef && m != lit_Error && var(m) != var(l) && value(m) == l_Undef){
+            bva_match    .push(m);
+            bva_match_cls.push(cs[i]); }
+    }
+
+    for (int i = 0; i < c.size(); i++)
+        bva_mark[toInt(c[i])] = 0;
+}
+
+
+// Adds a clause over a new auxiliary variable, writing it to the proof with its first literal
+// (the RAT pivot) first, as 'addClause_()' would sort it.
+bool SimpSolver::addBvaClause(vec<Lit>& ps)
+{
+    if (drup_file){
+#ifdef BIN_DRUP
+        binDRUP('a', ps, drup_file);
+#else
+        for (int i = 0; i < ps.size(); i++)
+            fprintf(drup_file, "%i ", (var(ps[i]) + 1) * (-2 * sign(ps[i]) + 1));
+        fprintf(drup_file, "0\n");
+#endif
+    }
+
+    FILE* drup = drup_file;
+    drup_file  = NULL;
+    bool  res  = addClause_(ps);
+    drup_file  = drup;
+    return res;
+}
+
+
+bool SimpSolver::addBvaVariables()
+{
+    assert(use_simplification && decisionLevel() == 0);
+
+    Heap<LitOccGt> queue((LitOccGt(n_occ)));
+    for (int i = 0; i < n_occ.size(); i++)
+        if (n_occ[i] > 2 && value(toLit(i)) == l_Undef && !isEliminated(var(toLit(i))))
+            queue.insert(i);
+
+    vec<Lit>  lits;            // The literals L,
+    vec<CRef> cls, next;       // and the clauses C (and those of them matched by the next literal).
+    vec<Lit>  pair_lit, cand;  // Literals matching a clause of C (one entry per pair), and these
+    vec<CRef> pair_cls;        // literals without duplicates.
+    vec<int>  count (n_occ.size(), 0);
+    vec<int>  stamp (n_occ.size(), 0);
+    vec<char> in_lits(n_occ.size(), 0);
+    vec<Lit>  ps, touched_lits;
+    vec<CRef> removed;
+    int       n_stamp = 0;
+
+    bva_mark.growTo(n_occ.size(), 0);
+    bva_budget = bva_steps;
+
+    while (!queue.empty() && bva_budget > 0 && !asynch_interrupt){
+        Lit l = toLit(queue.removeMin());
+        if (value(l) != l_Undef || n_occ[toInt(l)] < 3) continue;
+
+        // The clauses of 'l' without assigned literals:
+        cls.clear();
+        OccList cs = occurs.lookup(var(l));
+        for (int i = 0; i < cs.size(); i++){
+            const Clause& c = ca[cs[i]];
+            bool has_l = false, assigned = false;
+            for (int j = 0; j < c.size(); j++){
+                has_l    |= c[j] == l;
+                assigned |= value(c[j]) != l_Undef; }
+            if (has_l && !assigned && c.mark() == 0)
+                cls.push(cs[i]);
+        }
+        bva_budget -= cs.size();
+
+        lits.clear();
+        lits.push(l);
+        in_lits[toInt(l)] = 1;
+
+        for (;;){
+            pair_lit.clear();
+            pair_cls.clear();
+            cand    .clear();
+            for (int i = 0; i < cls.size(); i++){
+                bvaMatch(cls[i], l);
+                n_stamp++;
+                for (int j = 0; j < bva_match.size(); j++){
+                    int m = toInt(bva_match[j]);
+                    if (in_lits[m] || stamp[m] == n_stamp) continue;
+                    stamp[m] = n_stamp;
+                    if (count[m]++ == 0) cand.push(bva_match[j]);
+                    pair_lit.push(bva_match[j]);
+                    pair_cls.push(cls[i]); }
+            }
+
+            Lit best = lit_Undef;
+            for (int i = 0; i < cand.size(); i++)
+                if (best == lit_Undef || count[toInt(cand[i])] > count[toInt(best)])
+                    best = cand[i];
+
+            int a = lits.size(), b = cls.size();
+            int b_next = best == lit_Undef ? 0 : count[toInt(best)];
+            for (int i = 0; i < cand.size(); i++)
+                count[toInt(cand[i])] = 0;
+
+            if (best == lit_Undef || (a+1)*b_next - (a+1) - b_next <= a*b - a - b)
+                break;
+
+            lits.push(best);
+            in_lits[toInt(best)] = 1;
+            next.clear();
+            for (int i = 0; i < pair_lit.size(); i++)
+                if (pair_lit[i] == best)
+                    next.push(pair_cls[i]);
+            next.copyTo(cls);
+        }
+
+        for (int i = 0; i < lits.size(); i++)
+            in_lits[toInt(lits[i])] = 0;
+
+        int saving = lits.size() * cls.size() - lits.size() - cls.size();
+        if (saving <= 0) continue;
+
+        // The clauses to replace: each c in C, and (c \ {l}) | m for the other literals m of L.
+        removed.clear();
+        for (int i = 0; i < cls.size(); i++){
+            removed.push(cls[i]);
+            bvaMatch(cls[i], l);
+            for (int k = 1; k < lits.size(); k++)
+                for (int j = 0; j < bva_match.size(); j++)
+                    if (bva_match[j] == lits[k]){
+                        removed.push(bva_match_cls[j]);
+                        break; }
+        }
+        assert(removed.size() == lits.size() * cls.size());
+
+        touched_lits.clear();
+        for (int i = 0; i < removed.size(); i++){
+            const Clause& c = ca[removed[i]];
+            for (int j = 0; j < c.size(); j++)
+                touched_lits.push(c[j]); }
+
+        Var x = newVar();
+        setFrozen   (x, true);
+        setAuxiliary(x, true);
+        count  .growTo(n_occ.size(), 0);
+        stamp  .growTo(n_occ.size(), 0);
+        in_lits.growTo(n_occ.size(), 0);
+        bva_mark.growTo(n_occ.size(), 0);
+
+        // The clauses with 'x' first, so that those with '~x' are RAT on the clauses they replace:
+        for (int i = 0; i < cls.size(); i++){
+            const Clause& c = ca[cls[i]];
+            ps.clear();
+            ps.push(mkLit(x));
+            for (int j = 0; j < c.size(); j++)
+                if (c[j] != l)
+                    ps.push(c[j]);
+            if (!addBvaClause(ps))
+                return false;
+        }
+        for (int i = 0; i < lits.size(); i++){
+            ps.clear();
+            ps.push(~mkLit(x));
+            ps.push(lits[i]);
+            if (!addBvaClause(ps))
+                return false;
+        }
+        for (int i = 0; i < removed.size(); i++)
+            removeClause(removed[i]);
+
+        bva_vars++;
+        bva_removed += saving;
+
+        // Retry the literals whose occurrences changed, including those of 'x':
+        touched_lits.push(mkLit(x));
+        touched_lits.push(~mkLit(x));
+        for (int i = 0; i < touched_lits.size(); i++){
+            int m = toInt(touched_lits[i]);
+            if (queue.inHeap(m))
+                queue.update(m);
+            else if (n_occ[m] > 2)
+                queue.insert(m);
+        }
+
+        checkGarbage(simp_garbage_frac);
+    }
+
+    return true;
+}
+
+
+//=================================================================================================
+// Gates and XOR constraints:
+//
+// A variable v defined by a gate, i.e. by a subset G of its clauses that fixes its value for every
+// assignment of the other variables, needs only the resolvents of G with the other clauses when it
+// is eliminated: those among the other clauses follow from them (Een and Biere, "Effective
+// Preprocessing in SAT through Variable and Clause Elimination"). 'findGate()' recognizes AND
+// gates (of any arity, with v or ~v as output) and if-then-else gates, which include the XOR of two
+// literals.
+//
+// After the elimination, 'extractXors()' looks for the 2^(k-1) clauses over the same k variables
+// that together say that their XOR has a fixed parity, and hands these constraints to the search,
+// which propagates them by Gauss-Jordan elimination (see 'Gauss.cc'). The clauses stay in place.
+
+
+// Finds the ternary clause {a, b, c} among 'cs' (-1 if none).
+static int findTernary(const ClauseAllocator& ca, const vec<CRef>& cs, Lit a, Lit b, Lit c)
+{
+    for (int i = 0; i < cs.size(); i++){
+        const Clause& d = ca[cs[i]];
+        if (d.size() == 3 && find(d, a) && find(d, b) && find(d, c))
+            return i; }
+    return -1;
+}
+
+
+// Flags the clauses of a gate defining 'v' in 'gate_pos' and 'gate_neg' (parallel to 'pos' and
+// 'neg'). Reads the clauses only, so that it can run in the threads of 'resolveVar()'.
+bool SimpSolver::findGate(Var v, const vec<CRef>& pos, const vec<CRef>& neg, vec<char>& gate_pos, vec<char>& gate_neg) const
+{
+    gate_pos.clear(); gate_pos.growTo(pos.size(), 0);
+    gate_neg.clear(); gate_neg.growTo(neg.size(), 0);
+
+    // AND gates: o = ~q1 & ... & ~qk by {o, q1, ..., qk} and {~o, ~qi} for every i:
+    vec<Lit> inputs;
+    for (int s = 0; s < 2; s++){
+        Lit              o     = mkLit(v, s);
+        const vec<CRef>& longs = s ? neg : pos;
+        const vec<CRef>& bins  = s ? pos : neg;
+        vec<char>&       gl    = s ? gate_neg : gate_pos;
+        vec<char>&       gb    = s ? gate_pos : gate_neg;
+
+        inputs.clear();
+        for (int i = 0; i < bins.size(); i++){
+            const Clause& c = ca[bins[i]];
+            if (c.size() == 2)
+                inputs.push(c[0] == ~o ? ~c[1] : ~c[0]); }
+        if (inputs.size() == 0) continue;
+        sort(inputs);
+
+        for (int i = 0; i < longs.size(); i++){
+            const Clause& c = ca[longs[i]];
+            if (c.size() - 1 > inputs.size()) continue;
+            bool gate = true;
+            for (int j = 0; j < c.size() && gate; j++)
+                if (c[j] != o){
+                    int lo = 0, hi = inputs.size();
+                    while (lo < hi){
+                        int mid = (lo + hi) / 2;
+                        if (inputs[mid] < c[j]) lo = mid + 1; else hi = mid; }
+                    gate = lo < inputs.size() && inputs[lo] == c[j]; }
+            if (!gate) continue;
+
+            gl[i] = 1;
+            for (int j = 0; j < bins.size(); j++){
+                const Clause& b = ca[bins[j]];
+                if (b.size() == 2 && find(c, b[0] == ~o ? ~b[1] : ~b[0]))
+                    gb[j] = 1; }
+            return true;
+        }
+    }
+
+    // If-then-else gates: v = q ? ~y : ~x by {v, q, x}, {v, ~q, y}, {~v, q, ~x} and {~v, ~q, ~y}:
+    for (int i = 0; i < pos.size(); i++){
+        const Clause& a = ca[pos[i]];
+        if (a.size() != 3) continue;
+        for (int j = i + 1; j < pos.size(); j++){
+            const Clause& b = ca[pos[j]];
+            if (b.size() != 3) continue;
+            for (int k = 0; k < 3; k++){
+                Lit q = a[k];
+                if (var(q) == v || !find(b, ~q)) continue;
+                Lit x = lit_Undef, y = lit_Undef;
+                for (int l = 0; l < 3; l++){
+                    if (var(a[l]) != v && a[l] != q)  x = a[l];
+                    if (var(b[l]) != v && b[l] != ~q) y = b[l]; }
+                int c = findTernary(ca, neg, ~mkLit(v), q, ~x);
+                int d = c == -1 ? -1 : findTernary(ca, neg, ~mkLit(v), ~q, ~y);
+                if (d == -1) continue;
+                gate_pos[i] = gate_pos[j] = gate_neg[c] = gate_neg[d] = 1;
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+
+void SimpSolver::extractXors()
+{
+    vec<Lit>  lits;
+    vec<Var>  vars;
+    vec<char> found;
+
+    for (int i = 0; i < clauses.size(); i++){
+        const Clause& c = ca[clauses[i]];
+        if (c.mark() || c.size() < 3 || c.size() > xor_size) continue;
+
+        // Start from the clause whose negations (by variable order) are none or the first only:
+        int k = c.size();
+        lits.clear();
+        for (int j = 0; j < k; j++)
+            lits.push(c[j]);
+        sort(lits);
+        unsigned mask = 0;
+        for (int j = 0; j < k; j++)
+            mask |= (unsigned)sign(lits[j]) << j;
+        if (mask > 1) continue;
+
+        vars.clear();
+        Var least = var(lits[0]);
+        for (int j = 0; j < k; j++){
+            vars.push(var(lits[j]));
+            if (occurs.size(var(lits[j])) < occurs.size(least))
+                least = var(lits[j]); }
+        int need = 1 << (k - 1);
+        if (occurs.size(least) < need) continue;
+
+        // Collect the sign patterns of the clauses over the same variables with the same parity:
+        found.clear();
+        found.growTo(1 << k, 0);
+        int n = 0;
+        OccList cs = occurs[least];
+        for (int j = 0; j < cs.size() && n < need; j++){
+            const Clause& d = ca[cs[j]];
+            if (d.mark() || d.size() != k) continue;
+            unsigned pattern = 0;
+            int      l;
+            for (l = 0; l < k; l++){
+                int m;
+                for (m = 0; m < k && vars[m] != var(d[l]); m++);
+                if (m == k) break;
+                pattern |= (unsigned)sign(d[l]) << m; }
+            if (l < k || (__builtin_popcount(pattern) & 1) != (int)mask || found[pattern]) continue;
+            found[pattern] = 1;
+            n++;
+        }
+
+        if (n == need){
+            // Each clause excludes the assignment of its negations, all of parity 'mask':
+            addXor(vars, !mask);
+            xor_found++; }
+    }
+}
+
+
+//=================================================================================================
+// Inprocessing:
+//
+// After 'eliminate()', a round of backward subsumption, strengthening (self-subsuming resolution)
+// and variable elimination on the problem clauses runs at a restart every 'inproc-int' conflicts,
+// the interval growing by as much each round. The occurrence lists are rebuilt for the round and
+// dropped again, and a round stops once it has taken 'inproc-frac' of the CPU time since the
+// previous one. It picks up where the last left off: the units since then and the clauses whose
+// subsumption was cut short are checked, and only variables whose occurrences changed since they
+// were last tried (or that were not reached) are candidates for elimination.
+//
+// Frozen variables and the current assumptions are never eliminated, and elimination (and the
+// substitution of equivalent literals, e.g. those added by probing) is left out when checkpoints
+// are written, as these do not hold the elimination stack. Learnt clauses stay as they are,
+// except those over a removed variable, which are deleted. Activities, phases and the state of
+// the exploration are not touched.
+
+
+bool SimpSolver::inprocessDue() const
+{
+    return inproc_allowed && !use_simplification && conflicts >= next_inprocess && ok;
+}
+
+
+bool SimpSolver::inprocess()
+{
+    if (!inprocessDue())
+        return true;
+    assert(decisionLevel() == 0);
+
+    double start = cpuTime();
+    int    n_cls = nClauses();
+    int    n_var = eliminated_vars + subst_vars;
+    bool   elim  = checkpoint_file == NULL;
+    bool   res   = true;
+
+    vec<Var> extra_frozen;
+    for (int i = 0; i < assumptions.size(); i++)
+        if (!frozen[var(assumptions[i])]){
+            frozen[var(assumptions[i])] = 1;
+            extra_frozen.push(var(assumptions[i])); }
+
+    simp_deadline = start + inproc_frac * (start - inproc_last);
+    logUnits();
+    startInprocessing(elim && use_elim);
+
+    if (elim && use_subst)
+        res = substituteEquivalences();
+
+    while (res && (n_touched > 0 || bwdsub_assigns < trail.size() || elim_heap.size() > 0) && !outOfTime()){
+        gatherTouchedClauses();
+        if (!backwardSubsumptionCheck()){
+            res = false; break; }
+
+        while (res && !elim_heap.empty() && !outOfTime() && !asynch_interrupt){
+            Var v = elim_heap.removeMin();
+            if (isEliminated(v) || value(v) != l_Undef || frozen[v]) continue;
+
+            res = eliminateVar(v);
+            inproc_occ[toInt(mkLit(v))]  = n_occ[toInt(mkLit(v))];
+            inproc_occ[toInt(~mkLit(v))] = n_occ[toInt(~mkLit(v))];
+            checkGarbage(simp_garbage_frac);
+        }
+        if (asynch_interrupt) break;
+    }
+
+    // Candidates not reached come first next time, and so do the clauses left in the queue:
+    for (int i = 0; i < elim_heap.size(); i++)
+        inproc_occ[toInt(mkLit(elim_heap[i]))] = inproc_occ[toInt(~mkLit(elim_heap[i]))] = -1;
+    for (int i = 0; i < subsumption_queue.size(); i++){
+        const Clause& c = ca[subsumption_queue[i]];
+        if (subsumption_queue[i] == bwdsub_tmpunit || c.mark()) continue;
+        for (int j = 0; j < c.size(); j++)
+            if (!touched[var(c[j])]){
+                touched[var(c[j])] = 1;
+                n_touched++; } }
+
+    if (eliminated_vars + subst_vars != n_var){
+        logUnits();
+        removeEliminatedLearnts();
+        removeEliminatedXors(); }
+
+    for (int i = 0; i < extra_frozen.size(); i++)
+        frozen[extra_frozen[i]] = 0;
+    stopSimplification();
+    simp_deadline = 0;
+
+    inproc_rounds++;
+    inproc_vars    += eliminated_vars + subst_vars - n_var;
+    inproc_removed += n_cls - nClauses();
+    next_inprocess  = conflicts + (uint64_t)inproc_interval * (inproc_rounds + 1);
+    inproc_last     = cpuTime();
+    inproc_time    += inproc_last - start;
+
+    return ok = res && ok && propagate() == CRef_Undef;
+}
+
+
+// Rebuilds what the simplification needs from the current clauses: satisfied clauses and those
+// over a removed variable (imported after its elimination) are deleted, the remaining problem
+// clauses get their abstraction back and go into fresh occurrence lists, and the candidates for
+// elimination (if 'elim') into the heap.
+void SimpSolver::startInprocessing(bool elim)
+{
+    removeSatisfied();
+    for (int i = 0; i < clauses.size(); i++){
+        const Clause& c = ca[clauses[i]];
+        if (c.mark()) continue;
+        for (int j = 0; j < c.size(); j++)
+            if (isEliminated(var(c[j]))){
+                removeClause(clauses[i]); break; } }
+
+    // Reallocating the clauses with the extra field computes their abstractions:
+    ca.extra_clause_field = true;
+    garbageCollect();
+    vec<Lit> dummy(1, lit_Undef);
+    bwdsub_tmpunit = ca.alloc(dummy);
+
+    use_simplification = true;
+    remove_satisfied   = false;
+    if (bwdsub_assigns > trail.size()) bwdsub_assigns = trail.size();  // (the trail of a checkpoint)
+
+    n_occ     .growTo(2 * nVars(), 0);
+    touched   .growTo(nVars(), 0);
+    inproc_occ.growTo(2 * nVars(), -1);
+    for (int i = 0; i < clauses.size(); i++){
+        const Clause& c = ca[clauses[i]];
+        if (c.mark()) continue;
+        for (int j = 0; j < c.size(); j++)
+            n_occ[toInt(c[j])]++; }
+    buildOccurs();
+
+    for (Var v = 0; elim && v < nVars(); v++)
+        if (!frozen[v] && !isEliminated(v) && value(v) == l_Undef &&
+            (inproc_occ[toInt(mkLit(v))] != n_occ[toInt(mkLit(v))] || inproc_occ[toInt(~mkLit(v))] != n_occ[toInt(~mkLit(v))]))
+            elim_heap.insert(v);
+}
+
+
+// Lays out the occurrence lists of all clauses one after the other, with the room counted in
+// 'n_occ', so that they start without gaps.
+void SimpSolver::buildOccurs()
+{
+    occurs.clear(false);
+    for (Var v = 0; v < nVars(); v++){
+        occurs.init(v);
+        occurs.reserve(v, n_occ[toInt(mkLit(v))] + n_occ[toInt(~mkLit(v))]); }
+    for (int i = 0; i < clauses.size(); i++){
+        const Clause& c = ca[clauses[i]];
+        if (c.mark()) continue;
+        for (int j = 0; j < c.size(); j++)
+            occurs.push(var(c[j]), clauses[i]); }
+    occurs_deferred = false;
+}
+
+
+// Adds the units of the trail not logged yet to the DRUP proof, so that they stay derivable when
+// the clauses they were propagated by are deleted.
+void SimpSolver::logUnits()
+{
+    if (!drup_file) return;
+    vec<Lit> unit(1);
+    for (; drup_units < trail.size(); drup_units++){
+        unit[0] = trail[drup_units];
+#ifdef BIN_DRUP
+        binDRUP('a', unit, drup_file);
+#else
+        fprintf(drup_file, "%i 0\n", (var(unit[0]) + 1) * (-2 * sign(unit[0]) + 1));
+#endif
+    }
+}
+
+
+void SimpSolver::removeEliminatedLearnts()
+{
+    vec<CRef>* lists[] = { &learnts_core, &learnts_tier2, &learnts_local };
+    unsigned   marks[] = { CORE, TIER2, LOCAL };
+    for (int l = 0; l < 3; l++){
+        vec<CRef>& cs = *lists[l];
+        for (int i = 0; i < cs.size(); i++){
+            const Clause& c = ca[cs[i]];
+            if (c.mark() != marks[l]) continue;
+            for (int j = 0; j < c.size(); j++)
+                if (isEliminated(var(c[j]))){
+                    Solver::removeClause(cs[i]); break; } }
+        purgeDeleted(cs, ca);
+    }
+}
+
+
+// Drops the XOR constraints over a removed variable; the matrices are rebuilt without them.
+void SimpSolver::removeEliminatedXors()
+{
+    int i, j, k, l;
+    for (i = j = k = l = 0; i < xor_rhs.size(); i++, k++){
+        int start = k;
+        while (xors[k] != var_Undef && !isEliminated(xors[k])) k++;
+        if (xors[k] != var_Undef){
+            while (xors[k] != var_Undef) k++;
+            continue; }
+        while (start <= k)
+            xors[l++] = xors[start++];
+        xor_rhs[j++] = xor_rhs[i]; }
+    if (j < i){
+        xors   .shrink(xors.size() - l);
+        xor_rhs.shrink(i - j);
+        gauss_dirty = true; }
+}
+
+
 //=================================================================================================
 // Garbage Collection methods:
 
@@ -793,7 +1937,7 @@ void SimpSolver::relocAll(ClauseAllocator& to)
     //
     occurs.cleanAll();
     for (int i = 0; i < nVars(); i++){
-        vec<CRef>& cs = occurs[i];
+        OccList cs = occurs[i];
         for (int j = 0; j < cs.size(); j++)
             ca.reloc(cs[j], to);
     }
@@ -811,6 +1955,9 @@ void SimpSolver::relocAll(ClauseAllocator& to)
 
 void SimpSolver::garbageCollect()
 {
+    // The gaps of the occurrence lists are released first, as both regions are held below:
+    if (use_simplification) occurs.trim();
+
     // Initialize the next region to a size corresponding to the estimated utilization degree. This
     // is not precise but should avoid some unnecessary reallocations for the new region:
     ClauseAllocator to(ca.size() - ca.wasted()); 
@@ -63,10 +63,18 @@ class SimpSolver : public Solver {
     bool    solve       (Lit p       ,        bool do_simp = true, bool turn_off_simp = false);       
     bool    solve       (Lit p, Lit q,        bool do_simp = true, bool turn_off_simp = false);
     bool    solve       (Lit p, Lit q, Lit r, bool do_simp = true, bool turn_off_simp = false);
+    lbool   cube        (vec<Lit>& out_cubes);         // As in 'Solver', but models cover the eliminated variables.
+    lbool   conquer     (const vec<Lit>& cubes);
     bool    eliminate   (bool turn_off_elim = false);  // Perform variable elimination based simplification. 
     bool    eliminate_  ();
     void    removeSatisfied();
 
+    // Preprocessing cache (see 'PreCache.cc'):
+    //
+    uint64_t preprocessKey    (uint64_t input_hash) const;      // Key of the preprocessed input with this clause hash (see 'parse_DIMACS()') under the current options.
+    bool     writePreprocessed(const char* file, uint64_t key); // Write the formula left by 'eliminate()', with its elimination stack, to 'file'.
+    bool     readPreprocessed (const char* file, uint64_t key); // Replace the parsed formula by the one written for 'key', instead of 'eliminate()'.
+
     // Memory managment:
     //
     virtual void garbageCollect();
@@ -94,12 +102,35 @@ class SimpSolver : public Solver {
     bool    use_asymm;         // Shrink clauses by asymmetric branching.
     bool    use_rcheck;        // Check if a clause is already implied. Prett costly, and subsumes subsumptions :)
     bool    use_elim;          // Perform variable elimination.
+    int     elim_threads;      // Threads resolving independent variables during elimination (1 = sequential, 0 = one per processor).
+    int     elim_batch;        // Candidates selected per round of parallel elimination.
+    bool    use_subst;         // Substitute equivalent literals (cycles of binary clauses) before elimination.
+    bool    use_bva;           // Re-encode sets of clauses with a common structure by auxiliary variables (bounded variable addition).
+    int     bva_steps;         // Clause visits that bounded variable addition may take.
+    bool    use_gates;         // Leave out the resolvents among non-gate clauses when a variable is defined by a gate.
+    bool    use_xor;           // Hand the XOR constraints encoded by the clauses to the search (see 'Gauss.cc').
+    int     xor_size;          // Largest XOR constraint looked for.
+    int     inproc_interval;   // Conflicts before the first round of inprocessing, and by which the interval grows (0 = off).
+    double  inproc_frac;       // Share of the CPU time since the previous round that a round of inprocessing may take.
 
     // Statistics:
     //
     int     merges;
     int     asymm_lits;
     int     eliminated_vars;
+    int     subst_vars;        // Variables replaced by an equivalent literal.
+    int     bva_vars;          // Auxiliary variables introduced by bounded variable addition.
+    int     bva_removed;       // Problem clauses it saved (net of the clauses over the auxiliary variables).
+    int     gate_vars;         // Variables eliminated by their gate.
+    int     xor_found;         // XOR constraints found.
+    int     elim_rounds;       // Rounds of parallel elimination.
+    double  elim_time;         // Wall-clock seconds spent in them.
+    uint64_t subsumption_checks; // Calls of 'Clause::subsumes()' in backward subsumption.
+    double  subsumption_time;  // CPU seconds spent in backward subsumption.
+    int     inproc_rounds;     // Rounds of inprocessing.
+    double  inproc_time;       // CPU seconds spent in them.
+    int     inproc_vars;       // Variables they eliminated or substituted.
+    int     inproc_removed;    // Problem clauses they removed (net of resolvents).
 
  protected:
 
@@ -121,18 +152,25 @@ class SimpSolver : public Solver {
         //     return c_x < c_y || c_x == c_y && x < y; }
     };
 
+    struct LitOccGt {
+        const vec<int>& n_occ;
+        explicit LitOccGt(const vec<int>& no) : n_occ(no) {}
+        bool operator()(int x, int y) const { return n_occ[x] > n_occ[y]; } };
+
     struct ClauseDeleted {
         const ClauseAllocator& ca;
         explicit ClauseDeleted(const ClauseAllocator& _ca) : ca(_ca) {}
         bool operator()(const CRef& cr) const { return ca[cr].mark() == 1; } };
 
+    typedef CsrOccLists<Var, CRef, ClauseDeleted>::List OccList;
+
     // Solver state:
     //
     int                 elimorder;
     bool                use_simplification;
     vec<uint32_t>       elimclauses;
     vec<char>           touched;
-    OccLists<Var, vec<CRef>, ClauseDeleted>
+    CsrOccLists<Var, CRef, ClauseDeleted>
                         occurs;
     vec<int>            n_occ;
     Heap<ElimLt>        elim_heap;
@@ -141,11 +179,60 @@ class SimpSolver : public Solver {
     vec<char>           eliminated;
     int                 bwdsub_assigns;
     int                 n_touched;
+    bool                inproc_allowed;   // The current call to 'solve()' permits simplification between restarts.
+    uint64_t            next_inprocess;   // Conflict count at which the next round of inprocessing is due.
+    double              inproc_last;      // CPU time at the end of the previous round.
+    double              simp_deadline;    // CPU time at which the current round stops (0 = no limit).
+    vec<int>            inproc_occ;       // Occurrences of each literal when its variable was last tried for elimination (-1 = not yet).
+    int                 drup_units;       // Units of the trail written to the DRUP proof by 'logUnits()'.
+    bool                occurs_deferred;  // Clauses were added while 'parsing' without their occurrences (see 'buildOccurs()').
 
     // Temporaries:
     //
     CRef                bwdsub_tmpunit;
 
+    // Parallel elimination (see 'eliminateBatches()'):
+    //
+    struct ElimTask;
+    struct ElimBatch;
+    static void*  elimThread               (void* batch);
+    void          resolveVar               (ElimTask& t);
+    bool          eliminateBatches         ();
+
+    // Equivalent literal substitution (see 'substituteEquivalences()'):
+    //
+    struct SccFrame { int lit, next; };
+    bool          findEquivalences         (vec<Lit>& rep);
+    bool          substituted              (const Clause& c, const vec<Lit>& rep, vec<Lit>& out) const;
+    bool          substituteLearnts        (vec<CRef>& cs, unsigned valid_mark, const vec<Lit>& rep, vec<CRef>& old);
+    bool          substituteEquivalences   ();
+
+    // Bounded variable addition (see 'addBvaVariables()'):
+    //
+    vec<char>     bva_mark;                // Literals of the clause matched by 'bvaMatch()'.
+    vec<Lit>      bva_match;               // Output of 'bvaMatch()': the differing literals,
+    vec<CRef>     bva_match_cls;           // and the clauses they occur in.
+    int64_t       bva_budget;              // Clause visits left.
+    void          bvaMatch                 (CRef cr, Lit l);
+    bool          addBvaClause             (vec<Lit>& ps);
+    bool          addBvaVariables          ();
+
+    // Gates and XOR constraints (see 'findGate()' and 'extractXors()'):
+    //
+    bool          findGate                 (Var v, const vec<CRef>& pos, const vec<CRef>& neg, vec<char>& gate_pos, vec<char>& gate_neg) const;
+    void          extractXors              ();
+    void          removeEliminatedXors     ();
+
+    // Inprocessing (see 'inprocess()'):
+    //
+    bool          inprocess                ();
+    bool          inprocessDue             () const;
+    void          startInprocessing        (bool elim);
+    void          buildOccurs              ();
+    void          removeEliminatedLearnts  ();
+    void          logUnits                 ();
+    bool          outOfTime                () const;
+
     // Main internal methods:
     //
     lbool         solve_                   (bool do_simp = true, bool turn_off_simp = false);
@@ -157,7 +244,10 @@ class SimpSolver : public Solver {
     bool          merge                    (const Clause& _ps, const Clause& _qs, Var v, int& size);
     bool          backwardSubsumptionCheck (bool verbose = false);
     bool          eliminateVar             (Var v);
+    void          storeElimClauses         (Var v, const vec<CRef>& pos, const vec<CRef>& neg);
+    void          removeElimClauses        (Var v);
     void          extendModel              ();
+    void          stopSimplification       ();
 
     void          removeClause             (CRef cr);
     bool          strengthenClause         (CRef cr, Lit l);
@@ -171,6 +261,7 @@ class SimpSolver : public Solver {
 
 
 inline bool SimpSolver::isEliminated (Var v) const { return eliminated[v]; }
+inline bool SimpSolver::outOfTime    ()      const { return simp_deadline > 0 && cpuTime() > simp_deadline; }
 inline void SimpSolver::updateElimHeap(Var v) {
     assert(use_simplification);
     // if (!frozen[v] && !isEliminated(v) && value(v) == l_Undef)
@@ -195,6 +286,9 @@ inline bool SimpSolver::solve        (const vec<Lit>& assumps, bool do_simp, boo
 inline lbool SimpSolver::solveLimited (const vec<Lit>& assumps, bool do_simp, bool turn_off_simp){ 
     assumps.copyTo(assumptions); return solve_(do_simp, turn_off_simp); }
 
+inline lbool SimpSolver::cube   (vec<Lit>& out_cubes)         { lbool r = Solver::cube(out_cubes); if (r == l_True) extendModel(); return r; }
+inline lbool SimpSolver::conquer(const vec<Lit>& cubes)       { lbool r = Solver::conquer(cubes);  if (r == l_True) extendModel(); return r; }
+
 //=================================================================================================
 }
 
@@ -0,0 +1,22 @@
+#!/bin/sh
+##
+##  Measures the preprocessing of each input: simplifies it (without solving) and prints the
+##  simplification time and the backward subsumption row (checks and checks/sec).
+##
+##    bench_subsumption.sh <cnf-file>... [-- extra minisat options]
+
+if [ $# -lt 1 ]; then
+    echo "usage: $0 <cnf-file>... [-- extra minisat options]" >&2
+    exit 1
+fi
+
+MINISAT=${MINISAT:-$(dirname "$0")/minisat_release}
+CNFS=
+while [ $# -gt 0 ] && [ "$1" != "--" ]; do CNFS="$CNFS $1"; shift; done
+[ $# -gt 0 ] && shift
+
+for CNF in $CNFS; do
+    echo "== $CNF"
+    "$MINISAT" -verb=1 -dimacs=/dev/null "$@" "$CNF" 2>&1 \
+        | grep -E "Number of variables|Simplification time|subsumption:|parallel elim"
+done
@@ -0,0 +1,160 @@
+/**********************************************************************************[ModelWriter.cc]
+Buffered model output for the front-ends.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+**************************************************************************************************/
+
+#include <pthread.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "mtl/XAlloc.h"
+#include "utils/Options.h"
+#include "core/ModelWriter.h"
+
+using namespace Glucose;
+
+//=================================================================================================
+// Options:
+
+
+static const char* _cat = "MAIN";
+
+static IntOption  opt_model_threads(_cat, "model-threads", "Threads used to format large models (0 = one per processor)", 0, IntRange(0, 256));
+static BoolOption opt_binary_model (_cat, "binary-model",  "Write the model of the result file in binary form", false);
+
+// Variables per chunk. A chunk needs at most 12 characters per variable ("-2147483647 ").
+static const int chunk_vars = 1 << 20;
+
+
+//=================================================================================================
+// Text formatting:
+
+
+struct ModelChunk {
+    const vec<lbool>* model;
+    int               first, last;
+    char*             buf;
+    int               len;
+};
+
+// Formats the variables '[first, last)' of a chunk. Variable numbers are consecutive, so the
+// decimal text of the current one is kept and incremented in place rather than converted anew.
+static void* formatChunk(void* arg)
+{
+    ModelChunk&       c     = *(ModelChunk*)arg;
+    const vec<lbool>& model = *c.model;
+    char              digits[16];
+    int               ndigits = sprintf(digits, "%d", c.first + 1);
+    char*             p       = c.buf;
+
+    for (int i = c.first; i < c.last; i++){
+        if (model[i] != l_Undef){
+            if (model[i] == l_False) *p++ = '-';
+            memcpy(p, digits, ndigits); p += ndigits;
+            *p++ = ' '; }
+
+        int k = ndigits - 1;
+        while (k >= 0 && digits[k] == '9') digits[k--] = '0';
+        if (k >= 0) digits[k]++;
+        else{
+            memmove(digits + 1, digits, ndigits++);
+            digits[0] = '1'; }
+    }
+    c.len = p - c.buf;
+    return NULL;
+}
+
+
+void Glucose::writeModel(FILE* out, const vec<lbool>& model, const char* prefix)
+{
+    int nchunks = (model.size() + chunk_vars - 1) / chunk_vars;
+    int threads = opt_model_threads;
+    if (threads == 0){
+        long procs = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = procs > 0 ? (int)procs : 1; }
+    if (threads > nchunks) threads = nchunks;
+    if (threads < 1)       threads = 1;
+
+    ModelChunk* chunks  = (ModelChunk*)xrealloc(NULL, sizeof(ModelChunk) * threads);
+    pthread_t*  workers = (pthread_t*) xrealloc(NULL, sizeof(pthread_t)  * threads);
+    for (int t = 0; t < threads; t++)
+        chunks[t].buf = (char*)xrealloc(NULL, 12 * chunk_vars);
+
+    fputs(prefix, out);
+    // Format up to 'threads' chunks at a time, then write them out in order:
+    for (int next = 0; next < nchunks; next += threads){
+        int round = nchunks - next < threads ? nchunks - next : threads;
+        for (int t = 0; t < round; t++){
+            ModelChunk& c = chunks[t];
+            c.model = &model;
+            c.first = (next + t) * chunk_vars;
+            c.last  = c.first + chunk_vars < model.size() ? c.first + chunk_vars : model.size(); }
+
+        if (round == 1)
+            formatChunk(&chunks[0]);
+        else{
+            int started = 0;
+            for (; started < round; started++)
+                if (pthread_create(&workers[started], NULL, formatChunk, &chunks[started]) != 0) break;
+            for (int t = started; t < round; t++)    // Could not start a thread: format it here.
+                formatChunk(&chunks[t]);
+            for (int t = 0; t < started; t++)
+                pthread_join(workers[t], NULL); }
+
+        for (int t = 0; t < round; t++)
+            fwrite(chunks[t].buf, 1, chunks[t].len, out);
+    }
+    fputs("0\n", out);
+
+    for (int t = 0; t < threads; t++)
+        free(chunks[t].buf);
+    free(chunks);
+    free(workers);
+}
+
+
+//=================================================================================================
+// Binary format:
+
+
+void Glucose::writeModelBinary(FILE* out, const vec<lbool>& model)
+{
+    unsigned char header[8] = { 'M', 'D', 'L', '1' };
+    uint32_t      n         = model.size();
+    for (int i = 0; i < 4; i++)
+        header[4 + i] = (n >> (8 * i)) & 0xff;
+    fwrite(header, 1, sizeof(header), out);
+
+    int            bytes = (model.size() + 3) / 4;
+    unsigned char* buf   = (unsigned char*)xrealloc(NULL, bytes > 0 ? bytes : 1);
+    memset(buf, 0, bytes);
+    for (int i = 0; i < model.size(); i++){
+        unsigned v = model[i] == l_True ? 1 : model[i] == l_False ? 0 : 2;
+        buf[i >> 2] |= v << (2 * (i & 3)); }
+    fwrite(buf, 1, bytes, out);
+    free(buf);
+}
+
+
+void Glucose::writeSatResult(FILE* res, const vec<lbool>& model)
+{
+    fputs("SAT\n", res);
+    if (opt_binary_model)
+        writeModelBinary(res, model);
+    else
+        writeModel(res, model);
+}
@@ -118,6 +118,7 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
  static BoolOption opt_adapt(_cat, "adapt", "Adapt dynamically stategies after 100000 conflicts", true);
  
  static BoolOption opt_forceunsat(_cat,"forceunsat","Force the phase for UNSAT",true);
+ static BoolOption opt_reuse_trail(_cat, "reuse-trail", "Restart only to the first level whose decision ranks below the top of the order heap", false);
  //=================================================================================================
  // Constructor/Destructor:
  
@@ -159,6 +160,7 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
  , useUnaryWatched(false)
  , promoteOneWatchedClause(true)
  ,solves(0),starts(0),decisions(0),propagations(0),conflicts(0),conflictsRestarts(0)
+ , reused_restarts(0), reused_levels(0), reused_props(0)
  , curRestart(1)
  , glureduce(opt_glu_reduction)
  , restart_inc(opt_restart_inc)
@@ -170,6 +172,7 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
  , newDescent(0)
  , randomDescentAssignments(0)
  , forceUnsatOnNewDescent(opt_forceunsat)
+ , reuse_trail(opt_reuse_trail)
  
  , ok(true)
  , lastDecisionHadConflicts (false)
@@ -190,6 +193,11 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
  , numMissedExpSteps (0)
  , expInc (0)
  , topReplaced (0) 
+ , mWDefault (5)
+ , mSDefault (5)
+ , prThDefault (2)
+ , expStepDecay (0.9)
+ , exploration (true)
  , cla_inc(1)
  , var_inc(1)
  , watches(WatcherDeleted(ca))
@@ -217,6 +225,8 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
  , performLCM(1)
  {
      MYFLAG = 0;
+     exploring = false;
+     avgCDPhaseLen = toReachConflict = 0;
      // Initialize only first time. Useful for incremental solving (not in // version), useless otherwise
      // Kept here for simplicity
      lbdQueue.initSize(sizeLBDQueue);
@@ -266,6 +276,7 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
  // Statistics: (formerly in 'SolverStats')
  //
  ,solves(0),starts(0),decisions(0),propagations(0),conflicts(0),conflictsRestarts(0)
+ , reused_restarts(0), reused_levels(0), reused_props(0)
  
  , curRestart(s.curRestart)
  , glureduce(s.glureduce)
@@ -278,10 +289,11 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
  , newDescent(s.newDescent)
  , randomDescentAssignments(s.randomDescentAssignments)
  , forceUnsatOnNewDescent(s.forceUnsatOnNewDescent)
+ , reuse_trail(s.reuse_trail)
  , ok(true)
  , state (-1)
  , numGlueClauses (0)
- , totalLBD (0.0)
+ , totalLBD (0)
  , cla_inc(s.cla_inc)
  , var_inc(s.var_inc)
  , watches(WatcherDeleted(ca))
@@ -313,6 +325,19 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
  
      // Initialize  other variables
      MYFLAG = 0;
+     // Exploration: parameters are copied, statistics start from scratch
+     mWDefault = s.mWDefault;
+     mSDefault = s.mSDefault;
+     prThDefault = s.prThDefault;
+     expStepDecay = s.expStepDecay;
+     exploration = s.exploration;
+     exploring = false;
+     lastDecisionHadConflicts = false;
+     decisionsWithoutConflicts = decisionsWithConflicts = successiveDecisionsWithoutConfs = 0;
+     totalCDPhaseLen = CDPhaseCount = numExpConflicts = expTotalLBD = expGlueClauses = 0;
+     numExpEpisodes = numExpSteps = numMissedExpSteps = expInc = topReplaced = 0;
+     avgCDPhaseLen = toReachConflict = 0;
+     explorationOverhead = 0.0;
      // Initialize only first time. Useful for incremental solving (not in // version), useless otherwise
      // Kept here for simplicity
      sumLBD = s.sumLBD;
@@ -1437,6 +1462,38 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
  }
  
  
+ // Partial restarts: a restart would decide the variables above the top of the order heap again, so
+ // the levels whose decisions rank above it, with the phase a new descent gives them, are kept, as
+ // are the levels of the assumptions. 'simplifyAll()' waits for the next restart that reaches level 0,
+ // unless the learnt clauses were reduced twice since the last one; that and randomized descents make
+ // it a full restart.
+ int Solver::reuseTrailLevel() {
+     if(!reuse_trail || (useLCM && performLCM > 1) || randomize_on_restarts || fixed_randomize_on_restarts)
+         return 0;
+ 
+     while(!order_heap.empty() && (value(order_heap[0]) != l_Undef || !decision[order_heap[0]]))
+         order_heap.removeMin();
+     if(order_heap.empty())
+         return 0;
+ 
+     double top = activity[order_heap[0]];
+     int level = assumptions.size() < decisionLevel() ? assumptions.size() : decisionLevel();
+     while(level < decisionLevel()) {
+         Lit d = trail[trail_lim[level]];
+         if(activity[var(d)] <= top || (forceUnsatOnNewDescent && forceUNSAT[var(d)] != 0 && sign(d) != (forceUNSAT[var(d)] < 0)))
+             break;
+         level++;
+     }
+ 
+     if(level > 0) {
+         reused_restarts++;
+         reused_levels += level;
+         reused_props += (level < decisionLevel() ? trail_lim[level] : trail.size()) - trail_lim[0];
+     }
+     return level;
+ }
+ 
+ 
  /*_________________________________________________________________________________________________
  |
  |  search : (nof_conflicts : int) (params : const SearchParams&)  ->  [lbool]
@@ -1462,7 +1519,7 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
      starts++;
  
      // simplify
-     if (useLCM && performLCM){
+     if (useLCM && performLCM && decisionLevel() == 0){
          //printf("###simplifyAll: %lld\n", conflicts);
          sort(learnts, reduceDB_lt(ca));
          //printf("nbClauses : %d, nbLearnts : %d\n", clauses.size(), learnts.size());
@@ -1480,6 +1537,8 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
  
              if(parallelImportClauses())
                  return l_False;
+
+             parallelImportExplorationScores();
  
          }
          CRef confl = propagate();
@@ -1542,7 +1601,7 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
              lbdQueue.push(nblevels);
              sumLBD += nblevels;
              
-             totalLBD += (double) nblevels;
+             totalLBD += nblevels;
              if(nblevels==2){
                  numGlueClauses++;
              }  
@@ -1594,9 +1653,9 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
                 (!luby_restart && (lbdQueue.isvalid() && ((lbdQueue.getavg() * K) > (sumLBD / conflictsRestarts))))) {
                  lbdQueue.fastclear();
                  progress_estimate = progressEstimate();
-                 int bt = 0;
+                 int bt = reuseTrailLevel();
  #ifdef INCREMENTAL
-                 if(incremental) // DO NOT BACKTRACK UNTIL 0.. USELESS
+                 if(incremental && bt == 0) // DO NOT BACKTRACK UNTIL 0.. USELESS
                      bt = (decisionLevel()<assumptions.size()) ? decisionLevel() : assumptions.size();
  #endif
                  newDescent = true;
@@ -1621,7 +1680,7 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
                  if(learnts.size() > 0) {
                      curRestart = (conflicts / nbclausesbeforereduce) + 1;
                      reduceDB();
-                     performLCM = 1;
+                     performLCM++;
                      if(!panicModeIsEnabled())
                          nbclausesbeforereduce += incReduceDB;
                  }
@@ -1647,12 +1706,13 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
              if(next == lit_Undef) {
                  // New variable decision:
                  //collectCDData();
-                 if(triggerExploration()==true) {
+                 if(exploration && triggerExploration()==true) {
                     // cout<<"\nexploring";
                       double sT = cpuTime();
                       explore();
                       computeExplorationScore();
                       updateHeapWithExpScore();
+                      parallelExportExplorationScores();
                       double eT=cpuTime();
                       explorationOverhead += (eT-sT); 
                  }
@@ -2035,6 +2095,15 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
  void Solver::parallelImportClauseDuringConflictAnalysis(Clause &, CRef ) {
  }
 
+ void Solver::parallelExportWalkConflict(vec<Lit> &, unsigned int ) {
+ }
+
+ void Solver::parallelExportExplorationScores() {
+ }
+
+ void Solver::parallelImportExplorationScores() {
+ }
+
 // checks whether to trigger an exploration prior to the next decision
 bool Solver::triggerExploration(){
     //tracks data related to the current CD phase.
@@ -2077,9 +2146,10 @@ void Solver::explore(){
         bool endsWithAConf = false;
         stepVarPair.clear(); stepConfFlagPair.clear(); stepConfLBDPair.clear();
         for(int j=0;j<mS;j++){
-            bool flag; 
-            CRef confl;
-            Var stepVar;
+            if(order_heap.empty()) break; // no variable left to step on: the walk ends here
+            bool flag = false;
+            CRef confl = CRef_Undef;
+            Var stepVar = var_Undef;
             
             confl = performStep(flag,stepVar);
             
@@ -2090,6 +2160,7 @@ void Solver::explore(){
                     learnt_clause.clear(); selectors.clear();
                     analyze(confl, learnt_clause, selectors, backtrack_level, nblevels, szWithoutSelectors);
                     stepConfLBDPair[expStep] = nblevels;
+                    if(selectors.size() == 0) parallelExportWalkConflict(learnt_clause, nblevels);
                     expTotalLBD+=nblevels;
                     cancelUntil(dLevel);
                     endsWithAConf = true;
@@ -2118,7 +2189,8 @@ void Solver::explore(){
 
 //performs a random step selection 
 CRef Solver::performStep(bool &flag, Var& next_var){
-    CRef confl;
+    CRef confl = CRef_Undef;
+    flag = false;
     if (!order_heap.empty()) {
         next_var = order_heap[irand(random_seed, order_heap.size())];
         Lit next = mkLit(next_var, polarity[next_var]);
@@ -2141,7 +2213,7 @@ void Solver::computeExplorationScore(){
         if(walkWithConf[walk]==true && (double) stepLBDMap[walk][stepVarMap[walk].size()-1] <= avgLBD){
             int stepsCount = stepVarMap[walk].size();             
             for(int revStep=stepsCount-1;revStep>=0;revStep--){                
-                double stepScore = ((1.0/(double)stepLBDMap[walk][stepsCount-1])) * pow(0.9,stepsCount-revStep-1);
+                double stepScore = ((1.0/(double)stepLBDMap[walk][stepsCount-1])) * pow(expStepDecay,stepsCount-revStep-1);
                 uint32_t stepVar = stepVarMap[walk][revStep];
                 walkScore[stepVar] += stepScore;
                 varOcc[stepVar]++;
@@ -2161,17 +2233,22 @@ void Solver::updateHeapWithExpScore(){
     for (std::map<uint32_t,double>::iterator it=expScore.begin(); it!=expScore.end(); ++it){
         uint32_t var = it->first;
         double expS = it->second;
-        double temp = activity[var];
-        double inc = expS*var_inc;
-        activity[var]+=inc;
+        bumpExpScore(var, expS);
+    }
+}
 
-        if(temp<activity[var]){
-            Var top =order_heap[0];
-            expInc++;
-            order_heap.decrease(var);
-            if(top!=order_heap[0]){
-                topReplaced++;
-            }
+// adds an exploration score (of this thread or, in glucose-syrup, of another one) to the activity of v.
+void Solver::bumpExpScore(Var var, double expS){
+    double temp = activity[var];
+    double inc = expS*var_inc;
+    activity[var]+=inc;
+
+    if(temp<activity[var] && order_heap.inHeap(var)){
+        Var top =order_heap[0];
+        expInc++;
+        order_heap.decrease(var);
+        if(top!=order_heap[0]){
+            topReplaced++;
         }
     }
 }
@@ -267,6 +267,9 @@ public:
     virtual void parallelImportUnaryClauses();
     virtual void parallelExportUnaryClause(Lit p);
     virtual void parallelExportClauseDuringSearch(Clause &c);
+    virtual void parallelExportWalkConflict(vec<Lit> &c, unsigned int lbd); // A clause learnt from a conflict of a random walk
+    virtual void parallelExportExplorationScores(); // Publish 'expScore' after an exploration episode
+    virtual void parallelImportExplorationScores(); // Fold the scores published by other threads into 'activity'
     virtual bool parallelJobIsFinished();
     virtual bool panicModeIsEnabled();
 
@@ -278,6 +281,7 @@ public:
 
     // Important stats completely related to search. Keep here
     uint64_t solves,starts,decisions,propagations,conflicts,conflictsRestarts;
+    uint64_t reused_restarts, reused_levels, reused_props; // Partial restarts (see 'reuseTrailLevel()').
 
     /** New Code (By SC)**/
     int state;
@@ -286,6 +290,8 @@ public:
 
     uint64_t totalCDPhaseLen, CDPhaseCount, numExpConflicts, expTotalLBD, expGlueClauses,numExpEpisodes,numExpSteps, numMissedExpSteps, expInc, topReplaced;
     uint32_t mWDefault,  mSDefault, prThDefault;
+    double expStepDecay; // Decay of the score of a step with its distance to the conflict ending the walk
+    bool exploration; // Run exploration episodes (threads of glucose-syrup may leave them to others)
 
     double explorationOverhead;
     
@@ -303,6 +309,7 @@ protected:
     bool randomize_on_restarts, fixed_randomize_on_restarts, newDescent;
     uint32_t randomDescentAssignments;
     bool forceUnsatOnNewDescent;
+    bool reuse_trail; // Restarts keep the levels whose decisions rank above the top of the order heap.
     // Helper structures:
     //
     struct VarData { CRef reason; int level; };
@@ -432,6 +439,7 @@ protected:
     void     analyzeFinal     (Lit p, vec<Lit>& out_conflict);                         // COULD THIS BE IMPLEMENTED BY THE ORDINARIY "analyze" BY SOME REASONABLE GENERALIZATION?
     bool     litRedundant     (Lit p, uint32_t abstract_levels);                       // (helper method for 'analyze()')
     lbool    search           (int nof_conflicts);                                     // Search for a given number of conflicts.
+    virtual int      reuseTrailLevel  ();                                              // The level a restart backtracks to (see 'reuse_trail').
     virtual lbool    solve_           (bool do_simp = true, bool turn_off_simp = false);                                                      // Main solve method (assumptions given in 'assumptions').
     virtual void     reduceDB         ();                                              // Reduce the set of learnt clauses.
     void     removeSatisfied  (vec<CRef>& cs);                                         // Shrink 'cs' to contain only non-satisfied clauses.
@@ -498,6 +506,7 @@ protected:
 
     void computeExplorationScore();
     void updateHeapWithExpScore();
+    void bumpExpScore(Var v, double expS);
     void initExpParameters();
 
     std::map<int,std::map<int,uint32_t>> stepVarMap;
@@ -537,7 +546,7 @@ public:
 
     // in redundant
     bool removed(CRef cr);
-    int performLCM;
+    int performLCM; // Reductions of the learnt clauses since the last 'simplifyAll()'
 
     //// test
     vec<int> valueDup;
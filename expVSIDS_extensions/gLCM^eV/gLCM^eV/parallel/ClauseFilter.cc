@@ -0,0 +1,99 @@
+/*******************************************************************************************[ClauseFilter.cc]
+ Glucose -- Copyright (c) 2009-2014, Gilles Audemard, Laurent Simon
+                                CRIL - Univ. Artois, France
+                                LRI  - Univ. Paris Sud, France (2009-2013)
+                                Labri - Univ. Bordeaux, France
+
+ Syrup (Glucose Parallel) -- Copyright (c) 2013-2014, Gilles Audemard, Laurent Simon
+                                CRIL - Univ. Artois, France
+                                Labri - Univ. Bordeaux, France
+
+Glucose sources are based on MiniSat (see below MiniSat copyrights). Permissions and copyrights of
+Glucose (sources until 2013, Glucose 3.0, single core) are exactly the same as Minisat on which it 
+is based on. (see below).
+
+Glucose-Syrup sources are based on another copyright. Permissions and copyrights for the parallel
+version of Glucose-Syrup (the "Software") are granted, free of charge, to deal with the Software
+without restriction, including the rights to use, copy, modify, merge, publish, distribute,
+sublicence, and/or sell copies of the Software, and to permit persons to whom the Software is 
+furnished to do so, subject to the following conditions:
+
+- The above and below copyrights notices and this permission notice shall be included in all
+copies or substantial portions of the Software;
+- The parallel version of Glucose (all files modified since Glucose 3.0 releases, 2013) cannot
+be used in any competitive event (sat competitions/evaluations) without the express permission of 
+the authors (Gilles Audemard / Laurent Simon). This is also the case for any competitive event
+using Glucose Parallel as an embedded SAT engine (single core or not).
+
+
+--------------- Original Minisat Copyrights
+
+Copyright (c) 2003-2006, Niklas Een, Niklas Sorensson
+Copyright (c) 2007-2010, Niklas Sorensson
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ **************************************************************************************************/
+
+#include "parallel/ClauseFilter.h"
+
+using namespace Glucose;
+
+// Three bits per clause, by double hashing of the mixed signature
+static const int nbProbes = 3;
+
+void ClauseFilter::init(int bits) {
+    for (int g = 0; g < 2; g++) words[g].clear(true);
+    mask = limit = inserted = 0;
+    current = 0;
+    if (bits <= 0) return;
+    if (bits < 6) bits = 6;
+    if (bits > 32) bits = 32;
+    mask = ((uint64_t) 1 << bits) - 1;
+    limit = ((uint64_t) 1 << bits) / 16;
+    for (int g = 0; g < 2; g++) words[g].growTo((int) ((mask + 1) / 64), 0);
+}
+
+bool ClauseFilter::test(int g, uint64_t sig) const {
+    uint64_t h = mix(sig), step = (h >> 32) | 1;
+    for (int k = 0; k < nbProbes; k++, h += step) {
+        uint64_t bit = h & mask;
+        if (!(words[g][bit >> 6] & ((uint64_t) 1 << (bit & 63)))) return false;
+    }
+    return true;
+}
+
+void ClauseFilter::add(uint64_t sig) {
+    if (!enabled()) return;
+    if (inserted >= limit) { // Age: forget the older generation
+        current = 1 - current;
+        for (int i = 0; i < words[current].size(); i++) words[current][i] = 0;
+        inserted = 0;
+    }
+    uint64_t h = mix(sig), step = (h >> 32) | 1;
+    for (int k = 0; k < nbProbes; k++, h += step) {
+        uint64_t bit = h & mask;
+        words[current][bit >> 6] |= (uint64_t) 1 << (bit & 63);
+    }
+    inserted++;
+}
+
+bool ClauseFilter::testAndAdd(uint64_t sig) {
+    if (!enabled()) return false;
+    if (test(current, sig)) return true;
+    bool found = test(1 - current, sig);
+    add(sig); // Also refreshes a clause known by the older generation only
+    return found;
+}
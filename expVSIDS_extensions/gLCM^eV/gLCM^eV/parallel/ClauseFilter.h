@@ -0,0 +1,113 @@
+/********************************************************************************************[ClauseFilter.h]
+ Glucose -- Copyright (c) 2009-2014, Gilles Audemard, Laurent Simon
+                                CRIL - Univ. Artois, France
+                                LRI  - Univ. Paris Sud, France (2009-2013)
+                                Labri - Univ. Bordeaux, France
+
+ Syrup (Glucose Parallel) -- Copyright (c) 2013-2014, Gilles Audemard, Laurent Simon
+                                CRIL - Univ. Artois, France
+                                Labri - Univ. Bordeaux, France
+
+Glucose sources are based on MiniSat (see below MiniSat copyrights). Permissions and copyrights of
+Glucose (sources until 2013, Glucose 3.0, single core) are exactly the same as Minisat on which it 
+is based on. (see below).
+
+Glucose-Syrup sources are based on another copyright. Permissions and copyrights for the parallel
+version of Glucose-Syrup (the "Software") are granted, free of charge, to deal with the Software
+without restriction, including the rights to use, copy, modify, merge, publish, distribute,
+sublicence, and/or sell copies of the Software, and to permit persons to whom the Software is 
+furnished to do so, subject to the following conditions:
+
+- The above and below copyrights notices and this permission notice shall be included in all
+copies or substantial portions of the Software;
+- The parallel version of Glucose (all files modified since Glucose 3.0 releases, 2013) cannot
+be used in any competitive event (sat competitions/evaluations) without the express permission of 
+the authors (Gilles Audemard / Laurent Simon). This is also the case for any competitive event
+using Glucose Parallel as an embedded SAT engine (single core or not).
+
+
+--------------- Original Minisat Copyrights
+
+Copyright (c) 2003-2006, Niklas Een, Niklas Sorensson
+Copyright (c) 2007-2010, Niklas Sorensson
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ **************************************************************************************************/
+
+#ifndef ClauseFilter_h
+#define ClauseFilter_h
+
+#include <stdint.h>
+
+#include "mtl/Vec.h"
+#include "core/SolverTypes.h"
+
+namespace Glucose {
+
+// A Bloom filter over clause signatures, used by each thread of Syrup to recognize the clauses
+// it already has. The signature of a clause does not depend on the order of its literals.
+//
+// A Bloom filter cannot forget a clause, while solvers do delete their clauses: the filter is
+// made of two generations of 2^bits bits. Clauses are added to the current one and looked up
+// in both; once the current one holds 2^bits / 16 clauses (about 0.5% of false positives), the
+// older one is cleared and becomes the current one. A clause is thus remembered for at least
+// 2^bits / 16 insertions.
+class ClauseFilter {
+public:
+    ClauseFilter() : mask(0), limit(0), inserted(0), current(0) {}
+
+    void init(int bits);                        // 0 disables the filter
+    bool enabled() const {return mask != 0;}
+
+    template<class Lits>
+    static uint64_t signature(const Lits & c);
+
+    // Returns true if the clause of signature 'sig' was (probably) already added, and adds it
+    bool testAndAdd(uint64_t sig);
+    bool contains(uint64_t sig) const {return enabled() && (test(current, sig) || test(1 - current, sig));}
+    void add(uint64_t sig);
+
+    uint64_t memoryUsed() const {return (uint64_t) (words[0].capacity() + words[1].capacity()) * sizeof(uint64_t);}
+
+private:
+    vec<uint64_t> words[2];
+    uint64_t      mask;     // Number of bits of one generation, minus 1
+    uint64_t      limit;    // Clauses added to a generation before it ages
+    uint64_t      inserted; // Clauses added to the current generation
+    int           current;
+
+    static inline uint64_t mix(uint64_t x) { // Finalizer of MurmurHash3
+        x ^= x >> 33; x *= 0xff51afd7ed558ccdULL;
+        x ^= x >> 33; x *= 0xc4ceb53a185ec26bULL;
+        x ^= x >> 33;
+        return x; }
+    bool test(int g, uint64_t sig) const;
+};
+
+// Sum and xor of the hashes of the literals: both are independent of their order
+template<class Lits>
+uint64_t ClauseFilter::signature(const Lits & c) {
+    uint64_t sum = 0, xr = 0;
+    for (int i = 0; i < c.size(); i++) {
+        uint64_t h = mix(toInt(c[i]) + 1);
+        sum += h;
+        xr  ^= h;
+    }
+    return mix(sum ^ ((xr << 32) | (xr >> 32)) ^ (uint64_t) c.size());
+}
+
+}
+#endif
@@ -50,21 +50,32 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 /* ClausesBuffer
  *
  * This class is responsible for exchanging clauses between threads.
- * It is based on a fixed-length FIFO array of literals.
- * If the FIFO is full, then old clauses are removed (even if it was not yet sent to all threads)
+ * Each thread exports to its own fixed-length ring of literals, which only this thread writes;
+ * every other thread keeps its own cursor in it. If a ring is full, then old clauses are removed
+ * (even if they were not yet read by all threads) or, without -removeolder, the new clause is
+ * not exported.
  *
- * a clause " l1 l2 l3" is pushed in the FIFO with the following 6 unsigned integers
- * 3 nseen origin l1 l2 l3
+ * a clause " l1 l2 l3" is pushed in the ring with the following 4 unsigned integers
+ * 3 l1 l2 l3
  * + 3 is the size of the pushed clause
- * + nseen is the number of thread which imported this clause (initialized with nthreads-1)
- *       (when set to 0, the clause is removed from the fifo)
- * + origin is the thread id of the thread which added this clause to the fifo
  * + l1 l2 l3 are the literals of the clause
+ * The origin of a clause is the ring it was read from.
+ * Other records of words (the exploration scores of SharedCompanion) use the same layout.
  *
- * **********************************************************************************************
- * **CAREFUL** This class is not thread-safe. In glucose-syrup, the SharedCompanion is 
- * responsible for ensuring atomicity of main functions
- * **********************************************************************************************
+ * The exporting thread publishes a clause by advancing the 'head' of its ring. Before reusing
+ * words of the ring, it first moves the 'tail' past the clauses being overwritten. A reader copies
+ * the clauses up to the 'head' it saw and then checks the 'tail' again: if the tail moved past
+ * the start of the copy, some words may have been overwritten during the copy, so the copy is
+ * dropped and the reader resumes from the new tail (as a seqlock).
+ *
+ * No lock is taken: exporting is wait-free, importing reads all new clauses of a ring at once.
+ *
+ * On a NUMA machine (setNodes()), a thread only reads directly the rings of the threads of its
+ * node. The first thread of each node (its forwarder) also reads the rings of the other nodes and
+ * copies what it imports into the mirror ring of its node, tagged with the exporting thread; the
+ * other threads of the node read that mirror instead. Each clause thus crosses the interconnect
+ * once per node rather than once per thread, at the price of waiting for the next import of the
+ * forwarder. Mirrors always overwrite their oldest clauses when full.
  *
  * */
 
@@ -77,159 +88,255 @@ using namespace Glucose;
 extern BoolOption opt_whenFullRemoveOlder;
 extern IntOption  opt_fifoSizeByCore;
 
-// index : size clause
-// index + 1 : nbSeen
-// index + 2 : threadId
-// index + 3 : .. index + 3 + size : Lit of clause
-ClausesBuffer::ClausesBuffer(int _nbThreads, unsigned int _maxsize) : first(0), last(_maxsize-1),  
-    maxsize(_maxsize), queuesize(0), 
-    removedClauses(0),
-    forcedRemovedClauses(0), nbThreads(_nbThreads), 
-    whenFullRemoveOlder(opt_whenFullRemoveOlder), fifoSizeByCore(opt_fifoSizeByCore) {
-	lastOfThread.growTo(_nbThreads);
-	for(int i=0;i<nbThreads;i++) lastOfThread[i] = _maxsize-1;
-	elems.growTo(maxsize);
+ClausesBuffer::ClausesBuffer(int _nbThreads, unsigned int _maxsize) : rings(NULL), cursors(NULL), mirrors(NULL), mirrorCursors(NULL), idle(NULL), nbNodes(1),
+    capacity(0), nbThreads(0), whenFullRemoveOlder(opt_whenFullRemoveOlder), fifoSizeByCore(_maxsize / _nbThreads) {
+    setNbThreads(_nbThreads);
 } 
 
-ClausesBuffer::ClausesBuffer() : first(0), last(0), maxsize(0), queuesize(0), removedClauses(0), forcedRemovedClauses(0), nbThreads(0),
+ClausesBuffer::ClausesBuffer() : rings(NULL), cursors(NULL), mirrors(NULL), mirrorCursors(NULL), idle(NULL), nbNodes(1), capacity(0), nbThreads(0),
                                  whenFullRemoveOlder(opt_whenFullRemoveOlder), fifoSizeByCore(opt_fifoSizeByCore) {}
 
-void ClausesBuffer::setNbThreads(int _nbThreads) {
-    unsigned int _maxsize = fifoSizeByCore*_nbThreads;
-    last = _maxsize -1;
-    maxsize = _maxsize;
-    nbThreads = _nbThreads;
-    lastOfThread.growTo(_nbThreads);
-    for(int i=0;i<nbThreads;i++) lastOfThread[i] = _maxsize-1;
-    elems.growTo(maxsize);
+ClausesBuffer::~ClausesBuffer() {
+    release();
 }
 
-uint32_t ClausesBuffer::getCap() {
-    return elems.capacity();
-}
-inline unsigned int ClausesBuffer::nextIndex(unsigned int i) {
-    i++;
-    if (i == maxsize)
-	return 0;
-    return i;
+void ClausesBuffer::release() {
+    for(int i=0;i<nbThreads;i++)
+	delete [] rings[i].elems;
+    for(int i=0;mirrors != NULL && i<nbNodes;i++)
+	delete [] mirrors[i].elems;
+    delete [] rings;
+    delete [] cursors;
+    delete [] mirrors;
+    delete [] mirrorCursors;
+    delete [] idle;
+    rings = NULL; cursors = NULL; mirrors = NULL; mirrorCursors = NULL; idle = NULL;
+    nbNodes = 1;
 }
 
-inline unsigned int ClausesBuffer::addIndex(unsigned int i, unsigned int a) {
-    i += a;
-    if (i >= maxsize)
-	return i - maxsize;
-    return i;
+void ClausesBuffer::allocate(Ring & r, unsigned int cap) {
+    if (r.elems != NULL) return;
+    r.capacity = cap;
+    r.elems = new std::atomic<uint32_t>[cap];
+    for(unsigned int j=0;j<cap;j++) r.elems[j].store(0, std::memory_order_relaxed);
 }
 
-void ClausesBuffer::removeLastClause() {
-    assert(queuesize > 0);
-    do {
-	unsigned int size = (unsigned int) elems[nextIndex(last)];
-	unsigned int nextlast = addIndex(last, size+headerSize);
-
-	for(int i=0;i<nbThreads;i++) {
-	    if (lastOfThread[i] == last)
-		lastOfThread[i] = nextlast;
-	}
+// Not multithread safe: must be called before the threads start
+void ClausesBuffer::setNbThreads(int _nbThreads) {
+    release();
+    capacity = fifoSizeByCore;
+    nbThreads = _nbThreads;
+    rings = new Ring[nbThreads];
+    cursors = new Cursor[nbThreads * nbThreads];
+    idle = new std::atomic<bool>[nbThreads];
+    for(int i=0;i<nbThreads;i++) idle[i].store(false, std::memory_order_relaxed);
+    nodeOf.clear();
+    nodeOf.growTo(nbThreads, 0);
+}
 
-	// printf("Removing clause starting at %d of size %d.\n",nextIndex(last), size);
-	for(unsigned int i=0;i<size+headerSize;i++) {
-	    last = nextIndex(last);
-	    assert(queuesize > 0);
-	    queuesize --;
-	}	
-	removedClauses ++;
-	assert(last >= 0);
-	assert(last < maxsize);
-	assert(last == nextlast);
-    } while (queuesize > 0 && (elems[addIndex(last,2)] == 0)); 	
+// Not multithread safe: must be called after setNbThreads() and before the threads start
+void ClausesBuffer::setNodes(const vec<int> & nodes) {
+    assert(nodes.size() == nbThreads && mirrors == NULL);
+    nbNodes = 1;
+    for(int i=0;i<nbThreads;i++) {
+	nodeOf[i] = nodes[i];
+	if (nodes[i] + 1 > nbNodes) nbNodes = nodes[i] + 1;
+    }
+    forwarderOf.clear();
+    forwarderOf.growTo(nbNodes, -1);
+    for(int i=nbThreads-1;i>=0;i--)
+	forwarderOf[nodeOf[i]] = i;
+    if (nbNodes > 1) {
+	mirrors = new Ring[nbNodes];
+	mirrorCursors = new Cursor[nbThreads];
+    }
+}
 
+void ClausesBuffer::attach(int threadId) {
+    allocate(rings[threadId], capacity);
+    int node = nodeOf[threadId];
+    if (mirrors != NULL && forwarderOf[node] == threadId) {
+	int remote = 0;
+	for(int i=0;i<nbThreads;i++)
+	    if (nodeOf[i] != node) remote++;
+	allocate(mirrors[node], capacity * (remote > 0 ? remote : 1));
+    }
 }
 
+uint64_t ClausesBuffer::nbOverwritten() const {
+    uint64_t n = 0;
+    for(int i=0;i<nbThreads;i++)
+	n += rings[i].overwritten;
+    return n;
+}
 
-// Pushes a single uint to the fifo
-inline void ClausesBuffer::noCheckPush(uint32_t x) {
-    elems[first] = x;
-    first = nextIndex(first);
+uint64_t ClausesBuffer::memoryUsed() const {
+    uint64_t n = 0;
+    for(int i=0;i<nbThreads;i++)
+	n += (uint64_t) rings[i].capacity * sizeof(std::atomic<uint32_t>);
+    for(int i=0;mirrors != NULL && i<nbNodes;i++)
+	n += (uint64_t) mirrors[i].capacity * sizeof(std::atomic<uint32_t>);
+    return n;
 }
 
-// Pops a single uint from the fifo
-inline uint32_t ClausesBuffer::noCheckPop(uint32_t & index) {
-    index = nextIndex(index);
-    uint32_t ret = elems[index];
-    return ret;
+uint64_t ClausesBuffer::nbForwarded() const {
+    uint64_t n = 0;
+    for(int i=0;mirrors != NULL && i<nbNodes;i++)
+	n += mirrors[i].published;
+    return n;
 }
 
 
+// Writes the record 'c' to 'r', prefixed by 'origin' if it is not negative. If 'owner' is not
+// negative, 'r' is the ring of that thread and, without -removeolder, the record is dropped
+// rather than overwriting clauses that some (not idle) thread did not import yet.
+template<class Record>
+bool ClausesBuffer::write(Ring & r, const Record & c, int origin, int owner) {
+    assert(r.elems != NULL);
+    unsigned int cap = r.capacity;
+    uint32_t size = c.size() + (origin >= 0 ? 1 : 0);
+    uint64_t head = r.head.load(std::memory_order_relaxed);
+    uint64_t tail = r.tail.load(std::memory_order_relaxed);
+    uint64_t end = head + size + 1;
+    if (size + 1 > cap)
+	return false;
 
-// Return true if the clause was succesfully added
-bool ClausesBuffer::pushClause(int threadId, Clause & c) {
-    if (!whenFullRemoveOlder && (queuesize + c.size() + headerSize >= maxsize))
-	return false; // We need to remove some old clauses
-    while (queuesize + c.size() + headerSize >= maxsize) { // We need to remove some old clauses
-	forcedRemovedClauses ++;
-	removeLastClause();
-	assert(queuesize > 0);
+    if (owner >= 0 && !whenFullRemoveOlder) {
+	// Do not overwrite a clause that some thread did not import yet
+	for(int i=0;i<nbThreads;i++)
+	    if (waitsFor(i, owner) && end - cursors[i * nbThreads + owner].pos.load(std::memory_order_acquire) > cap)
+		return false;
     }
-    noCheckPush(c.size());
-    noCheckPush(nbThreads>1?nbThreads-1:1);
-    noCheckPush(threadId);
+
+    if (end - tail > cap) { // We need to remove some old clauses
+	while (end - tail > cap) {
+	    tail += r.elems[tail % cap].load(std::memory_order_relaxed) + 1;
+	    r.overwritten++;
+	}
+	r.tail.store(tail, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release); // Readers must see the tail before the new words
+    }
+
+    uint64_t pos = head;
+    r.elems[pos++ % cap].store(size, std::memory_order_relaxed);
+    if (origin >= 0)
+	r.elems[pos++ % cap].store(origin, std::memory_order_relaxed);
     for(int i=0;i<c.size();i++)
-	noCheckPush(toInt(c[i]));
-    queuesize += c.size()+headerSize;
+	r.elems[pos++ % cap].store(toWord(c[i]), std::memory_order_relaxed);
+    r.head.store(end, std::memory_order_release);
+    r.published++;
     return true;
-    //  printf(" -> (%d, %d)\n", first, last);
 }
 
-bool ClausesBuffer::getClause(int threadId, int & threadOrigin, vec<Lit> & resultClause,  bool firstFound) {
-    assert(lastOfThread.size() > threadId);
-    unsigned int thislast = lastOfThread[threadId];
-    assert(!firstFound || thislast == last); // FIXME: Gilles has this assertion on his cluster
 
-    // Early exiting
-    if (nextIndex(thislast) == first) return false;
+// Return true if the record was succesfully added
+template<class Record>
+bool ClausesBuffer::push(int threadId, const Record & c) {
+    assert(threadId < nbThreads);
+    return write(rings[threadId], c, -1, threadId);
+}
 
-    if ( ( thislast < last && last < first) ||
-	    ( first < thislast && thislast < last ) ||
-	    ( last < first && first < thislast) ) {
-	// Special case where last has moved and lastOfThread[threadId] is no more valid (is behind)
-	thislast = last; 
-    }
-    assert(!firstFound);
-    // Go to next clause for this thread id
-    if (!firstFound) { 
-	while (nextIndex(thislast) != first && elems[addIndex(thislast,3)] == ((unsigned int)threadId)) { // 3 = 2 + 1 
-	    thislast = addIndex(thislast, elems[nextIndex(thislast)] + headerSize); // 
-	    assert(thislast >= 0);
-	    assert(thislast < maxsize);
+
+// Appends the records of 'r' from 'cursor' on. If 'origin' is negative, the records carry their
+// origin (mirror rings). Returns the number of records appended.
+template<class T>
+int ClausesBuffer::read(Ring & r, std::atomic<uint64_t> & cursor, int origin, vec<T> & lits, vec<int> & sizes, vec<int> & origins) {
+    uint64_t pos = cursor.load(std::memory_order_relaxed);
+    uint64_t head = r.head.load(std::memory_order_acquire);
+    if (pos == head) return 0;
+
+    unsigned int cap = r.capacity;
+    uint32_t prefix = origin < 0 ? 1 : 0;
+    int litsBefore = lits.size(), sizesBefore = sizes.size(), originsBefore = origins.size();
+    for(;;) {
+	uint64_t tail = r.tail.load(std::memory_order_acquire);
+	if (pos < tail) pos = tail; // Clauses were overwritten before we could read them
+	uint64_t start = pos;
+
+	// Copy every clause published up to 'head'. The words may be overwritten meanwhile, so
+	// sizes are only trusted as far as they stay within the published part of the log.
+	while (pos < head) {
+	    uint32_t size = r.elems[pos % cap].load(std::memory_order_relaxed);
+	    if (size >= head - pos || size < prefix) break;
+	    origins.push(prefix ? (int) r.elems[(pos + 1) % cap].load(std::memory_order_relaxed) : origin);
+	    for(uint32_t i=prefix;i<size;i++) {
+		lits.push();
+		fromWord(r.elems[(pos + 1 + i) % cap].load(std::memory_order_relaxed), lits.last());
+	    }
+	    sizes.push(size - prefix);
+	    pos += size + 1;
 	}
-	assert(nextIndex(thislast)==first || elems[addIndex(thislast,3)] != (unsigned int)threadId);
-    }
 
-    if (nextIndex(thislast) == first) {
-	lastOfThread[threadId] = thislast;
-	return false;
-    }  
-    assert(elems[addIndex(thislast,3)] != ((unsigned int) threadId));
-    unsigned int previouslast = thislast;
-    bool removeAfter = false;
-    int csize = noCheckPop(thislast);
-    removeAfter = (--elems[addIndex(thislast,1)] == 0); // We are sure this is not one of our own clause
-    thislast = nextIndex(thislast); // Skips the removeAfter fieldr
-    threadOrigin = noCheckPop(thislast);
-    assert(threadOrigin != threadId);
-    resultClause.clear();
-    for(int i=0;i<csize;i++) {
-	resultClause.push(toLit(noCheckPop(thislast)));
+	std::atomic_thread_fence(std::memory_order_acquire);
+	if (r.tail.load(std::memory_order_relaxed) <= start) break;
+	// The owner overwrote part of what we copied: drop it and start again from its new tail
+	lits.shrink(lits.size() - litsBefore);
+	sizes.shrink(sizes.size() - sizesBefore);
+	origins.shrink(origins.size() - originsBefore);
+	pos = start;
+	head = r.head.load(std::memory_order_acquire);
     }
-    if (last == previouslast && removeAfter) {
-	removeLastClause();
-	thislast = last;
+    // The tail read above may already be past our snapshot of 'head' (the owner wrote on meanwhile):
+    // then nothing was copied and we resume from that tail.
+    assert(pos >= head);
+
+    cursor.store(pos, std::memory_order_release);
+    return sizes.size() - sizesBefore;
+}
+
+
+// A clause among the literals appended by read(), as a record for write()
+template<class T>
+struct Slice {
+    const T* lits;
+    int      n;
+    Slice(const T* l, int _n) : lits(l), n(_n) {}
+    int size() const { return n; }
+    const T & operator[](int i) const { return lits[i]; }
+};
+
+template<class T>
+int ClausesBuffer::get(int threadId, vec<T> & lits, vec<int> & sizes, vec<int> & origins) {
+    assert(threadId < nbThreads);
+    int nbClauses = 0;
+    int node = nodeOf[threadId];
+    bool forwarder = mirrors != NULL && forwarderOf[node] == threadId;
+    for(int k=1;k<nbThreads;k++) {
+	int p = (threadId + k) % nbThreads;
+	if (!readsDirectly(threadId, p)) continue;
+	int litsBefore = lits.size(), sizesBefore = sizes.size();
+	int n = read(rings[p], cursors[threadId * nbThreads + p].pos, p, lits, sizes, origins);
+	nbClauses += n;
+	if (forwarder && n > 0 && nodeOf[p] != node) {
+	    for(int i=sizesBefore, l=litsBefore;i<sizes.size();l+=sizes[i++])
+		write(mirrors[node], Slice<T>(&lits[l], sizes[i]), p, -1);
+	}
     }
-    lastOfThread[threadId] = thislast;
-    return true;
+    if (mirrors != NULL && !forwarder)
+	nbClauses += read(mirrors[node], mirrorCursors[threadId].pos, -1, lits, sizes, origins);
+    return nbClauses;
 }
 
 
-//=================================================================================================
+bool ClausesBuffer::pushClause(int threadId, Clause & c) {
+    return push(threadId, c);
+}
+
+bool ClausesBuffer::pushClause(int threadId, const vec<Lit> & c) {
+    return push(threadId, c);
+}
 
+bool ClausesBuffer::pushWords(int threadId, const vec<uint32_t> & w) {
+    return push(threadId, w);
+}
+
+int ClausesBuffer::getClauses(int threadId, vec<Lit> & lits, vec<int> & sizes, vec<int> & origins) {
+    return get(threadId, lits, sizes, origins);
+}
+
+int ClausesBuffer::getWords(int threadId, vec<uint32_t> & words, vec<int> & sizes, vec<int> & origins) {
+    return get(threadId, words, sizes, origins);
+}
+
+
+//=================================================================================================
@@ -50,6 +50,8 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 #ifndef ClausesBuffer_h 
 #define ClausesBuffer_h
 
+#include <atomic>
+
 #include "mtl/Vec.h"
 #include "core/SolverTypes.h"
 #include "core/Solver.h"
@@ -57,55 +59,100 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 //=================================================================================================
 
 namespace Glucose {
-    // index : size clause
-    // index + 1 : nbSeen
-    // index + 2 : threadId
-    // index + 3 : .. index + 3 + size : Lit of clause
+    // One ring per exporting thread. A clause (or any record of words) is stored at a position 'p'
+    // of the log of its thread:
+    // p     : size of the clause
+    // p + 1 : .. p + size : Lit of clause
+    // Positions grow forever; the word at position p lives in elems[p % capacity].
+    //
+    // On a NUMA machine (see setNodes()), each node also has a mirror ring. Its records are
+    // prefixed by the thread that exported them:
+    // p     : size of the clause + 1
+    // p + 1 : exporting thread
+    // p + 2 : .. p + size + 1 : Lit of clause
     class ClausesBuffer {
-	vec<uint32_t>  elems;
-	unsigned int     first;
-	unsigned int	 last;
-	unsigned int     maxsize;
-	unsigned int     queuesize; // Number of current elements (must be < maxsize !)
-	unsigned int     removedClauses;
-	unsigned int     forcedRemovedClauses;
-        static const int  headerSize = 3;
-	int       nbThreads;
-	bool      whenFullRemoveOlder;
+	struct Ring {
+	    std::atomic<uint32_t>* elems;
+	    std::atomic<uint64_t>  head;     // End of the last published clause
+	    std::atomic<uint64_t>  tail;     // Start of the oldest clause not (partially) overwritten
+	    uint64_t               overwritten; // Clauses dropped before every thread imported them (owner only)
+	    uint64_t               published;   // Clauses written (owner only)
+	    unsigned int           capacity;    // Words in elems
+	    char                   pad[64];  // Keeps the rings of different threads on different cache lines
+	    Ring() : elems(NULL), head(0), tail(0), overwritten(0), published(0), capacity(0) {}
+	};
+	struct Cursor {
+	    std::atomic<uint64_t>  pos;      // Next position to import from one ring (written by its reader only)
+	    char                   pad[56];
+	    Cursor() : pos(0) {}
+	};
+
+	Ring*        rings;
+	Cursor*      cursors;   // cursors[reader * nbThreads + producer]
+	Ring*        mirrors;   // mirrors[node], written by the forwarder of the node (NULL on one node)
+	Cursor*      mirrorCursors; // mirrorCursors[reader]: position in the mirror of its node
+	vec<int>     nodeOf;    // NUMA node of each thread
+	vec<int>     forwarderOf; // Thread forwarding the clauses of the other nodes to each node
+	std::atomic<bool>* idle; // idle[reader]: the thread does not import for now (paused or retired)
+	int          nbNodes;
+	unsigned int capacity;  // Words in each ring
+	int          nbThreads;
+	bool         whenFullRemoveOlder;
 	unsigned int fifoSizeByCore;
-	vec<unsigned int> lastOfThread; // Last value for a thread 
+
+	void release();
+	void allocate(Ring & r, unsigned int cap);
+	bool waitsFor(int reader, int producer) const { // Must not be overwritten before 'reader' imports it
+	    return reader != producer && readsDirectly(reader, producer) && !idle[reader].load(std::memory_order_relaxed); }
+	bool readsDirectly(int reader, int producer) const {
+	    return nbNodes <= 1 || nodeOf[reader] == nodeOf[producer] || forwarderOf[nodeOf[reader]] == reader; }
+	template<class Record> bool write(Ring & r, const Record & c, int origin, int owner);
+	template<class Record> bool push(int threadId, const Record & r);
+	template<class T>      int  read(Ring & r, std::atomic<uint64_t> & cursor, int origin, vec<T> & words, vec<int> & sizes, vec<int> & origins);
+	template<class T>      int  get (int threadId, vec<T> & words, vec<int> & sizes, vec<int> & origins);
 
 	public:
 	ClausesBuffer(int _nbThreads, unsigned int _maxsize);
 	ClausesBuffer();
+	~ClausesBuffer();
 
+	// Not multithread safe: must be called before the threads start. setNbThreads() forgets the
+	// nodes given to setNodes(); without them all threads read all rings directly.
 	void setNbThreads(int _nbThreads);
-	unsigned int nextIndex(unsigned int i);
-	unsigned int addIndex(unsigned int i, unsigned int a); 
-	void removeLastClause(); 
-	   
-	void noCheckPush(uint32_t x);
-	uint32_t noCheckPop(unsigned int & index);
-
-	// Return true if the clause was succesfully added
-        bool pushClause(int threadId, Clause & c);
-        bool getClause(int threadId, int & threadOrigin, vec<Lit> & resultClause, bool firstFound = false); 
-	
-	int maxSize() const {return maxsize;}
-        uint32_t getCap();
-	void growTo(int size) {
-	    assert(0); // Not implemented (essentially for efficiency reasons)
-	    elems.growTo(size); 
-	    first=0; maxsize=size; queuesize = 0;last = 0;
-	    for(int i=0;i<size;i++) elems[i]=0; 
-	}
-
-	void fastclear() {first = 0; last = 0; queuesize=0; } 
-
-	int  size(void)    { return queuesize; }
-
-	void clear(bool dealloc = false)   { elems.clear(dealloc); first = 0; maxsize=0; queuesize=0;}
-	inline  int  toInt     (Lit p)              { return p.x; } 
+	void setNodes(const vec<int> & nodes);
+
+	// Allocates the ring of 'threadId' (and the mirror of its node if it forwards to it). Called by
+	// the thread itself before it exports anything, so that the memory is local to its node.
+	void attach(int threadId);
+
+	// An idle thread does not hold back the exporting threads: what it misses while idle may be
+	// overwritten before it imports again.
+	void setIdle(int threadId, bool b) {idle[threadId].store(b, std::memory_order_relaxed);}
+
+	// Return true if the clause was succesfully added. Only thread 'threadId' writes its ring:
+	// this never blocks nor waits for the importing threads.
+	bool pushClause(int threadId, Clause & c);
+	bool pushClause(int threadId, const vec<Lit> & c);
+	bool pushWords (int threadId, const vec<uint32_t> & w);
+
+	// Appends all clauses exported by the other threads since the last call: their literals
+	// to 'lits', their sizes to 'sizes' and the exporting threads to 'origins'. Returns the
+	// number of clauses appended.
+	int  getClauses(int threadId, vec<Lit> & lits, vec<int> & sizes, vec<int> & origins);
+	int  getWords  (int threadId, vec<uint32_t> & words, vec<int> & sizes, vec<int> & origins);
+
+	// Records that some thread never reads must not block the exporting threads
+	void setRemoveOlder(bool b) {whenFullRemoveOlder = b;}
+
+	int maxSize() const {return capacity * nbThreads;}
+	uint64_t nbOverwritten() const;
+	uint64_t nbForwarded() const;   // Clauses copied to the mirror of another node
+	uint64_t memoryUsed() const;    // Bytes of the rings allocated so far
+
+	static inline uint32_t toWord(Lit p)      { return p.x; }
+	static inline uint32_t toWord(uint32_t w) { return w; }
+	static inline void fromWord(uint32_t w, Lit & p)      { p = toLit(w); }
+	static inline void fromWord(uint32_t w, uint32_t & x) { x = w; }
 
     };
 }
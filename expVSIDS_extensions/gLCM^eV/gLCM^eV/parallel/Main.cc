@@ -58,6 +58,7 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 #include "utils/Options.h"
 #include "core/Dimacs.h"
 #include "core/SolverTypes.h"
+#include "core/ModelWriter.h"
 
 #include "simp/SimpSolver.h"
 #include "parallel/ParallelSolver.h"
@@ -237,13 +238,7 @@ int main(int argc, char** argv)
 	  printf(ret == l_True ? "s SATISFIABLE\n" : ret == l_False ? "s UNSATISFIABLE\n" : "s INDETERMINATE\n");
 	  
 	  if(msolver.getShowModel() && ret==l_True) {
-	    printf("v ");
-	    for (int i = 0; i < msolver.model.size() ; i++) {
-                assert(msolver.model[i] != l_Undef);
-                if (msolver.model[i] != l_Undef)
-		printf("%s%s%d", (i==0)?"":" ", (msolver.model[i]==l_True)?"":"-", i+1);
-            }
-	    printf(" 0\n");
+	    writeModel(stdout, msolver.model, "v ");
 	  }
 
      
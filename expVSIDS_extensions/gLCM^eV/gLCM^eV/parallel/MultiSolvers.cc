@@ -64,12 +64,27 @@ extern const char *_cunstable;
 static IntOption opt_nbsolversmultithreads(_parallel, "nthreads", "Number of core threads for syrup (0 for automatic)", 0);
 static IntOption opt_maxnbsolvers(_parallel, "maxnbthreads", "Maximum number of core threads to ask for (when nbthreads=0)", 4);
 static IntOption opt_maxmemory(_parallel, "maxmemory", "Maximum memory to use (in Mb, 0 for no software limit)", 20000);
+static IntOption opt_memShrink(_parallel, "mem-shrink", "Percentage of maxmemory from which the threads reduce their learnt clauses", 80, IntRange(0, 100));
+static IntOption opt_memPause(_parallel, "mem-pause", "Percentage of maxmemory from which the largest threads are paused (then retired above maxmemory)", 95, IntRange(0, 100));
 static IntOption opt_statsInterval(_parallel, "statsinterval", "Seconds (real time) between two stats reports", 5);
 //
 // Shared with ClausesBuffer.cc
 BoolOption opt_whenFullRemoveOlder(_parallel, "removeolder", "When the FIFO for exchanging clauses between threads is full, remove older clauses", false);
 IntOption opt_fifoSizeByCore(_parallel, "fifosize", "Size of the FIFO structure for exchanging clauses between threads, by threads", 100000);
 //
+// Shared with SolverConfiguration.cc and ParallelSolver.cc
+DoubleOption opt_explorers(_parallel, "explorers", "Fraction of the threads running exploration episodes and sharing their scores", 1.0, DoubleRange(0, true, 1, true));
+DoubleOption opt_expConsumers(_parallel, "exp-consumers", "Fraction of the threads that do not explore but use the shared exploration scores", 0.5, DoubleRange(0, true, 1, true));
+IntOption opt_dupFilter(_parallel, "dup-filter", "Bits (log2) of each generation of the duplicate clause filters of a thread (0: no filter)", 18, IntRange(0, 32));
+IntOption opt_expShareLBD(_parallel, "exp-share-lbd", "Share the conflicts of random walks up to this LBD (0: none)", 2, IntRange(0, INT32_MAX));
+static StringOption opt_pin(_parallel, "pin", "Bind the threads to CPUs: none, compact (fill the NUMA nodes one after the other) or scatter (round-robin over the nodes)", "none");
+static BoolOption opt_numaForward(_parallel, "numa-forward", "When pinned threads span several NUMA nodes, import the clauses of the other nodes through one thread per node", true);
+static BoolOption opt_expPortfolio(_parallel, "exp-portfolio", "Give each exploring thread different exploration parameters", false);
+BoolOption opt_deterministic(_parallel, "det", "Deterministic mode: the threads exchange clauses at conflict-count barriers, in thread order (no memory control nor exp-realloc)", false);
+IntOption opt_detInterval(_parallel, "det-interval", "Conflicts of each thread between two barriers of the deterministic mode", 2000, IntRange(1, INT32_MAX));
+IntOption opt_importInterval(_parallel, "import-interval", "Conflicts after which a restart goes back to level 0 to import clauses", 5000, IntRange(0, INT32_MAX));
+static IntOption opt_expRealloc(_parallel, "exp-realloc", "Seconds (real time) between two reallocations of the exploration parameters, checked every 5 s (0: never)", 0, IntRange(0, INT32_MAX));
+//
 // Shared options with Solver.cc 
 BoolOption opt_dontExportDirectReusedClauses(_cunstable, "reusedClauses", "Don't export directly reused clauses", false);
 BoolOption opt_plingeling(_cunstable, "plingeling", "plingeling strategy for sharing clauses (exploratory feature)", false);
@@ -86,6 +101,13 @@ static inline double cpuTime(void) {
 }
 
 
+static inline double realTime(void) {
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return (double) tv.tv_sec + (double) tv.tv_usec / 1000000;
+}
+
+
 void MultiSolvers::informEnd(lbool res) {
     result = res;
     pthread_cond_broadcast(&cfinished);
@@ -96,8 +118,16 @@ MultiSolvers::MultiSolvers(ParallelSolver *s) :
         use_simplification(true), ok(true), maxnbthreads(4), nbthreads(opt_nbsolversmultithreads), nbsolvers(opt_nbsolversmultithreads), nbcompanions(4), nbcompbysolver(2),
         allClonesAreBuilt(0), showModel(false), winner(-1), var_decay(1 / 0.95), clause_decay(1 / 0.999), cla_inc(1), var_inc(1), random_var_freq(0.02), restart_first(100),
         restart_inc(1.5), learntsize_factor((double) 1 / (double) 3), learntsize_inc(1.1), expensive_ccmin(true), polarity_mode(polarity_false), maxmemory(opt_maxmemory),
-        maxnbsolvers(opt_maxnbsolvers), verb(0), verbEveryConflicts(10000), numvar(0), numclauses(0) {
+        maxnbsolvers(opt_maxnbsolvers), verb(0), verbEveryConflicts(10000), numvar(0), numclauses(0),
+        deterministic(opt_deterministic), pinThreads(strcmp(opt_pin, "none") != 0), scatterThreads(strcmp(opt_pin, "scatter") == 0), searchStart(0) {
     result = l_Undef;
+    if(pinThreads && !scatterThreads && strcmp(opt_pin, "compact") != 0) {
+        fprintf(stderr, "ERROR! value <%s> is invalid for option \"pin\" (none, compact or scatter).\n", (const char *) opt_pin);
+        exit(1);
+    }
+    // The primary solver is built (and the formula loaded) by this thread: keep it where thread 0 will run
+    if(pinThreads)
+        NumaTopology::pinCurrentThread(topology.cpuOfThread(0, scatterThreads));
     SharedCompanion *sc = new SharedCompanion();
     this->sharedcomp = sc;
 
@@ -131,6 +161,10 @@ MultiSolvers::~MultiSolvers() { }
 
 /**
  * Generate All solvers
+ *
+ * Solver i > 0 is a clone of solver 0 built by thread i itself (see threadMain()), so that its
+ * memory is first touched, and thus allocated, on the NUMA node of that thread. Here the clones
+ * are registered once all of them are built.
  */
 
 void MultiSolvers::generateAllSolvers() {
@@ -138,7 +172,8 @@ void MultiSolvers::generateAllSolvers() {
     assert(allClonesAreBuilt == 0);
 
     for(int i = 1; i < nbsolvers; i++) {
-        ParallelSolver *s = (ParallelSolver *) solvers[0]->clone();
+        ParallelSolver *s = clones[i];
+        assert(s != NULL);
         solvers.push(s);
         s->verbosity = 0; // No reportf in solvers... All is done in MultiSolver
         s->setThreadNumber(i);
@@ -251,11 +286,62 @@ bool MultiSolvers::eliminate() {
 }
 
 
+/**
+ * Pinning: thread i gets the i-th CPU of the chosen policy, and the clause buffers learn the NUMA
+ * node of each thread so that each node imports the clauses of the other nodes only once.
+ * Without -pin, threads may migrate and all of them are taken to share one node.
+ */
+
+void MultiSolvers::placeThreads() {
+    vec<int> nodes(nbsolvers, 0);
+    cpuOfThread.clear();
+    cpuOfThread.growTo(nbsolvers, -1);
+    if(!pinThreads) return;
+
+    vec<int> threadsOfNode(topology.nbNodes(), 0);
+    for(int i = 0; i < nbsolvers; i++) {
+        cpuOfThread[i] = topology.cpuOfThread(i, scatterThreads);
+        nodes[i] = topology.nodeOfCpu(cpuOfThread[i]);
+        threadsOfNode[nodes[i]]++;
+    }
+    if(opt_numaForward)
+        sharedcomp->setNodes(nodes);
+
+    if(verb >= 1) {
+        printf("c |  Threads pinned (%s) on %d CPUs of %d NUMA node(s), threads by node:", (const char *) opt_pin, topology.nbCpus(), topology.nbNodes());
+        for(int n = 0; n < topology.nbNodes(); n++)
+            printf(" %d", threadsOfNode[n]);
+        printf("\n");
+    }
+}
+
+
+void MultiSolvers::threadMain(int i) {
+    if(pinThreads && !NumaTopology::pinCurrentThread(cpuOfThread[i]))
+        printf("c WARNING! Could not bind thread %d to CPU %d.\n", i, cpuOfThread[i]);
+    if(i > 0)
+        clones[i] = (ParallelSolver *) solvers[0]->clone();
+    sharedcomp->attachThread(i);
+
+    pthread_barrier_wait(&startBarrier); // All clones are built...
+    pthread_barrier_wait(&startBarrier); // ... and configured
+
+    double start = realTime();
+    (void) solvers[i]->solve();
+    searchTime[i] = realTime() - start;
+}
+
+
+struct ThreadLaunch {
+    MultiSolvers *ms;
+    int id;
+};
+
 // TODO: Use a template here
 void *localLaunch(void *arg) {
-    ParallelSolver *s = (ParallelSolver *) arg;
+    ThreadLaunch *l = (ThreadLaunch *) arg;
 
-    (void) s->solve();
+    l->ms->threadMain(l->id);
 
     pthread_exit(NULL);
 }
@@ -269,9 +355,9 @@ void MultiSolvers::printStats() {
     double cpu_time = cpuTime();
     printf("c\n");
 
-    printf("c |-------------------------------------------------------------------------------------------------------|\n");
-    printf("c | id | starts | decisions  |  confls    |  Init T  |  learnts | exported | imported | promoted |    %%   | \n");
-    printf("c |-------------------------------------------------------------------------------------------------------|\n");
+    printf("c |-----------------------------------------------------------------------------------------------------------------|\n");
+    printf("c | id | starts | decisions  |  confls    |  Init T  |  learnts | exported | imported | promoted |    %%   |   Mb    | \n");
+    printf("c |-----------------------------------------------------------------------------------------------------------------|\n");
 
     //printf("%.0fs | ",cpu_time);
     for(int i = 0; i < solvers.size(); i++) {
@@ -352,6 +438,29 @@ void MultiSolvers::printFinalStats() {
         printf("| %10" PRIu64" ", solvers[i]->propagations);
     printf("|\n");
 
+    //--
+    printf("c | Props/sec     ");
+    double totalrate = 0;
+    vec<double> rate(solvers.size(), 0);
+    for(int i = 0; i < solvers.size(); i++) {
+        double t = i < searchTime.size() && searchTime[i] > 0 ? searchTime[i] : realTime() - searchStart;
+        if(searchStart > 0 && t > 0) rate[i] = solvers[i]->propagations / t;
+        totalrate += rate[i];
+    }
+    printf("| %15.0f ", totalrate);
+
+    for(int i = 0; i < solvers.size(); i++)
+        printf("| %10.0f ", rate[i]);
+    printf("|\n");
+
+    //--
+    printf("c | Memory (Mb)   ");
+    printf("| %15.1f ", accountedMemory());
+
+    for(int i = 0; i < solvers.size(); i++)
+        printf("| %10.1f ", solvers[i]->memoryFootprint() / (1024.0 * 1024));
+    printf("|\n");
+
 
     printf("c | Avg_Trail     ");
     printf("|                 ");
@@ -387,6 +496,48 @@ void MultiSolvers::printFinalStats() {
         printf("|------------");
     printf("|\n");
 
+    printf("c | Restarts      ");
+    uint64_t restarts = 0;
+    for(int i = 0; i < solvers.size(); i++)
+        restarts += solvers[i]->starts;
+    printf("| %15" PRIu64" ", restarts);
+    for(int i = 0; i < solvers.size(); i++)
+        printf("| %10" PRIu64" ", solvers[i]->starts);
+    printf("|\n");
+//--
+    printf("c | Reuse_Restarts");
+    uint64_t reusedRestarts = 0;
+    for(int i = 0; i < solvers.size(); i++)
+        reusedRestarts += solvers[i]->reused_restarts;
+    printf("| %15" PRIu64" ", reusedRestarts);
+    for(int i = 0; i < solvers.size(); i++)
+        printf("| %10" PRIu64" ", solvers[i]->reused_restarts);
+    printf("|\n");
+//--
+    printf("c | Reuse_Levels  ");
+    uint64_t reusedLevels = 0;
+    for(int i = 0; i < solvers.size(); i++)
+        reusedLevels += solvers[i]->reused_levels;
+    printf("| %15" PRIu64" ", reusedLevels);
+    for(int i = 0; i < solvers.size(); i++)
+        printf("| %10" PRIu64" ", solvers[i]->reused_levels);
+    printf("|\n");
+//--
+    printf("c | Reuse_Props   ");
+    uint64_t reusedProps = 0;
+    for(int i = 0; i < solvers.size(); i++)
+        reusedProps += solvers[i]->reused_props;
+    printf("| %15" PRIu64" ", reusedProps);
+    for(int i = 0; i < solvers.size(); i++)
+        printf("| %10" PRIu64" ", solvers[i]->reused_props);
+    printf("|\n");
+//--
+
+    printf("c |---------------|-----------------");
+    for(int i = 0; i < solvers.size(); i++)
+        printf("|------------");
+    printf("|\n");
+
     printf("c | Exported      ");
     uint64_t exported = 0;
     for(int i = 0; i < solvers.size(); i++)
@@ -456,6 +607,102 @@ void MultiSolvers::printFinalStats() {
         printf("| %10" PRIu64" ", solvers[i]->nbNotExportedBecauseDirectlyReused);
     printf("|\n");
 //--
+
+    printf("c | Dup_Imported  ");
+    uint64_t dupImported = 0;
+    for(int i = 0; i < solvers.size(); i++)
+        dupImported += solvers[i]->stats[nbImportDuplicates];
+    printf("| %15" PRIu64" ", dupImported);
+    for(int i = 0; i < solvers.size(); i++)
+        printf("| %10" PRIu64" ", solvers[i]->stats[nbImportDuplicates]);
+    printf("|\n");
+//--
+
+    printf("c | Dup_Saved_KB  ");
+    uint64_t dupWords = 0;
+    for(int i = 0; i < solvers.size(); i++)
+        dupWords += solvers[i]->stats[nbImportDuplicateWords];
+    printf("| %15" PRIu64" ", dupWords * sizeof(uint32_t) / 1024);
+    for(int i = 0; i < solvers.size(); i++)
+        printf("| %10" PRIu64" ", solvers[i]->stats[nbImportDuplicateWords] * sizeof(uint32_t) / 1024);
+    printf("|\n");
+//--
+
+    printf("c | Dup_Exported  ");
+    uint64_t dupExported = 0;
+    for(int i = 0; i < solvers.size(); i++)
+        dupExported += solvers[i]->stats[nbExportDuplicates];
+    printf("| %15" PRIu64" ", dupExported);
+    for(int i = 0; i < solvers.size(); i++)
+        printf("| %10" PRIu64" ", solvers[i]->stats[nbExportDuplicates]);
+    printf("|\n");
+//--
+    printf("c |---------------|-----------------");
+    for(int i = 0; i < solvers.size(); i++)
+        printf("|------------");
+    printf("|\n");
+
+    if(deterministic) {
+        printf("c | Barriers      ");
+        printf("| %15" PRIu64" ", solvers.size() > 0 ? solvers[0]->stats[nbBarriers] : 0);
+        for(int i = 0; i < solvers.size(); i++)
+            printf("| %10" PRIu64" ", solvers[i]->stats[nbBarriers]);
+        printf("|\n");
+//--
+        printf("c | Barrier_wait_s");
+        double wait = 0;
+        for(int i = 0; i < solvers.size(); i++)
+            wait += solvers[i]->barrierWait;
+        printf("| %15.2f ", wait);
+        for(int i = 0; i < solvers.size(); i++)
+            printf("| %10.2f ", solvers[i]->barrierWait);
+        printf("|\n");
+//--
+        printf("c |---------------|-----------------");
+        for(int i = 0; i < solvers.size(); i++)
+            printf("|------------");
+        printf("|\n");
+    }
+
+    printf("c | Exp_Episodes  ");
+    uint64_t episodes = 0;
+    for(int i = 0; i < solvers.size(); i++)
+        episodes += solvers[i]->numExpEpisodes;
+    printf("| %15" PRIu64" ", episodes);
+    for(int i = 0; i < solvers.size(); i++)
+        printf("| %10" PRIu64" ", solvers[i]->numExpEpisodes);
+    printf("|\n");
+//--
+
+    printf("c | Exp_Scores_Out");
+    uint64_t scoresOut = 0;
+    for(int i = 0; i < solvers.size(); i++)
+        scoresOut += solvers[i]->stats[nbexportedExpScores];
+    printf("| %15" PRIu64" ", scoresOut);
+    for(int i = 0; i < solvers.size(); i++)
+        printf("| %10" PRIu64" ", solvers[i]->stats[nbexportedExpScores]);
+    printf("|\n");
+//--
+
+    printf("c | Exp_Scores_In ");
+    uint64_t scoresIn = 0;
+    for(int i = 0; i < solvers.size(); i++)
+        scoresIn += solvers[i]->stats[nbimportedExpScores];
+    printf("| %15" PRIu64" ", scoresIn);
+    for(int i = 0; i < solvers.size(); i++)
+        printf("| %10" PRIu64" ", solvers[i]->stats[nbimportedExpScores]);
+    printf("|\n");
+//--
+
+    printf("c | Walk_Shared   ");
+    uint64_t walkShared = 0;
+    for(int i = 0; i < solvers.size(); i++)
+        walkShared += solvers[i]->stats[nbexportedWalkConflicts];
+    printf("| %15" PRIu64" ", walkShared);
+    for(int i = 0; i < solvers.size(); i++)
+        printf("| %10" PRIu64" ", solvers[i]->stats[nbexportedWalkConflicts]);
+    printf("|\n");
+//--
     printf("c |---------------|-----------------");
     for(int i = 0; i < solvers.size(); i++)
         printf("|------------");
@@ -580,11 +827,127 @@ void MultiSolvers::printFinalStats() {
 // Well, all those parameteres are just naive guesses... No experimental evidences for this.
 void MultiSolvers::adjustParameters() {
     SolverConfiguration::configure(this, nbsolvers);
+    SolverConfiguration::configureExploration(this, nbsolvers);
+    if(opt_expPortfolio)
+        SolverConfiguration::configureExplorationPortfolio(this, nbsolvers);
+    for(int i = 0; i < nbsolvers; i++) {
+        ParallelSolver::ExplorationParams p = {solvers[i]->mWDefault, solvers[i]->mSDefault, solvers[i]->prThDefault, solvers[i]->expStepDecay};
+        solvers[i]->expParams = p;
+    }
+}
+
+
+/**
+ * Rank the exploring threads by the number of conflicts per second divided by the average LBD of
+ * their learnt clauses since the last call, then copy the exploration parameters of the best
+ * quarter to the worst quarter. The new parameters are posted to each receiving thread, which
+ * takes them over at its next restart to level 0 (see ParallelSolver::applyPostedExploration());
+ * a thread that has not taken the previous ones yet is skipped.
+ */
+
+struct productivity_gt {
+    const vec<double>& score;
+    productivity_gt(const vec<double>& s) : score(s) {}
+    bool operator()(int x, int y) const { return score[x] > score[y]; }
+};
+
+void MultiSolvers::reallocateExploration(double elapsed) {
+    vec<int> explorers;
+    vec<double> score(nbsolvers, 0);
+    for(int i = 0; i < nbsolvers; i++) {
+        uint64_t conflicts = solvers[i]->conflicts, totalLBD = solvers[i]->totalLBD;
+        uint64_t dconf = conflicts - lastConflicts[i], dlbd = totalLBD - lastTotalLBD[i];
+        lastConflicts[i] = conflicts;
+        lastTotalLBD[i] = totalLBD;
+        if(!solvers[i]->exploration) continue;
+        explorers.push(i);
+        if(dconf > 0 && dlbd > 0)
+            score[i] = (dconf / elapsed) / ((double) dlbd / dconf);
+    }
+    if(explorers.size() < 2) return;
+
+    sort(explorers, productivity_gt(score));
+    int moves = explorers.size() / 4 > 0 ? explorers.size() / 4 : 1;
+    for(int k = 0; k < moves; k++) {
+        ParallelSolver *from = solvers[explorers[k]], *to = solvers[explorers[explorers.size() - 1 - k]];
+        if(score[explorers[k]] <= score[explorers[explorers.size() - 1 - k]]) break;
+        if(to->expPostedSet.load(std::memory_order_acquire)) continue;
+        to->expParams = from->expParams;
+        to->expPosted = from->expParams;
+        to->expPostedSet.store(true, std::memory_order_release);
+        if(verb >= 1)
+            printf("c exploration parameters of thread %d (mW=%u mS=%u prTh=%u decay=%.2f) copied to thread %d\n",
+                   explorers[k], from->expParams.mW, from->expParams.mS, from->expParams.prTh, from->expParams.decay, explorers[explorers.size() - 1 - k]);
+    }
+}
+
+
+/**
+ * Memory accounting: each solver measures its own footprint (see ParallelSolver::accountMemory()),
+ * which, unlike memUsed() (the virtual size of the whole process), tells which thread holds the
+ * memory and drops as soon as a thread gives clauses back.
+ */
+
+double MultiSolvers::accountedMemory() {
+    uint64_t bytes = sharedcomp->memoryUsed();
+    for(int i = 0; i < solvers.size(); i++)
+        bytes += solvers[i]->memoryFootprint();
+    return bytes / (1024.0 * 1024);
+}
+
+
+/**
+ * Memory control, called by the main thread between two stats reports. Above mem-shrink% of
+ * maxmemory, every running thread reduces its learnt clauses (once per call); above mem-pause%,
+ * the running thread holding the most memory is also paused; above maxmemory, if some thread is
+ * already paused, the largest paused one is retired: it gives its clauses back and leaves the
+ * search. Below mem-shrink%, the smallest paused thread is resumed. One thread always keeps running.
+ */
+
+void MultiSolvers::controlMemory(double mem) {
+    if(maxmemory == 0) return;
+    int running = 0, largestRunning = -1, largestPaused = -1, smallestPaused = -1;
+    for(int i = 0; i < solvers.size(); i++) {
+        int control = solvers[i]->memoryControl.load(std::memory_order_relaxed);
+        uint64_t footprint = solvers[i]->memoryFootprint();
+        if(control == ParallelSolver::memRun) {
+            running++;
+            if(largestRunning < 0 || footprint > solvers[largestRunning]->memoryFootprint()) largestRunning = i;
+        } else if(control == ParallelSolver::memPause) {
+            if(largestPaused < 0 || footprint > solvers[largestPaused]->memoryFootprint()) largestPaused = i;
+            if(smallestPaused < 0 || footprint < solvers[smallestPaused]->memoryFootprint()) smallestPaused = i;
+        }
+    }
+
+    if(mem < maxmemory * opt_memShrink / 100.0) {
+        if(smallestPaused >= 0) {
+            solvers[smallestPaused]->memoryControl.store(ParallelSolver::memRun, std::memory_order_relaxed);
+            if(verb >= 1) printf("c memory %.2fMb: thread %d resumed\n", mem, smallestPaused);
+        }
+        return;
+    }
+
+    for(int i = 0; i < solvers.size(); i++)
+        if(solvers[i]->memoryControl.load(std::memory_order_relaxed) == ParallelSolver::memRun)
+            solvers[i]->shrinkRequests.fetch_add(1, std::memory_order_relaxed);
+
+    if(mem >= maxmemory && largestPaused >= 0) {
+        solvers[largestPaused]->memoryControl.store(ParallelSolver::memRetire, std::memory_order_relaxed);
+        if(verb >= 1) printf("c memory %.2fMb: retiring thread %d (%.2fMb)\n", mem, largestPaused, solvers[largestPaused]->memoryFootprint() / (1024.0 * 1024));
+    } else if(mem >= maxmemory * opt_memPause / 100.0 && running > 1) {
+        solvers[largestRunning]->memoryControl.store(ParallelSolver::memPause, std::memory_order_relaxed);
+        if(verb >= 1) printf("c memory %.2fMb: pausing thread %d (%.2fMb)\n", mem, largestRunning, solvers[largestRunning]->memoryFootprint() / (1024.0 * 1024));
+    } else if(verb >= 1)
+        printf("c memory %.2fMb: threads asked to reduce their learnt clauses\n", mem);
 }
 
 
 void MultiSolvers::adjustNumberOfCores() {
-    float mem = memUsed();
+    // The memory of one solver, as accounted once the formula is loaded (the memory of the whole
+    // process also counts the parser and the simplifier)
+    solvers[0]->accountMemory(true);
+    float mem = solvers[0]->memoryFootprint() / (1024.0 * 1024);
+    if(mem < 1) mem = 1;
     if(nbthreads == 0) { // Automatic configuration
         if(verb >= 1)
             printf("c |  Automatic Adjustement of the number of solvers. MaxMemory=%5d, MaxCores=%3d.                       |\n", maxmemory, maxnbsolvers);
@@ -607,14 +970,7 @@ lbool MultiSolvers::solve() {
 
     adjustNumberOfCores();
     sharedcomp->setNbThreads(nbsolvers);
-    if(verb >= 1)
-        printf("c |  Generating clones                                                                                    |\n");
-    generateAllSolvers();
-    if(verb >= 1) {
-        printf("c |  all clones generated. Memory = %6.2fMb.                                                             |\n", memUsed());
-        printf("c ========================================================================================================|\n");
-    }
-
+    placeThreads();
 
     model.clear();
 
@@ -622,37 +978,70 @@ lbool MultiSolvers::solve() {
     pthread_attr_init(&thAttr);
     pthread_attr_setdetachstate(&thAttr, PTHREAD_CREATE_JOINABLE);
 
-
-
-    // Launching all solvers
+    // Launching all threads: each one builds its clone, then waits until all are configured
+    if(verb >= 1)
+        printf("c |  Generating clones                                                                                    |\n");
+    vec<ThreadLaunch> launch(nbsolvers);
+    clones.growTo(nbsolvers, NULL);
+    searchTime.growTo(nbsolvers, 0);
+    pthread_barrier_init(&startBarrier, NULL, nbsolvers + 1);
     for(i = 0; i < nbsolvers; i++) {
         pthread_t *pt = (pthread_t *) malloc(sizeof(pthread_t));
         threads.push(pt);
+        launch[i].ms = this;
+        launch[i].id = i;
+        pthread_create(threads[i], &thAttr, &localLaunch, (void *) &launch[i]);
+    }
+
+    pthread_barrier_wait(&startBarrier);
+    generateAllSolvers();
+    for(i = 0; i < nbsolvers; i++) {
         solvers[i]->pmfinished = &mfinished;
         solvers[i]->pcfinished = &cfinished;
-        pthread_create(threads[i], &thAttr, &localLaunch, (void *) solvers[i]);
     }
+    if(verb >= 1) {
+        printf("c |  all clones generated. Memory = %6.2fMb.                                                             |\n", memUsed());
+        printf("c ========================================================================================================|\n");
+    }
+    if(verb >= 1 && deterministic)
+        printf("c |  Deterministic mode: the threads exchange clauses every %d conflicts.\n", (int) opt_detInterval);
+    searchStart = realTime();
+    pthread_barrier_wait(&startBarrier);
 
     bool done = false;
     bool adjustedlimitonce = false;
+    time_t lastRealloc = time(NULL);
+    lastConflicts.growTo(nbsolvers, 0);
+    lastTotalLBD.growTo(nbsolvers, 0);
 
-    (void) pthread_mutex_lock(&m);
+    // A thread may finish before we first wait (the signal is then lost), so the job status is
+    // checked too, with 'mfinished' held as the wait requires.
+    (void) pthread_mutex_lock(&mfinished);
     while(!done) {
         struct timespec timeout;
         time(&timeout.tv_sec);
         timeout.tv_sec += MAXIMUM_SLEEP_DURATION;
         timeout.tv_nsec = 0;
-        if(pthread_cond_timedwait(&cfinished, &mfinished, &timeout) != ETIMEDOUT)
+        if(sharedcomp->jobFinished() || pthread_cond_timedwait(&cfinished, &mfinished, &timeout) != ETIMEDOUT)
             done = true;
         else
             printStats();
 
         float mem = memUsed();
-        if(verb >= 1) printf("c Total Memory so far : %.2fMb\n", mem);
-        if((maxmemory > 0) && (mem > maxmemory) && !sharedcomp->panicMode)
+        double accounted = accountedMemory();
+        if(verb >= 1) printf("c Total Memory so far : %.2fMb (solvers and shared buffers: %.2fMb)\n", mem, accounted);
+        // In deterministic mode, nothing that depends on timing may change the search
+        if((maxmemory > 0) && (mem > maxmemory) && !sharedcomp->panicMode && !deterministic)
             printf("c ** reduceDB switching to Panic Mode due to memory limitations !\n"), sharedcomp->panicMode = true;
+        if(!done && !deterministic)
+            controlMemory(accounted);
+
+        if(!done && !deterministic && opt_expRealloc > 0 && time(NULL) - lastRealloc >= opt_expRealloc) {
+            reallocateExploration(time(NULL) - lastRealloc);
+            lastRealloc = time(NULL);
+        }
 
-        if(!done && !adjustedlimitonce) {
+        if(!done && !adjustedlimitonce && !deterministic) {
             uint64_t sumconf = 0;
             uint64_t sumimported = 0;
             for(int i = 0; i < nbsolvers; i++) {
@@ -670,7 +1059,7 @@ lbool MultiSolvers::solve() {
         }
     }
 
-    (void) pthread_mutex_unlock(&m);
+    (void) pthread_mutex_unlock(&mfinished);
 
     for(i = 0; i < nbsolvers; i++) { // Wait for all threads to finish
         pthread_join(*threads[i], NULL);
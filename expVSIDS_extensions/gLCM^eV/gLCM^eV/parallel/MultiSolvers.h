@@ -51,6 +51,7 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 #define MultiSolvers_h
 
 #include "parallel/ParallelSolver.h"
+#include "parallel/NumaTopology.h"
 
 namespace Glucose {
     class SolverConfiguration;
@@ -83,6 +84,7 @@ public:
   ParallelSolver *getPrimarySolver();
   
   void generateAllSolvers();
+  void threadMain(int i);       // Body of the thread of solver i
   
   // Solving:
   //
@@ -118,6 +120,11 @@ struct Stats {
 };
 
 	void printStats(); 
+	void reallocateExploration(double elapsed); // Copy the exploration parameters of the best threads to the worst ones
+	void placeThreads();          // Choose the CPU (and NUMA node) of each thread
+	double accountedMemory();     // Memory held by the solvers and the shared buffers (in Mb)
+	void controlMemory(double mem); // Shrink, pause or retire threads when 'mem' nears maxmemory
+	vec<uint64_t> lastConflicts, lastTotalLBD; // Counters of each solver at the previous reallocation
 	int ok;
 	lbool result;
 	int maxnbthreads; // Maximal number of threads
@@ -166,6 +173,16 @@ struct Stats {
     vec<ParallelSolver*> solvers; // set of plain solvers
     vec<SolverCompanion*> solvercompanions; // set of companion solvers
     vec<pthread_t*> threads; // all threads of this process
+    vec<ParallelSolver*> clones; // clones[i] is built by thread i > 0 itself, before it is added to solvers
+    pthread_barrier_t startBarrier; // threads wait on it once their clone is built, then until all are configured
+
+    bool deterministic; // -det: see ParallelSolver::synchronize()
+    NumaTopology topology;
+    bool pinThreads; // bind each thread to a CPU (-pin)
+    bool scatterThreads; // spread the threads over the NUMA nodes rather than filling one after the other
+    vec<int> cpuOfThread;
+    vec<double> searchTime; // real time spent in solve() by each thread (for the propagation rates)
+    double searchStart;
     vec<int> threadIndexOfSolver; // threadIndexOfSolver[solvers[i]] is the index in threads[] of the solver i
     vec<int> threadIndexOfSolverCompanion; // threadIndexOfSolverCompanion[solvercompanions[i]] is the index in threads[] of the solvercompanion i
 };
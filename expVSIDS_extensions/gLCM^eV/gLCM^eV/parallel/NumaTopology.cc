@@ -0,0 +1,137 @@
+/*******************************************************************************************[NumaTopology.cc]
+ Glucose -- Copyright (c) 2009-2014, Gilles Audemard, Laurent Simon
+                                CRIL - Univ. Artois, France
+                                LRI  - Univ. Paris Sud, France (2009-2013)
+                                Labri - Univ. Bordeaux, France
+
+ Syrup (Glucose Parallel) -- Copyright (c) 2013-2014, Gilles Audemard, Laurent Simon
+                                CRIL - Univ. Artois, France
+                                Labri - Univ. Bordeaux, France
+
+Glucose sources are based on MiniSat (see below MiniSat copyrights). Permissions and copyrights of
+Glucose (sources until 2013, Glucose 3.0, single core) are exactly the same as Minisat on which it 
+is based on. (see below).
+
+Glucose-Syrup sources are based on another copyright. Permissions and copyrights for the parallel
+version of Glucose-Syrup (the "Software") are granted, free of charge, to deal with the Software
+without restriction, including the rights to use, copy, modify, merge, publish, distribute,
+sublicence, and/or sell copies of the Software, and to permit persons to whom the Software is 
+furnished to do so, subject to the following conditions:
+
+- The above and below copyrights notices and this permission notice shall be included in all
+copies or substantial portions of the Software;
+- The parallel version of Glucose (all files modified since Glucose 3.0 releases, 2013) cannot
+be used in any competitive event (sat competitions/evaluations) without the express permission of 
+the authors (Gilles Audemard / Laurent Simon). This is also the case for any competitive event
+using Glucose Parallel as an embedded SAT engine (single core or not).
+
+
+--------------- Original Minisat Copyrights
+
+Copyright (c) 2003-2006, Niklas Een, Niklas Sorensson
+Copyright (c) 2007-2010, Niklas Sorensson
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ **************************************************************************************************/
+
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+#include "parallel/NumaTopology.h"
+
+using namespace Glucose;
+
+// Reads a cpulist ("0-3,8,10-11") and keeps the CPUs that are in 'allowed'.
+static void parseCpuList(const char *list, const cpu_set_t & allowed, vec<int> & out) {
+    const char *p = list;
+    while(*p != '\0' && *p != '\n') {
+        char *end;
+        long from = strtol(p, &end, 10), to = from;
+        if(end == p) break;
+        if(*end == '-') {
+            p = end + 1;
+            to = strtol(p, &end, 10);
+        }
+        for(long c = from; c <= to; c++)
+            if(c < CPU_SETSIZE && CPU_ISSET(c, &allowed)) out.push((int) c);
+        p = (*end == ',') ? end + 1 : end;
+    }
+}
+
+
+NumaTopology::NumaTopology() : total(0) {
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    if(sched_getaffinity(0, sizeof(allowed), &allowed) != 0)
+        for(int c = 0; c < CPU_SETSIZE; c++) CPU_SET(c, &allowed);
+
+    // Node directories may be sparse (e.g. node0 and node2 only)
+    for(int node = 0, missing = 0; missing < 64; node++) {
+        char path[128], line[4096];
+        snprintf(path, sizeof(path), "/sys/devices/system/node/node%d/cpulist", node);
+        FILE *f = fopen(path, "r");
+        if(f == NULL) {
+            missing++;
+            continue;
+        }
+        missing = 0;
+        int start = cpus.size();
+        if(fgets(line, sizeof(line), f) != NULL)
+            parseCpuList(line, allowed, cpus);
+        fclose(f);
+        if(cpus.size() == start) continue; // Memory-only node, or no CPU we may use
+        nodeStart.push(start);
+    }
+
+    if(cpus.size() == 0) { // No topology information: one node with all allowed CPUs
+        nodeStart.clear();
+        nodeStart.push(0);
+        for(int c = 0; c < CPU_SETSIZE; c++)
+            if(CPU_ISSET(c, &allowed)) cpus.push(c);
+    }
+    total = cpus.size();
+    nodeStart.push(total);
+}
+
+
+int NumaTopology::nodeOfCpu(int cpu) const {
+    for(int n = 0; n < nbNodes(); n++)
+        for(int i = nodeStart[n]; i < nodeStart[n + 1]; i++)
+            if(cpus[i] == cpu) return n;
+    return 0;
+}
+
+
+int NumaTopology::cpuOfThread(int i, bool scatter) const {
+    if(total == 0) return -1;
+    if(scatter) {
+        int n = i % nbNodes();
+        return cpus[nodeStart[n] + (i / nbNodes()) % (nodeStart[n + 1] - nodeStart[n])];
+    }
+    return cpus[i % total];
+}
+
+
+bool NumaTopology::pinCurrentThread(int cpu) {
+    if(cpu < 0) return false;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+}
@@ -47,8 +47,11 @@ DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
 OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
  **************************************************************************************************/
 
+#include <unistd.h>
+
 #include "parallel/ParallelSolver.h"
 #include "mtl/Sort.h"
+#include "utils/System.h"
 
 using namespace Glucose;
 
@@ -60,6 +63,11 @@ const char* _parallel = "PARALLEL";
 
 extern BoolOption opt_dontExportDirectReusedClauses; // (_cunstable, "reusedClauses",    "Don't export directly reused clauses", false);
 extern BoolOption opt_plingeling; // (_cunstable, "plingeling",    "plingeling strategy for sharing clauses (exploratory feature)", false);
+extern IntOption  opt_expShareLBD; // (_parallel, "exp-share-lbd", "Share the conflicts of random walks up to this LBD (0: none)", 2);
+extern IntOption  opt_dupFilter; // (_parallel, "dup-filter", "Bits (log2) of each generation of the duplicate clause filters of a thread (0: no filter)", 18);
+extern BoolOption opt_deterministic; // (_parallel, "det", "Deterministic mode: ...", false);
+extern IntOption  opt_detInterval; // (_parallel, "det-interval", "Conflicts of each thread between two barriers of the deterministic mode", 2000);
+extern IntOption  opt_importInterval; // (_parallel, "import-interval", "Conflicts after which a restart goes back to level 0 to import clauses", 5000);
 
 //=====================================================================
 
@@ -81,9 +89,24 @@ ParallelSolver::ParallelSolver(int threadId) :
 , limitSharingByFixedLimitSize(0) // No fixed boud (like 40 in plingeling) 
 , dontExportDirectReusedClauses(opt_dontExportDirectReusedClauses)
 , nbNotExportedBecauseDirectlyReused(0)
+, expConsumer(false)
+, expShareLBD(opt_expShareLBD)
+, expPostedSet(false)
+, importInterval(opt_importInterval)
+, lastImport(0)
+, memoryControl(memRun), shrinkRequests(0), shrinksDone(0), shrinking(false)
+, memArena(0), memWatches(0), memVariables(0), memLearnts(0), memPermanent(0), memImported(0)
+, deterministic(opt_deterministic)
+, detInterval(opt_detInterval)
+, nextBarrier(opt_detInterval)
+, period(0)
+, detStatus(l_Undef)
+, barrierWait(0)
 {
     useUnaryWatched = true; // We want to use promoted clauses here !
     stats.growTo(parallelStatsSize,0);
+    seenFilter.init(opt_dupFilter);
+    sentFilter.init(opt_dupFilter);
 }
 
 
@@ -109,11 +132,26 @@ ParallelSolver::ParallelSolver(const ParallelSolver &s) :
 , limitSharingByFixedLimitSize(s.limitSharingByFixedLimitSize) // No fixed boud (like 40 in plingeling) 
 , dontExportDirectReusedClauses(s.dontExportDirectReusedClauses)
 , nbNotExportedBecauseDirectlyReused(s.nbNotExportedBecauseDirectlyReused) 
+, expConsumer(s.expConsumer)
+, expShareLBD(s.expShareLBD)
+, expPostedSet(false)
+, importInterval(s.importInterval)
+, lastImport(0)
+, memoryControl(memRun), shrinkRequests(0), shrinksDone(0), shrinking(false)
+, memArena(0), memWatches(0), memVariables(0), memLearnts(0), memPermanent(0), memImported(0)
+, deterministic(s.deterministic)
+, detInterval(s.detInterval)
+, nextBarrier(s.detInterval)
+, period(0)
+, detStatus(l_Undef)
+, barrierWait(0)
 {
     s.goodImportsFromThreads.memCopyTo(goodImportsFromThreads);   
     useUnaryWatched = s.useUnaryWatched;
     s.stats.copyTo(stats);
     s.elimclauses.copyTo(elimclauses); // This should be done more efficiently some day
+    seenFilter.init(opt_dupFilter); // Built by the thread of the clone: nothing was learnt yet
+    sentFilter.init(opt_dupFilter);
 }
 
 
@@ -168,7 +206,7 @@ void ParallelSolver::reduceDB() {
   else 
       sort(learnts, reduceDB_lt(ca));
 
-  if (!chanseokStrategy && !panicModeIsEnabled()) {
+  if (!chanseokStrategy && !panicModeIsEnabled() && !shrinking) {
         // We have a lot of "good" clauses, it is difficult to compare them. Keep more !
         if (ca[learnts[learnts.size() / RATIOREMOVECLAUSES]].lbd() <= 3) nbclausesbeforereduce += specialIncReduceDB;
         // Useless :-)
@@ -177,7 +215,9 @@ void ParallelSolver::reduceDB() {
         // Don't delete binary or locked clauses. From the rest, delete clauses from the first half
         // Keep clauses which seem to be usefull (their lbd was reduce during this sequence)
 
-  if (!panicModeIsEnabled()) {
+  if (shrinking) {
+        limit = learnts.size() * 3 / 4; // Memory is short (see obeyMemoryControl())
+    } else if (!panicModeIsEnabled()) {
         limit = learnts.size() / 2;
     } else {
         limit = panicModeLastRemoved;
@@ -207,7 +247,9 @@ void ParallelSolver::reduceDB() {
         goodlimitsize = 1 + (double) sumsize / (double) learnts.size();
 
     // Special treatment for imported clauses
-    if (!panicModeIsEnabled())
+    if (shrinking)
+        limit = unaryWatchedClauses.size() - learnts.size();
+    else if (!panicModeIsEnabled())
         limit = unaryWatchedClauses.size() - (learnts.size() * (chanseokStrategy?4:2));
     else
         limit = panicModeLastRemovedShared;
@@ -232,6 +274,119 @@ void ParallelSolver::reduceDB() {
     }
 
     checkGarbage();
+    accountMemory(true);
+}
+
+
+/*_________________________________________________________________________________________________
+|
+|  accountMemory : (bool all)   ->  [void]
+|  
+|  Description:
+|  measure the memory held by this solver: the clause arena, the learnt clauses of each tier and,
+|  if 'all', the watch lists and the per-variable data (linear in the number of variables, so
+|  only done after reduceDB). Called by the thread of the solver only.
+|________________________________________________________________________________________________@*/
+
+template<class T>
+static inline uint64_t bytesOf(const vec<T> & v) { return (uint64_t) v.capacity() * sizeof(T); }
+
+void ParallelSolver::accountMemory(bool all) {
+    memArena.store((uint64_t) ca.getCap() * ClauseAllocator::Unit_Size, std::memory_order_relaxed);
+    memLearnts.store(learnts.size(), std::memory_order_relaxed);
+    memPermanent.store(permanentLearnts.size(), std::memory_order_relaxed);
+    memImported.store(unaryWatchedClauses.size(), std::memory_order_relaxed);
+    if (!all) return;
+
+    uint64_t w = bytesOf(clauses) + bytesOf(learnts) + bytesOf(permanentLearnts) + bytesOf(unaryWatchedClauses);
+    for (int v = 0; v < nVars(); v++)
+        for (int sign = 0; sign < 2; sign++) {
+            Lit l = mkLit(v, sign);
+            w += bytesOf(watches[l]) + bytesOf(watchesBin[l]) + bytesOf(unaryWatches[l]) + 3 * sizeof(vec<Watcher>);
+        }
+    memWatches.store(w, std::memory_order_relaxed);
+    memVariables.store(bytesOf(activity) + bytesOf(assigns) + bytesOf(polarity) + bytesOf(decision) + bytesOf(trail)
+                       + bytesOf(vardata) + bytesOf(permDiff) + bytesOf(seen) + bytesOf(forceUNSAT) + bytesOf(nbpos)
+                       + seenFilter.memoryUsed() + sentFilter.memoryUsed(),
+                       std::memory_order_relaxed);
+}
+
+
+/*_________________________________________________________________________________________________
+|
+|  obeyMemoryControl : ()   ->  [void]
+|  
+|  Description:
+|  at level 0, apply what the main thread asked for: reduce the learnt clauses once per request,
+|  and sleep while paused (after a reduction, so that a paused thread holds as little as
+|  possible). A paused thread is idle for the clause buffers: the exporting threads do not wait
+|  for it.
+|________________________________________________________________________________________________@*/
+
+void ParallelSolver::obeyMemoryControl() {
+    int control = memoryControl.load(std::memory_order_relaxed);
+    unsigned requests = shrinkRequests.load(std::memory_order_relaxed);
+    if ((requests != shrinksDone || control == memPause) && learnts.size() > 0) {
+        shrinking = true;
+        reduceDB();
+        shrinking = false;
+    } else
+        accountMemory(false);
+    shrinksDone = requests;
+    if (control != memPause) return;
+
+    sharedcomp->setIdle(thn, true);
+    while (memoryControl.load(std::memory_order_relaxed) == memPause && !sharedcomp->jobFinished())
+        usleep(100000);
+    sharedcomp->setIdle(thn, memoryControl.load(std::memory_order_relaxed) == memRetire);
+}
+
+
+void ParallelSolver::applyPostedExploration() {
+    if (!expPostedSet.load(std::memory_order_acquire)) return;
+    mW = expPosted.mW;
+    mS = expPosted.mS;
+    prTh = expPosted.prTh;
+    expStepDecay = expPosted.decay;
+    expPostedSet.store(false, std::memory_order_release); // The main thread may post again
+}
+
+
+// Clauses are imported, and the requests of the main thread obeyed, at level 0 only: a restart goes
+// back there when one is pending or when the last import is 'importInterval' conflicts old.
+int ParallelSolver::reuseTrailLevel() {
+    if (conflicts >= lastImport + importInterval || memoryRequestPending()
+        || expPostedSet.load(std::memory_order_relaxed) || detLits.size() > 0 || detUnits.size() > 0)
+        return 0;
+    return Solver::reuseTrailLevel();
+}
+
+
+/*_________________________________________________________________________________________________
+|
+|  releaseMemory : ()   ->  [void]
+|  
+|  Description:
+|  a retired solver gives back its clauses and watch lists. Only its statistics remain usable.
+|________________________________________________________________________________________________@*/
+
+void ParallelSolver::releaseMemory() {
+    sharedcomp->setIdle(thn, true);
+    cancelUntil(0);
+    watches.clear(true);
+    watchesBin.clear(true);
+    unaryWatches.clear(true);
+    clauses.clear(true);
+    learnts.clear(true);
+    permanentLearnts.clear(true);
+    permanentLearntsReduced.clear(true);
+    unaryWatchedClauses.clear(true);
+    ClauseAllocator(1).moveTo(ca);
+    memArena.store((uint64_t) ca.getCap() * ClauseAllocator::Unit_Size, std::memory_order_relaxed);
+    memWatches.store(0, std::memory_order_relaxed);
+    memLearnts.store(0, std::memory_order_relaxed);
+    memPermanent.store(0, std::memory_order_relaxed);
+    memImported.store(0, std::memory_order_relaxed);
 }
 
 
@@ -265,7 +420,9 @@ void ParallelSolver::parallelImportClauseDuringConflictAnalysis(Clause &c,CRef c
 
 // These Two functions are useless here !!
 void ParallelSolver::reportProgress() {
-    printf("c | %2d | %6d | %10d | %10d | %8d | %8d | %8d | %8d | %8d | %6.3f |\n",(int)thn,(int)starts,(int)decisions,(int)conflicts,(int)stats[originalClausesSeen],(int)learnts.size(),(int)stats[nbexported],(int)stats[nbimported],(int)stats[nbPromoted],progressEstimate()*100);
+    int control = memoryControl.load(std::memory_order_relaxed);
+    printf("c | %2d | %6d | %10d | %10d | %8d | %8d | %8d | %8d | %8d | %6.3f | %7.1f |%s\n",(int)thn,(int)starts,(int)decisions,(int)conflicts,(int)stats[originalClausesSeen],(int)memLearnts,(int)stats[nbexported],(int)stats[nbimported],(int)stats[nbPromoted],progressEstimate()*100,
+           memoryFootprint() / (1024.0 * 1024), control == memPause ? " paused" : control == memRetire ? " retired" : "");
 
     //printf("c thread=%d confl=%lld starts=%llu reduceDB=%llu learnts=%d broadcast=%llu  blockedReuse=%lld imported=%llu promoted=%llu limitlbd=%llu limitsize=%llu\n", thn, conflicts, starts, nbReduceDB, learnts.size(), nbexported, nbNotExportedBecauseDirectlyReused, nbimported, nbPromoted, goodlimitlbd, goodlimitsize);
 }
@@ -295,10 +452,25 @@ void ParallelSolver::reportProgressArrayImports(vec<unsigned int> &totalColumns)
 |  Output: true if the clause is indeed sent
 |________________________________________________________________________________________________@*/
 
+template<class C>
+static bool exportForBarrier(ParallelSolver::PeriodExports & out, const C & c) {
+    for (int i = 0; i < c.size(); i++)
+        out.lits.push(c[i]);
+    out.sizes.push(c.size());
+    return true;
+}
+
 bool ParallelSolver::shareClause(Clause & c) {
-    bool sent = sharedcomp->addLearnt(this, c);
-    if (sent)
+    uint64_t sig = ClauseFilter::signature(c);
+    if (sentFilter.contains(sig)) {
+        stats[nbExportDuplicates]++;
+        return false;
+    }
+    bool sent = deterministic ? exportForBarrier(detOut[period & 1], c) : sharedcomp->addLearnt(this, c);
+    if (sent) {
         stats[nbexported]++;
+        sentFilter.add(sig);
+    }
     return sent;
 }
 
@@ -324,6 +496,15 @@ bool ParallelSolver::panicModeIsEnabled() {
 
 void ParallelSolver::parallelImportUnaryClauses() {
     Lit l;
+    if (deterministic) {
+        for (int i = 0; i < detUnits.size(); i++)
+            if (value(var(detUnits[i])) == l_Undef) {
+                uncheckedEnqueue(detUnits[i]);
+                stats[nbimportedunit]++;
+            }
+        detUnits.clear();
+        return;
+    }
     while ((l = sharedcomp->getUnary(this)) != lit_Undef) {
         if (value(var(l)) == l_Undef) {
             uncheckedEnqueue(l);
@@ -344,8 +525,23 @@ void ParallelSolver::parallelImportUnaryClauses() {
 bool ParallelSolver::parallelImportClauses() {
 
     assert(decisionLevel() == 0);
-    int importedFromThread;
-    while (sharedcomp->getNewClause(this, importedFromThread, importedClause)) {
+    lastImport = conflicts;
+    obeyMemoryControl();
+    applyPostedExploration();
+    if (memoryControl.load(std::memory_order_relaxed) == memRetire)
+        return false;
+    importedLits.clear(); importedSizes.clear(); importedOrigins.clear();
+    int nbImported;
+    if (deterministic) { // Received at the last barriers
+        detLits.moveTo(importedLits); detSizes.moveTo(importedSizes); detOrigins.moveTo(importedOrigins);
+        nbImported = importedSizes.size();
+    } else
+        nbImported = sharedcomp->getNewClauses(this, importedLits, importedSizes, importedOrigins);
+    for (int k = 0, offset = 0; k < nbImported; offset += importedSizes[k++]) {
+        int importedFromThread = importedOrigins[k];
+        importedClause.clear();
+        for (int i = 0; i < importedSizes[k]; i++)
+            importedClause.push(importedLits[offset + i]);
         assert(importedFromThread <= sharedcomp->nbThreads);
         assert(importedFromThread >= 0);
 
@@ -354,6 +550,13 @@ bool ParallelSolver::parallelImportClauses() {
         if (importedClause.size() == 0)
             return true;
 
+        if (seenFilter.testAndAdd(ClauseFilter::signature(importedClause))) {
+            // Learnt or imported before: the words it would take in the arena are saved
+            stats[nbImportDuplicates]++;
+            stats[nbImportDuplicateWords] += (sizeof(Clause) + sizeof(Lit) * (importedClause.size() + 1)) / sizeof(uint32_t);
+            continue;
+        }
+
         //printf("Thread %d imports clause from thread %d\n", threadNumber(), importedFromThread);
         CRef cr = ca.alloc(importedClause, true, true);
         ca[cr].setLBD(importedClause.size());
@@ -400,7 +603,10 @@ bool ParallelSolver::parallelImportClauses() {
 
 void ParallelSolver::parallelExportUnaryClause(Lit p) {
     // Multithread
-    sharedcomp->addLearnt(this,p ); // TODO: there can be a contradiction here (two theads proving a and -a)
+    if (deterministic)
+        detOut[period & 1].units.push(p);
+    else
+        sharedcomp->addLearnt(this,p ); // TODO: there can be a contradiction here (two theads proving a and -a)
     stats[nbexportedunit]++;
 }
 
@@ -424,7 +630,148 @@ void ParallelSolver::parallelExportClauseDuringSearch(Clause &c) {
         shareClause(c);
         c.setExported(2);
     }
+    seenFilter.add(ClauseFilter::signature(c)); // Do not import it from another thread
+
+}
+
+
+/*_________________________________________________________________________________________________
+|
+|  parallelExportWalkConflict : (vec<Lit> &c, unsigned int lbd)   ->  [void]
+|  
+|  Description:
+|  share a clause learnt from the conflict that ended a random walk, if its LBD is good enough.
+|  The exploring thread itself does not keep these clauses.
+|  @see explore
+|________________________________________________________________________________________________@*/
+
+void ParallelSolver::parallelExportWalkConflict(vec<Lit> &c, unsigned int lbd) {
+    if (lbd > expShareLBD || c.size() == 0 || conflicts < firstSharing)
+        return;
+    if (c.size() == 1) {
+        if (deterministic)
+            detOut[period & 1].units.push(c[0]);
+        else
+            sharedcomp->addLearnt(this, c[0]);
+    } else {
+        uint64_t sig = ClauseFilter::signature(c);
+        if (sentFilter.contains(sig)) {
+            stats[nbExportDuplicates]++;
+            return;
+        }
+        if (deterministic)
+            exportForBarrier(detOut[period & 1], c);
+        else if (!sharedcomp->addLearnt(this, c))
+            return;
+        sentFilter.add(sig);
+    }
+    stats[nbexportedWalkConflicts]++;
+}
+
+
+/*_________________________________________________________________________________________________
+|
+|  parallelExportExplorationScores : ()   ->  [void]
+|  
+|  Description:
+|  publish the exploration scores of the last episode as (var, score) pairs
+|  @see search
+|________________________________________________________________________________________________@*/
+
+void ParallelSolver::parallelExportExplorationScores() {
+    if (sharedcomp->nbThreads < 2 || expScore.empty())
+        return;
+    expScoreSummary.clear();
+    for (std::map<uint32_t,double>::iterator it = expScore.begin(); it != expScore.end(); ++it) {
+        float score = (float) it->second;
+        uint32_t bits;
+        memcpy(&bits, &score, sizeof(bits));
+        expScoreSummary.push(it->first);
+        expScoreSummary.push(bits);
+    }
+    if (deterministic) {
+        PeriodExports & out = detOut[period & 1];
+        for (int i = 0; i < expScoreSummary.size(); i++)
+            out.scores.push(expScoreSummary[i]);
+        out.scoreSizes.push(expScoreSummary.size());
+        stats[nbexportedExpScores] += expScore.size();
+    } else if (sharedcomp->addExplorationScores(this, expScoreSummary))
+        stats[nbexportedExpScores] += expScore.size();
+}
+
+
+/*_________________________________________________________________________________________________
+|
+|  parallelImportExplorationScores : ()   ->  [void]
+|  
+|  Description:
+|  fold the exploration scores published by the other threads into the activities, as if the
+|  episodes had been run by this thread
+|________________________________________________________________________________________________@*/
+
+void ParallelSolver::parallelImportExplorationScores() {
+    if (!expConsumer)
+        return;
+    importedScores.clear(); importedScoreSizes.clear(); importedScoreOrigins.clear();
+    if (deterministic) {
+        detScores.moveTo(importedScores); detScoreSizes.moveTo(importedScoreSizes); detScoreOrigins.moveTo(importedScoreOrigins);
+        if (importedScoreSizes.size() == 0)
+            return;
+    } else if (sharedcomp->getExplorationScores(this, importedScores, importedScoreSizes, importedScoreOrigins) == 0)
+        return;
+    for (int i = 0; i + 1 < importedScores.size(); i += 2) {
+        Var v = importedScores[i];
+        float score;
+        memcpy(&score, &importedScores[i + 1], sizeof(score));
+        if (v < nVars()) {
+            bumpExpScore(v, score);
+            stats[nbimportedExpScores]++;
+        }
+    }
+}
+
 
+/*_________________________________________________________________________________________________
+|
+|  synchronize : ()   ->  [void]
+|  
+|  Description:
+|  deterministic mode: meet the other threads at the end of the period, then queue what they
+|  exported during it, in thread order, for the next restart. The exports of a period are read by
+|  the others during the next one, so a thread clears its buffer of period k - 1 only once all
+|  threads have reached the end of period k.
+|________________________________________________________________________________________________@*/
+
+void ParallelSolver::synchronize() {
+    double start = realTime();
+    bool finished = sharedcomp->barrier(this);
+    barrierWait += realTime() - start;
+    stats[nbBarriers]++;
+    nextBarrier += detInterval;
+    int ended = period & 1;
+    period++;
+    detOut[period & 1].clear();
+    if (finished) return;
+
+    for (int t = 0; t < sharedcomp->watchedSolvers.size(); t++) {
+        if (t == thn) continue;
+        const PeriodExports & in = sharedcomp->watchedSolvers[t]->detOut[ended];
+        for (int i = 0; i < in.lits.size(); i++)
+            detLits.push(in.lits[i]);
+        for (int i = 0; i < in.sizes.size(); i++) {
+            detSizes.push(in.sizes[i]);
+            detOrigins.push(t);
+        }
+        for (int i = 0; i < in.units.size(); i++)
+            detUnits.push(in.units[i]);
+        if (!expConsumer) continue;
+        for (int i = 0; i < in.scores.size(); i++)
+            detScores.push(in.scores[i]);
+        for (int i = 0; i < in.scoreSizes.size(); i++) {
+            detScoreSizes.push(in.scoreSizes[i]);
+            detScoreOrigins.push(t);
+        }
+    }
 }
 
 
@@ -438,8 +785,13 @@ void ParallelSolver::parallelExportClauseDuringSearch(Clause &c) {
 |________________________________________________________________________________________________@*/
 
 bool ParallelSolver::parallelJobIsFinished() { 
+    if (deterministic && conflicts >= nextBarrier)
+        synchronize();
     // Parallel: another job has finished let's quit
-    return (sharedcomp->jobFinished());
+    if (sharedcomp->jobFinished()) return true;
+    // A memory request stops the search as a restart would, so that it is served at level 0 (see
+    // solve_()). Never on a conflict at level 0: that one proves the formula unsatisfiable.
+    return decisionLevel() > 0 && memoryRequestPending();
 }
 
 // @overide
@@ -475,12 +827,22 @@ lbool ParallelSolver::solve_(bool do_simp, bool turn_off_simp) {
 
     // Search:
     int curr_restarts = 0;
-    while (status == l_Undef && !sharedcomp->jobFinished()) {
+    initExpParameters();
+    accountMemory(true);
+    while (status == l_Undef && !sharedcomp->jobFinished() && memoryControl.load(std::memory_order_relaxed) != memRetire) {
         status = search(luby_restart?luby(restart_inc, curr_restarts)*luby_restart_factor:0);  // the parameter is useless in glucose, kept to allow modifications
         if (!withinBudget()) break;
+        if (status == l_Undef) cancelUntil(0); // search() may have been stopped on a conflict by a memory request
         curr_restarts++;
     }
 
+    if (status == l_Undef && memoryControl.load(std::memory_order_relaxed) == memRetire && !sharedcomp->jobFinished()) {
+        // Retired by the main thread to save memory: the other threads go on
+        printf("c Thread %d retired to save memory.\n", threadNumber());
+        releaseMemory();
+        return status;
+    }
+
     if (verbosity >= 1)
         printf("c =========================================================================================================\n");
 
@@ -492,7 +854,12 @@ lbool ParallelSolver::solve_(bool do_simp, bool turn_off_simp) {
 */
     
     bool firstToFinish = false;
-    if (status != l_Undef)
+    if (status != l_Undef && deterministic) {
+        // The answer ends the job at the next barrier, unless a lower thread brings one too
+        detStatus = status;
+        synchronize();
+        firstToFinish = sharedcomp->winner() == this;
+    } else if (status != l_Undef)
         firstToFinish = sharedcomp->IFinished(this);
     if (firstToFinish) {
         printf("c Thread %d is 100%% pure glucose! First thread to finish! (%s answer).\n", threadNumber(), status == l_True ? "SAT" : status == l_False ? "UNSAT" : "UNKOWN");
@@ -54,6 +54,7 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 #include "core/Solver.h"
 #include "simp/SimpSolver.h"
 #include "parallel/SharedCompanion.h"
+#include "parallel/ClauseFilter.h"
 namespace Glucose {
     
    enum ParallelStats{
@@ -62,9 +63,16 @@ namespace Glucose {
        nbexportedunit,
        nbimportedunit,
        nbimportedInPurgatory,
-       nbImportedGoodClauses
+       nbImportedGoodClauses,
+       nbexportedWalkConflicts,
+       nbexportedExpScores,
+       nbimportedExpScores,
+       nbImportDuplicates,
+       nbImportDuplicateWords,
+       nbExportDuplicates,
+       nbBarriers
    } ;
-#define parallelStatsSize (coreStatsSize + 6)
+#define parallelStatsSize (coreStatsSize + 13)
  
 //=================================================================================================
     //class MultiSolvers;
@@ -110,6 +118,9 @@ public:
     virtual lbool         solve_                   (bool do_simp = true, bool turn_off_simp = false);
 
     vec<Lit>    importedClause; // Temporary clause used to copy each imported clause
+    vec<Lit>    importedLits;    // Literals of the clauses received in one import round
+    vec<int>    importedSizes;   // ... their sizes
+    vec<int>    importedOrigins; // ... and the threads that exported them
     unsigned int    goodlimitlbd; // LBD score of the "good" clauses, locally
     int    goodlimitsize;
     bool purgatory; // mode of operation
@@ -130,14 +141,86 @@ public:
     
     vec<uint32_t> goodImportsFromThreads; // Stats of good importations from other threads
 
+    // Sharing of exploration (a thread explores when 'exploration' is set)
+    bool expConsumer;              // Fold the exploration scores of other threads into the activities
+    unsigned int expShareLBD;      // Share the conflicts of random walks up to this LBD (0: none)
+    vec<uint32_t> expScoreSummary; // (var, score) pairs of the last episode, scores as float bits
+    vec<uint32_t> importedScores;  // Summaries received in one import round
+    vec<int>    importedScoreSizes, importedScoreOrigins;
+
+    // Exploration parameters moved between threads by MultiSolvers::reallocateExploration(). The
+    // main thread keeps 'expParams' and posts a change in 'expPosted'; the thread takes it over
+    // (mW, mS, prTh, expStepDecay) at level 0, before its next episode, and clears 'expPostedSet'.
+    struct ExplorationParams { uint32_t mW, mS, prTh; double decay; };
+    ExplorationParams expParams;   // Owned by the main thread
+    ExplorationParams expPosted;
+    std::atomic<bool> expPostedSet;
+    void applyPostedExploration(); // At level 0: takes the posted parameters, if any
+
+    // Partial restarts (see Solver::reuseTrailLevel()) keep a thread above level 0, where it imports
+    uint64_t importInterval;       // Conflicts after which a restart goes back to level 0
+    uint64_t lastImport;           // Conflicts at the last import
+    virtual int reuseTrailLevel();
+
+    // Duplicate clauses: a clause this thread learnt or imported is not imported again, a clause
+    // it exported is not exported again (up to the memory of the filters)
+    ClauseFilter seenFilter;
+    ClauseFilter sentFilter;
+
+    // Memory accounting (see MultiSolvers::controlMemory()). The footprint is measured by the
+    // thread of the solver; the main thread reads it and sets 'memoryControl' and 'shrinkRequests'.
+    enum { memRun = 0, memPause, memRetire };
+    std::atomic<int>      memoryControl;
+    std::atomic<unsigned> shrinkRequests; // Each increment asks for one reduction of the learnt clauses
+    unsigned              shrinksDone;
+    bool                  shrinking;      // reduceDB() runs on request: keep only the best quarter
+    std::atomic<uint64_t> memArena, memWatches, memVariables; // Bytes
+    std::atomic<int>      memLearnts, memPermanent, memImported; // Clauses of each learnt tier
+
+    uint64_t memoryFootprint() const { return memArena + memWatches + memVariables; }
+    bool memoryRequestPending() const {
+        return memoryControl.load(std::memory_order_relaxed) != memRun || shrinkRequests.load(std::memory_order_relaxed) != shrinksDone; }
+    void accountMemory(bool all);         // Measures the arena (and if 'all' the watches and variables)
+    void obeyMemoryControl();             // At level 0: shrinks, and waits while paused
+    void releaseMemory();                 // Frees the clauses of a retired solver
+
+    // Deterministic mode (-det): the threads meet every 'detInterval' conflicts (see synchronize()).
+    // What a thread exports during period k goes to detOut[k % 2]; at the barrier that ends the
+    // period, each thread appends the buffers of the others, in thread order, to its det* import
+    // queues, which are emptied at its next restart.
+    struct PeriodExports {
+        vec<Lit>      lits;       // Clauses, one after the other
+        vec<int>      sizes;
+        vec<Lit>      units;
+        vec<uint32_t> scores;     // Exploration summaries, one after the other
+        vec<int>      scoreSizes;
+        void clear() { lits.clear(); sizes.clear(); units.clear(); scores.clear(); scoreSizes.clear(); }
+    };
+    bool          deterministic;
+    uint64_t      detInterval;
+    uint64_t      nextBarrier;     // Conflicts at which this thread meets the others
+    int           period;
+    PeriodExports detOut[2];
+    vec<Lit>      detLits, detUnits;
+    vec<int>      detSizes, detOrigins;
+    vec<uint32_t> detScores;
+    vec<int>      detScoreSizes, detScoreOrigins;
+    lbool         detStatus;       // Answer brought to the barrier
+    double        barrierWait;     // Real time spent waiting for the other threads (in seconds)
+
+    void synchronize();            // Waits for the other threads at the end of the period, then collects their exports
+
     virtual void parallelImportClauseDuringConflictAnalysis(Clause &c,CRef confl);
     virtual bool parallelImportClauses(); // true if the empty clause was received
     virtual void parallelImportUnaryClauses();
     virtual void parallelExportUnaryClause(Lit p);
     virtual void parallelExportClauseDuringSearch(Clause &c);
+    virtual void parallelExportWalkConflict(vec<Lit> &c, unsigned int lbd);
+    virtual void parallelExportExplorationScores();
+    virtual void parallelImportExplorationScores();
     virtual bool parallelJobIsFinished();
     virtual bool panicModeIsEnabled();
- 
+
     bool shareClause(Clause & c); // true if the clause was succesfully sent
 
     
@@ -62,12 +62,15 @@ SharedCompanion::SharedCompanion(int _nbThreads) :
     jobFinishedBy(NULL),
     panicMode(false), // The bug in the SAT2014 competition :)
     jobStatus(l_Undef),
+    barrierArrived(0),
+    barrierGeneration(0),
     random_seed(9164825) {
 
-	pthread_mutex_init(&mutexSharedClauseCompanion,NULL); // This is the shared companion lock
 	pthread_mutex_init(&mutexSharedUnitCompanion,NULL); // This is the shared companion lock
 	pthread_mutex_init(&mutexSharedCompanion,NULL); // This is the shared companion lock
 	pthread_mutex_init(&mutexJobFinished,NULL); // This is the shared companion lock
+	pthread_mutex_init(&mutexBarrier,NULL);
+	pthread_cond_init(&condBarrier,NULL);
 	if (_nbThreads> 0)  {
 	    setNbThreads(_nbThreads);
 	    fprintf(stdout,"c Shared companion initialized: handling of clauses of %d threads.\nc %d ints for the sharing clause buffer (not expandable) .\n", _nbThreads, clausesBuffer.maxSize());
@@ -78,9 +81,32 @@ SharedCompanion::SharedCompanion(int _nbThreads) :
 void SharedCompanion::setNbThreads(int _nbThreads) {
    nbThreads = _nbThreads;
    clausesBuffer.setNbThreads(_nbThreads); 
+   scoresBuffer.setRemoveOlder(true); // Not all threads read the scores, and old scores are worthless
+   scoresBuffer.setNbThreads(_nbThreads); 
+}
+
+void SharedCompanion::setNodes(const vec<int> & nodes) {
+   clausesBuffer.setNodes(nodes);
+   scoresBuffer.setNodes(nodes);
+}
+
+void SharedCompanion::attachThread(int threadId) {
+   clausesBuffer.attach(threadId);
+   scoresBuffer.attach(threadId);
+}
+
+void SharedCompanion::setIdle(int threadId, bool b) {
+   clausesBuffer.setIdle(threadId, b); // The scores buffer never waits for its readers
+}
+
+uint64_t SharedCompanion::memoryUsed() const {
+   return clausesBuffer.memoryUsed() + scoresBuffer.memoryUsed();
 }
 
 void SharedCompanion::printStats() {
+    printf("c shared clauses overwritten before being imported by all threads: %" PRIu64 "\n", clausesBuffer.nbOverwritten());
+    if (clausesBuffer.nbForwarded() > 0)
+        printf("c shared clauses forwarded to the other NUMA nodes: %" PRIu64 "\n", clausesBuffer.nbForwarded());
 }
 
 // No multithread safe
@@ -125,22 +151,33 @@ bool SharedCompanion::addLearnt(ParallelSolver *s, Clause & c) {
   bool ret = false;
   assert(watchedSolvers.size()>sn);
 
-  pthread_mutex_lock(&mutexSharedClauseCompanion);
+  // Each thread writes its own ring of the buffer: no lock needed
   ret = clausesBuffer.pushClause(sn, c);
-  pthread_mutex_unlock(&mutexSharedClauseCompanion);
   return ret;
 }
 
+bool SharedCompanion::addLearnt(ParallelSolver *s, const vec<Lit> & c) { 
+  int sn = s->thn; // thread number of the solver
+  assert(watchedSolvers.size()>sn);
+  return clausesBuffer.pushClause(sn, c);
+}
 
-bool SharedCompanion::getNewClause(ParallelSolver *s, int & threadOrigin, vec<Lit>& newclause) { // gets a new interesting clause for solver s 
+bool SharedCompanion::addExplorationScores(ParallelSolver *s, const vec<uint32_t> & scores) { 
+  int sn = s->thn; // thread number of the solver
+  assert(watchedSolvers.size()>sn);
+  return scoresBuffer.pushWords(sn, scores);
+}
+
+
+int SharedCompanion::getNewClauses(ParallelSolver *s, vec<Lit>& lits, vec<int>& sizes, vec<int>& origins) { // gets all new clauses for solver s 
   int sn = s->thn;
   
-    // First, let's get the clauses on the big blackboard
-    pthread_mutex_lock(&mutexSharedClauseCompanion);
-    bool b = clausesBuffer.getClause(sn, threadOrigin, newclause);
-    pthread_mutex_unlock(&mutexSharedClauseCompanion);
- 
-  return b;
+    // Collect, in one go, the clauses exported by the other threads on the big blackboard
+    return clausesBuffer.getClauses(sn, lits, sizes, origins);
+}
+
+int SharedCompanion::getExplorationScores(ParallelSolver *s, vec<uint32_t>& scores, vec<int>& sizes, vec<int>& origins) {
+    return scoresBuffer.getWords(s->thn, scores, sizes, origins);
 }
 
 bool SharedCompanion::jobFinished() {
@@ -163,5 +200,26 @@ bool SharedCompanion::IFinished(ParallelSolver *s) {
     return ret;
 }
 
-
-
+// The last thread to arrive ends the job if some thread brought an answer: the one with the lowest
+// thread number wins, whatever the order of arrival.
+bool SharedCompanion::barrier(ParallelSolver *s) {
+    pthread_mutex_lock(&mutexBarrier);
+    uint64_t generation = barrierGeneration;
+    if (++barrierArrived == nbThreads) {
+	for (int i = 0; i < watchedSolvers.size(); i++)
+	    if (watchedSolvers[i]->detStatus != l_Undef) {
+		pthread_mutex_lock(&mutexJobFinished);
+		bjobFinished = true;
+		jobFinishedBy = watchedSolvers[i];
+		pthread_mutex_unlock(&mutexJobFinished);
+		break;
+	    }
+	barrierArrived = 0;
+	barrierGeneration++;
+	pthread_cond_broadcast(&condBarrier);
+    } else
+	while (generation == barrierGeneration)
+	    pthread_cond_wait(&condBarrier, &mutexBarrier);
+    pthread_mutex_unlock(&mutexBarrier);
+    return jobFinished();
+}
@@ -70,29 +70,41 @@ class SharedCompanion : public SolverCompanion {
 public:
 	SharedCompanion(int nbThreads=0);
 	void setNbThreads(int _nbThreads); // Sets the number of threads (cannot by changed once the solver is running)
+	void setNodes(const vec<int> & nodes); // Sets the NUMA node of each thread (after setNbThreads)
+	void attachThread(int threadId);   // Allocates the buffers written by a thread, from that thread
+	void setIdle(int threadId, bool b); // A paused or retired thread must not hold back the exporting threads
 	void newVar(bool sign);            // Adds a var (used to keep track of unary variables)
 	void printStats();                 // Printing statistics of all solvers
+	uint64_t memoryUsed() const;       // Bytes of the shared buffers
 
 	bool jobFinished();                // True if the job is over
 	bool IFinished(ParallelSolver *s); // returns true if you are the first solver to finish
 	bool addSolver(ParallelSolver*);   // attach a solver to accompany 
 	void addLearnt(ParallelSolver *s,Lit unary);   // Add a unary clause to share
 	bool addLearnt(ParallelSolver *s, Clause & c); // Add a clause to the shared companion, as a database manager
+	bool addLearnt(ParallelSolver *s, const vec<Lit> & c); // Add a clause that is not in the clause database of s
+	bool addExplorationScores(ParallelSolver *s, const vec<uint32_t> & scores); // Publish a summary of an exploration episode
 
-	bool getNewClause(ParallelSolver *s, int &th, vec<Lit> & nc); // gets a new interesting clause for solver s 
+	int getNewClauses(ParallelSolver *s, vec<Lit> & lits, vec<int> & sizes, vec<int> & origins); // gets all new clauses for solver s, returns how many
+	int getExplorationScores(ParallelSolver *s, vec<uint32_t> & scores, vec<int> & sizes, vec<int> & origins); // gets all new summaries for solver s
 	Lit getUnary(ParallelSolver *s);                              // Gets a new unary literal
 	inline ParallelSolver* winner(){return jobFinishedBy;}        // Gets the first solver that called IFinished()
+	bool barrier(ParallelSolver *s);   // Deterministic mode: waits for all threads, true if the job is over
 
  protected:
 
 	ClausesBuffer clausesBuffer; // A big blackboard for all threads sharing non unary clauses
+	ClausesBuffer scoresBuffer;  // The exploration scores published by the exploring threads, as (var, score) pairs
 	int nbThreads;               // Number of threads
 	
 	// A set of mutex variables
 	pthread_mutex_t mutexSharedCompanion; // mutex for any high level sync between all threads (like reportf)
-	pthread_mutex_t mutexSharedClauseCompanion; // mutex for reading/writing clauses on the blackboard
 	pthread_mutex_t mutexSharedUnitCompanion; // mutex for reading/writing unit clauses on the blackboard 
         pthread_mutex_t mutexJobFinished;
+	pthread_mutex_t mutexBarrier;
+	pthread_cond_t condBarrier;
+	int barrierArrived;          // Threads waiting at the current barrier
+	uint64_t barrierGeneration;  // Number of barriers passed
 
 	bool bjobFinished;
 	ParallelSolver *jobFinishedBy;
@@ -54,6 +54,9 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 
 using namespace Glucose;
 
+extern DoubleOption opt_explorers;
+extern DoubleOption opt_expConsumers;
+
 
 void SolverConfiguration::configure(MultiSolvers *ms, int nbsolvers) {
     for(int i = 1;i<nbsolvers;i++) { // Configuration for the sat race 2015
@@ -70,6 +73,49 @@ void SolverConfiguration::configure(MultiSolvers *ms, int nbsolvers) {
 
 }
 
+
+// The first threads explore and publish their exploration scores (they also use the scores of the
+// other explorers), the next ones only use the published scores, the others ignore exploration.
+void SolverConfiguration::configureExploration(MultiSolvers *ms, int nbsolvers) {
+    int nbExplorers = (int)(opt_explorers * nbsolvers + 0.5);
+    int nbConsumers = (int)(opt_expConsumers * nbsolvers + 0.5);
+    if (nbsolvers > 0 && nbExplorers == 0 && opt_explorers > 0) nbExplorers = 1;
+    if (nbConsumers > nbsolvers - nbExplorers) nbConsumers = nbsolvers - nbExplorers;
+
+    for(int i = 0;i<nbsolvers;i++) {
+        ms->solvers[i]->exploration = i < nbExplorers;
+        ms->solvers[i]->expConsumer = i < nbExplorers + nbConsumers;
+    }
+}
+
+
+// Each exploring thread gets its own number of walks, walk length, trigger probability (in %) and
+// decay of the step scores. The first line is the default of the sequential solver.
+static const struct { uint32_t mW, mS, prTh; double decay; } explorationProfiles[] = {
+    { 5,  5,  2, 0.90},
+    { 3,  8,  5, 0.80},
+    { 8,  3,  1, 0.95},
+    { 5, 12, 10, 0.90},
+    {10,  5,  2, 0.70},
+    { 2,  5, 20, 0.99},
+    { 5, 20,  3, 0.85},
+    {16,  4,  1, 0.90}
+};
+static const int nbExplorationProfiles = sizeof(explorationProfiles) / sizeof(explorationProfiles[0]);
+
+void SolverConfiguration::configureExplorationPortfolio(MultiSolvers *ms, int nbsolvers) {
+    int e = 0; // Index among the exploring threads
+    for(int i = 0;i<nbsolvers;i++) {
+        if (!ms->solvers[i]->exploration) continue;
+        int p = e % nbExplorationProfiles, round = e / nbExplorationProfiles;
+        ms->solvers[i]->mWDefault = explorationProfiles[p].mW + round;  // Beyond the table: slightly more walks
+        ms->solvers[i]->mSDefault = explorationProfiles[p].mS;
+        ms->solvers[i]->prThDefault = explorationProfiles[p].prTh;
+        ms->solvers[i]->expStepDecay = explorationProfiles[p].decay;
+        e++;
+    }
+}
+
         
 void SolverConfiguration::configureSAT15Adapt(MultiSolvers *ms, int nbsolvers) {
     for(int i = 1;i<nbsolvers;i++) { // Configuration for the sat race 2015
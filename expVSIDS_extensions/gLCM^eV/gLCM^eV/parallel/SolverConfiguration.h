@@ -61,6 +61,8 @@ class SolverConfiguration {
 
 public : 
     static void configure(MultiSolvers *ms, int nbsolvers);
+    static void configureExploration(MultiSolvers *ms, int nbsolvers); // Which threads explore / use shared scores
+    static void configureExplorationPortfolio(MultiSolvers *ms, int nbsolvers); // Spread the exploration parameters
 
     // Special configurations
     static void configureSAT14(MultiSolvers *ms, int nbsolvers);
@@ -0,0 +1,25 @@
+#!/bin/sh
+##
+##  Compares the propagation rate of each thread of glucose-syrup under the thread placements.
+##
+##    bench_numa.sh <cnf-file> [nthreads] [extra glucose-syrup options]
+##
+##  For each of -pin=none, compact and scatter, prints the "Props/sec" row of the final
+##  statistics (total, then one column per thread) and the wall-clock time.
+
+if [ $# -lt 1 ]; then
+    echo "usage: $0 <cnf-file> [nthreads] [extra glucose-syrup options]" >&2
+    exit 1
+fi
+
+CNF=$1
+NTHREADS=${2:-$(nproc)}
+[ $# -ge 2 ] && shift
+shift
+SYRUP=${SYRUP:-$(dirname "$0")/glucose-syrup}
+
+for PIN in none compact scatter; do
+    echo "== -pin=$PIN -nthreads=$NTHREADS"
+    "$SYRUP" -nthreads="$NTHREADS" -pin="$PIN" "$@" "$CNF" 2>&1 \
+        | grep -E "Threads pinned|Props/sec|real time|forwarded|^s "
+done
@@ -57,6 +57,7 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 #include "utils/ParseUtils.h"
 #include "utils/Options.h"
 #include "core/Dimacs.h"
+#include "core/ModelWriter.h"
 #include "simp/SimpSolver.h"
 
 using namespace Glucose;
@@ -153,6 +154,7 @@ int main(int argc, char** argv)
          IntOption    mWDefault("MAIN", "mWDefault","Default value for mW.\n", 5, IntRange(1, INT32_MAX));
          IntOption    mSDefault("MAIN", "mWDefault","Default value for mS.\n", 5, IntRange(1, INT32_MAX));
          IntOption    prThDefault("MAIN", "prThDefault","Default value for prTh\n.\n", 2, IntRange(1, INT32_MAX));
+         DoubleOption expStepDecay("MAIN", "expStepDecay","Decay of the step scores along a walk.\n", 0.9, DoubleRange(0, false, 1, true));
          
 
         parseOptions(argc, argv, true);
@@ -172,6 +174,7 @@ int main(int argc, char** argv)
         S.mWDefault = mWDefault;
         S.mSDefault = mSDefault;
         S.prThDefault= prThDefault;
+        S.expStepDecay = expStepDecay;
 
         S.certifiedUNSAT = opt_certified;
         S.vbyte = opt_vbyte;
@@ -282,6 +285,9 @@ int main(int argc, char** argv)
         vec<Lit> dummy;
         lbool ret = S.solveLimited(dummy);
         S.state = ret==l_True ? 1 : (ret==l_False ? 0 : -1);        
+        if (S.verbosity > 0 && S.reused_restarts > 0)
+            printf("c trail reuse: %.0f of %.0f restarts, %.0f levels kept, %.0f propagations saved\n",
+                   (double)S.reused_restarts, (double)S.starts, (double)S.reused_levels, (double)S.reused_props);
         if (S.verbosity >= 0){
             printStats(S);
             //printf("\n"); 
@@ -290,11 +296,7 @@ int main(int argc, char** argv)
 
         if (res != NULL){
             if (ret == l_True){
-                printf("SAT\n");
-                for (int i = 0; i < S.nVars(); i++)
-                    if (S.model[i] != l_Undef)
-                        fprintf(res, "%s%s%d", (i==0)?"":" ", (S.model[i]==l_True)?"":"-", i+1);
-                fprintf(res, " 0\n");
+                writeSatResult(res, S.model);
             } else {
 	      if (ret == l_False){
 		fprintf(res, "UNSAT\n");
@@ -303,11 +305,7 @@ int main(int argc, char** argv)
             fclose(res);
         } else {
 	  if(S.showModel && ret==l_True) {
-	    printf("v ");
-	    for (int i = 0; i < S.nVars(); i++)
-                if (S.model[i] != l_Undef)
-		printf("%s%s%d", (i==0)?"":" ", (S.model[i]==l_True)?"":"-", i+1);
-              printf(" 0\n");
+	    writeModel(stdout, S.model, "v ");
 	  }
 
 
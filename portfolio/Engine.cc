@@ -0,0 +1,125 @@
+/****************************************************************************************[Engine.cc]
+Multi-engine portfolio -- adapter from one exploration variant to 'Portfolio::Engine'.
+
+This file is compiled once per variant, with the variant's root directory first on the include
+path, '-DMinisat=<unique namespace>' (except for the master variant) and:
+
+  ENGINE_TYPE          name of the 'Portfolio::EngineType' object to define (see Engine.h)
+  ENGINE_NAME          printable name of the variant
+  ENGINE_EXP_DEFAULTS  the variant takes its exploration parameters from 'mWDefault' & co.
+  ENGINE_EXP_ALLOWED   the variant only explores if 'expAllowed' is set
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+**************************************************************************************************/
+
+#include "core/Solver.h"
+#include "utils/Options.h"
+#include "Engine.h"
+
+using namespace Minisat;
+
+namespace {
+
+#ifdef ENGINE_EXP_DEFAULTS
+// As '-mWDefault' etc. of the frontends (which set these fields from 'main()'):
+static IntOption opt_mW_default  ("MAIN", "mWDefault",   "Default value for mW.",   5, IntRange(1, INT32_MAX));
+static IntOption opt_mS_default  ("MAIN", "mSDefault",   "Default value for mS.",   5, IntRange(1, INT32_MAX));
+static IntOption opt_prTh_default("MAIN", "prThDefault", "Default value for prTh.", 2, IntRange(1, INT32_MAX));
+#endif
+
+class VariantEngine : public Portfolio::Engine {
+    Solver               S;
+    int                  id;
+    Portfolio::Exchange& exchange;
+    std::vector<int>     tmp;
+    vec<Lit>             lits;
+
+    static int  terminate(void* state){
+        return ((VariantEngine*)state)->exchange.finished(); }
+
+    static void learnt(void* state, const vec<Lit>& c){
+        VariantEngine* e = (VariantEngine*)state;
+        e->tmp.clear();
+        for (int i = 0; i < c.size(); i++)
+            e->tmp.push_back(sign(c[i]) ? -(var(c[i]) + 1) : var(c[i]) + 1);
+        e->exchange.exportClause(e->id, e->tmp); }
+
+    static bool import(void* state, vec<Lit>& c){
+        VariantEngine* e = (VariantEngine*)state;
+        if (!e->exchange.importClause(e->id, e->tmp)){
+            e->exchange.restarted();     // The import loop ends once per restart.
+            return false; }
+        for (size_t i = 0; i < e->tmp.size(); i++){
+            int l = e->tmp[i];
+            c.push(mkLit(abs(l) - 1, l < 0)); }
+        return true; }
+
+public:
+    VariantEngine(int id_, Portfolio::Exchange& exchange_, int max_size, int max_lbd)
+      : id(id_), exchange(exchange_)
+    {
+        S.verbosity       = 0;
+#ifdef ENGINE_EXP_DEFAULTS
+        S.mWDefault       = opt_mW_default;
+        S.mSDefault       = opt_mS_default;
+        S.prThDefault     = opt_prTh_default;
+#endif
+#ifdef ENGINE_EXP_ALLOWED
+        S.expAllowed      = 1;
+#endif
+        S.term_state      = this;
+        S.term_callback   = terminate;
+        S.learn_state     = this;
+        S.learn_callback  = learnt;
+        S.learn_max_size  = max_size;
+        S.learn_max_lbd   = max_lbd;
+        S.import_state    = this;
+        S.import_callback = import;
+    }
+
+    void newVars(int n){
+        while (S.nVars() < n) S.newVar(); }
+
+    bool addClause(const std::vector<int>& c){
+        lits.clear();
+        for (size_t i = 0; i < c.size(); i++)
+            lits.push(mkLit(abs(c[i]) - 1, c[i] < 0));
+        return S.addClause_(lits); }
+
+    void setDecision(int v, bool b){ S.setDecisionVar(v - 1, b); }
+
+    int solve(){
+        vec<Lit> dummy;
+        lbool ret = S.solveLimited(dummy);
+        return ret == l_True ? 10 : ret == l_False ? 20 : 0; }
+
+    int modelValue(int v) const {
+        if (v > S.model.size() || S.model[v - 1] == l_Undef) return 0;
+        return S.model[v - 1] == l_True ? 1 : -1; }
+
+    uint64_t conflicts() const { return S.conflicts; }
+};
+
+void parseEngineOptions(int& argc, char** argv){ parseOptions(argc, argv, false); }
+
+Portfolio::Engine* createEngine(int id, Portfolio::Exchange& exchange, int max_size, int max_lbd){
+    return new VariantEngine(id, exchange, max_size, max_lbd); }
+
+}
+
+namespace Portfolio {
+extern const EngineType ENGINE_TYPE = { ENGINE_NAME, parseEngineOptions, createEngine };
+}
@@ -0,0 +1,101 @@
+/****************************************************************************************[Engine.h]
+Multi-engine portfolio -- common interface of the engines and the clause exchange between them.
+
+Every exploration variant is a full MiniSat fork living in 'namespace Minisat'. The portfolio links
+them into one binary by compiling each one with '-DMinisat=<unique namespace>', so the variants
+cannot see each other's types. Engines therefore talk to the driver and to each other only through
+this header, in terms of DIMACS literals (non-zero ints).
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+**************************************************************************************************/
+
+#ifndef Portfolio_Engine_h
+#define Portfolio_Engine_h
+
+#include <stdint.h>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+
+namespace Portfolio {
+
+//=================================================================================================
+// Exchange -- clauses shared between the engines, and the 'first engine done' flag:
+//
+// Exported clauses are appended to one log ([size, origin, lits...] records) guarded by a mutex;
+// every engine keeps a cursor into it and skips its own records. Glue clauses are rare enough
+// for the lock not to matter. The prefix that every engine has read is dropped now and then, and
+// the log is capped: an engine that lags too far behind misses the oldest clauses.
+
+class Exchange {
+public:
+    explicit Exchange(int engines);
+
+    void     exportClause (int from, const std::vector<int>& c);
+    bool     importClause (int to,   std::vector<int>& c);     // Next clause of another engine; false if none.
+
+    bool     finished     () const { return winner.load(std::memory_order_relaxed) >= 0; }
+    bool     finish       (int id);                             // True if 'id' is the first engine to finish.
+    int      winnerId     () const { return winner.load(); }
+
+    void     restarted    ();                                   // Called by an engine after each restart.
+    void     waitRestart  (int ms);                             // Waits for the next restart, for at most 'ms'.
+
+    uint64_t nbExported   (int id) const { return exported[id]; }
+    uint64_t nbImported   (int id) const { return imported[id]; }
+    uint64_t nbDropped    (int id) const { return dropped[id]; }    // Clauses it missed (see 'compact()').
+
+private:
+    std::mutex            lock;
+    std::vector<int>      log;
+    std::vector<size_t>   cursor;    // Per engine: position of the next unread record in 'log'.
+    std::vector<uint64_t> exported, imported, dropped;
+    std::atomic<int>      winner;
+    std::condition_variable restart;
+    uint64_t              restarts;
+
+    void     compact      ();
+};
+
+//=================================================================================================
+// Engine -- one CDCL solver of the portfolio:
+
+class Engine {
+public:
+    virtual ~Engine() {}
+
+    virtual void     newVars      (int n)                          = 0;
+    virtual bool     addClause    (const std::vector<int>& c)     = 0;  // False if the formula became UNSAT.
+    virtual void     setDecision  (int v, bool b)                 = 0;  // 'v' is a DIMACS variable (> 0).
+    virtual int      solve        ()                              = 0;  // 10 (SAT), 20 (UNSAT) or 0 (stopped).
+    virtual int      modelValue   (int v) const                   = 0;  // 1, -1, or 0 if unassigned.
+    virtual uint64_t conflicts    () const                        = 0;
+};
+
+// An engine type as seen by the driver. 'parseOptions' consumes the options of the variant from
+// 'argv' (non-strictly, unknown ones are left in place) and must be called before 'create'.
+struct EngineType {
+    const char* name;
+    void      (*parseOptions)(int& argc, char** argv);
+    Engine*   (*create)      (int id, Exchange& exchange, int max_size, int max_lbd);
+};
+
+extern const EngineType COMSPSeV, CBTeV, CMeV, LRBeL, COMSPSeVL, CBTeVL, CMeVL;
+
+}
+
+#endif
@@ -0,0 +1,117 @@
+/**************************************************************************************[Exchange.cc]
+Multi-engine portfolio -- clause exchange between the engines.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+**************************************************************************************************/
+
+#include "Engine.h"
+
+using namespace Portfolio;
+
+// Size of the read prefix of the log (in ints) from which on it is dropped.
+static const size_t compact_threshold = 1 << 20;
+
+// Size of the log (in ints) beyond which the records an engine has not read yet are dropped for it,
+// down to the last 'compact_threshold' ints. A clause is worth little to an engine so far behind.
+static const size_t log_limit = 8 * compact_threshold;
+
+Exchange::Exchange(int engines)
+  : cursor  (engines, 0)
+  , exported(engines, 0)
+  , imported(engines, 0)
+  , dropped (engines, 0)
+  , winner  (-1)
+  , restarts(0)
+{}
+
+
+void Exchange::exportClause(int from, const std::vector<int>& c)
+{
+    std::lock_guard<std::mutex> guard(lock);
+    log.push_back((int)c.size());
+    log.push_back(from);
+    log.insert(log.end(), c.begin(), c.end());
+    exported[from]++;
+    if (log.size() >= 2 * compact_threshold) compact();
+}
+
+
+bool Exchange::importClause(int to, std::vector<int>& c)
+{
+    std::lock_guard<std::mutex> guard(lock);
+    size_t& pos = cursor[to];
+    while (pos < log.size()){
+        int    size   = log[pos];
+        int    origin = log[pos + 1];
+        size_t lits   = pos + 2;
+        pos = lits + size;
+        if (origin != to){
+            c.assign(log.begin() + lits, log.begin() + lits + size);
+            imported[to]++;
+            return true; }
+    }
+    return false;
+}
+
+
+void Exchange::restarted()
+{
+    { std::lock_guard<std::mutex> guard(lock);
+      restarts++; }
+    restart.notify_all();
+}
+
+
+void Exchange::waitRestart(int ms)
+{
+    std::unique_lock<std::mutex> guard(lock);
+    uint64_t seen = restarts;
+    restart.wait_for(guard, std::chrono::milliseconds(ms), [&]{ return restarts != seen; });
+}
+
+
+bool Exchange::finish(int id)
+{
+    int none = -1;
+    return winner.compare_exchange_strong(none, id);
+}
+
+
+// Drops the part of the log that all engines have read. If an engine lags so far behind (e.g. one
+// that is busy in a long restart) that the log would still exceed 'log_limit', the records it has
+// not read yet are dropped for it too. Called with 'lock' held.
+void Exchange::compact()
+{
+    size_t read = log.size();
+    for (size_t i = 0; i < cursor.size(); i++)
+        if (cursor[i] < read) read = cursor[i];
+
+    if (log.size() - read > log_limit){
+        // Keep the records that start in the last 'compact_threshold' ints:
+        size_t keep = read;
+        while (log.size() - keep > compact_threshold)
+            keep += 2 + log[keep];
+        for (size_t i = 0; i < cursor.size(); i++)
+            for (; cursor[i] < keep; cursor[i] += 2 + log[cursor[i]])
+                if (log[cursor[i] + 1] != (int)i) dropped[i]++;
+        read = keep;
+    }
+    if (read < compact_threshold) return;
+
+    log.erase(log.begin(), log.begin() + read);
+    for (size_t i = 0; i < cursor.size(); i++)
+        cursor[i] -= read;
+}
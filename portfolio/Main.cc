@@ -0,0 +1,355 @@
+/******************************************************************************************[Main.cc]
+Multi-engine portfolio -- parses and simplifies the input once (with MplCOMSPS^eV's SimpSolver),
+copies the simplified formula into one engine per selected exploration variant, runs the engines
+on their own threads while they share units and glue clauses, and stops all of them as soon as
+the first one has an answer.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+**************************************************************************************************/
+
+#include <errno.h>
+
+#include <signal.h>
+#include <zlib.h>
+#include <sys/resource.h>
+#include <thread>
+
+#include "utils/System.h"
+#include "utils/ParseUtils.h"
+#include "utils/Options.h"
+#include "core/Dimacs.h"
+#include "core/ModelWriter.h"
+#include "simp/SimpSolver.h"
+#include "Engine.h"
+#include "Network.h"
+
+using namespace Minisat;
+
+//=================================================================================================
+// The master: holds the simplified formula and the eliminated clauses needed to extend a model.
+
+
+class MasterSolver : public SimpSolver {
+public:
+    // Copies the root-level units and the remaining clauses into 'e'. Eliminated variables are no
+    // decision variables there. Returns false if 'e' found the formula unsatisfiable on the way.
+    bool copyTo(Portfolio::Engine& e) const {
+        std::vector<int> c;
+        e.newVars(nVars());
+        for (Var v = 0; v < nVars(); v++)
+            if (isEliminated(v)) e.setDecision(v + 1, false);
+
+        for (int i = 0; i < trail.size(); i++){
+            c.assign(1, sign(trail[i]) ? -(var(trail[i]) + 1) : var(trail[i]) + 1);
+            if (!e.addClause(c)) return false; }
+
+        for (int i = 0; i < clauses.size(); i++){
+            const Clause& cl = ca[clauses[i]];
+            if (cl.mark() != 0) continue;
+            bool satisfied = false;
+            c.clear();
+            for (int j = 0; j < cl.size() && !satisfied; j++)
+                if (value(cl[j]) == l_True)
+                    satisfied = true;
+                else if (value(cl[j]) == l_Undef)
+                    c.push_back(sign(cl[j]) ? -(var(cl[j]) + 1) : var(cl[j]) + 1);
+            if (!satisfied && !e.addClause(c)) return false;
+        }
+        return true;
+    }
+
+    // Takes the model of 'e' and assigns the eliminated variables.
+    void takeModel(const Portfolio::Engine& e){
+        model.clear();
+        for (Var v = 0; v < nVars(); v++){
+            int val = e.modelValue(v + 1);
+            model.push(val > 0 ? l_True : val < 0 ? l_False : l_Undef); }
+        extendModel();
+    }
+};
+
+
+// Hash of the formula as copied into engines: workers of the distributed mode only exchange
+// clauses if they simplified the input into the same formula.
+class Fingerprint : public Portfolio::Engine {
+    uint64_t h;
+    void     mix(uint64_t x) { h = (h ^ x) * 0x100000001b3ULL; h ^= h >> 29; }
+public:
+    Fingerprint() : h(0xcbf29ce484222325ULL) {}
+    uint64_t value() const { return h; }
+
+    void     newVars    (int n)                      { mix(n); }
+    bool     addClause  (const std::vector<int>& c)  { mix(c.size()); for (size_t i = 0; i < c.size(); i++) mix(c[i]); return true; }
+    void     setDecision(int v, bool b)              { mix(b ? v : -v); }
+    int      solve      ()                           { return 0; }
+    int      modelValue (int) const                  { return 0; }
+    uint64_t conflicts  () const                     { return 0; }
+};
+
+
+//=================================================================================================
+// Engines:
+
+
+static const Portfolio::EngineType* const engine_types[] = {
+    &Portfolio::COMSPSeV, &Portfolio::LRBeL, &Portfolio::CBTeV, &Portfolio::CMeV,
+    &Portfolio::COMSPSeVL, &Portfolio::CBTeVL, &Portfolio::CMeVL };
+static const int nb_engine_types = sizeof(engine_types) / sizeof(engine_types[0]);
+
+
+// Body of the thread of engine 'id': copies the formula, solves, and claims the answer if first.
+static void runEngine(const MasterSolver* master, Portfolio::Engine* e, int id, Portfolio::Exchange* exchange, int* result)
+{
+    *result = master->copyTo(*e) ? e->solve() : 20;
+    if (*result != 0)
+        exchange->finish(id);
+}
+
+
+// Returns true if 'name' is in the comma separated list 'list' (or 'list' is "all").
+static bool selected(const char* list, const char* name)
+{
+    if (strcmp(list, "all") == 0) return true;
+    size_t len = strlen(name);
+    for (const char* p = list; p != NULL; p = strchr(p, ',')){
+        if (*p == ',') p++;
+        if (strncmp(p, name, len) == 0 && (p[len] == ',' || p[len] == '\0'))
+            return true; }
+    return false;
+}
+
+
+// Lets every variant consume its options from 'argv' and keeps only the arguments that none of
+// them recognised. Returns false (after printing it) if one of those looks like an option.
+static bool parseAllOptions(int& argc, char** argv)
+{
+    std::vector<bool> used(argc, false);
+    for (int t = 0; t < nb_engine_types; t++){
+        std::vector<char*> args(argv, argv + argc);
+        int                n = argc;
+        engine_types[t]->parseOptions(n, args.data());
+        for (int i = 1, j = 1; i < argc; i++)
+            if (j < n && args[j] == argv[i]) j++;
+            else used[i] = true;
+    }
+
+    int j = 1;
+    for (int i = 1; i < argc; i++){
+        if (used[i]) continue;
+        if (argv[i][0] == '-' && argv[i][1] != '\0'){
+            fprintf(stderr, "ERROR! Unknown flag \"%s\". Use '--help' for help.\n", argv[i]);
+            return false; }
+        argv[j++] = argv[i];
+    }
+    argc = j;
+    return true;
+}
+
+
+// Prints the answer (and the model with '-model'), and writes the result file if any.
+static void report(int ret, const vec<lbool>& model, bool print_model, FILE* res)
+{
+    printf(ret == 10 ? "s SATISFIABLE\n" : ret == 20 ? "s UNSATISFIABLE\n" : "s UNKNOWN\n");
+    if (ret == 10 && print_model)
+        writeModel(stdout, model, "v ");
+
+    if (res != NULL){
+        if (ret == 10)
+            writeSatResult(res, model);
+        else if (ret == 20)
+            fprintf(res, "UNSAT\n");
+        else
+            fprintf(res, "INDET\n");
+        fclose(res);
+    }
+    fflush(stdout);
+}
+
+
+static void SIGINT_exit(int signum) {
+    printf("\n"); printf("c *** INTERRUPTED ***\n");
+    printf("s UNKNOWN\n");
+    fflush(stdout);
+    _exit(1); }
+
+
+//=================================================================================================
+// Main:
+
+int main(int argc, char** argv)
+{
+    try {
+        setUsageHelp("USAGE: %s [options] <input-file> <result-output-file>\n\n  where input may be either in plain or gzipped DIMACS.\n");
+
+#if defined(__linux__)
+        fpu_control_t oldcw, newcw;
+        _FPU_GETCW(oldcw); newcw = (oldcw & ~_FPU_EXTENDED) | _FPU_DOUBLE; _FPU_SETCW(newcw);
+#endif
+        // Extra options:
+        //
+        IntOption    verb   ("MAIN", "verb",   "Verbosity level (0=silent, 1=some, 2=more).", 1, IntRange(0, 2));
+        BoolOption   pre    ("MAIN", "pre",    "Completely turn on/off any preprocessing.", true);
+        IntOption    cpu_lim("MAIN", "cpu-lim","Limit on CPU time allowed in seconds (all threads).\n", INT32_MAX, IntRange(0, INT32_MAX));
+        IntOption    mem_lim("MAIN", "mem-lim","Limit on memory usage in megabytes.\n", INT32_MAX, IntRange(0, INT32_MAX));
+        BoolOption   print_model("MAIN", "model", "Print the model on standard output ('v' line).", false);
+        StringOption engines("PORTFOLIO", "engines", "Comma separated engines to run, or \"all\": MplCOMSPS^eV,MplLRB^eL,MplCBT^eV,MplCM^eV,MplCOMSPS^eVL,MplCBT^eVL,MplCM^eVL.", "all");
+        IntOption    share_lbd ("PORTFOLIO", "share-lbd",  "Share learnt clauses up to this (stored) LBD; units are always shared.", 2, IntRange(0, INT32_MAX));
+        IntOption    share_size("PORTFOLIO", "share-size", "Share learnt clauses up to this size.", 30, IntRange(1, INT32_MAX));
+        StringOption serve  ("PORTFOLIO", "serve",   "Run as the coordinator of distributed workers on \"host:port\" or \"unix:<path>\" (no input file).");
+        StringOption connect("PORTFOLIO", "connect", "Run as a distributed worker of the coordinator at \"host:port\" or \"unix:<path>\".");
+
+        if (!parseAllOptions(argc, argv)) exit(1);
+
+        // Coordinator: no input, just relays clauses and reports the first answer.
+        if (serve != NULL){
+            signal(SIGINT, SIGINT_exit);
+            signal(SIGPIPE, SIG_IGN);
+            std::vector<int> lits;
+            int ret = Portfolio::runCoordinator(serve, verb, lits);
+            if (ret < 0) exit(1);
+            vec<lbool> model;
+            for (size_t i = 0; i < lits.size(); i++){
+                int v = abs(lits[i]);
+                while (model.size() < v) model.push(l_Undef);
+                model[v - 1] = lits[i] > 0 ? l_True : l_False; }
+            report(ret, model, print_model, argc >= 2 ? fopen(argv[1], "wb") : NULL);
+            exit(ret); }
+
+        // Set limit on CPU-time:
+        if (cpu_lim != INT32_MAX){
+            rlimit rl;
+            getrlimit(RLIMIT_CPU, &rl);
+            if (rl.rlim_max == RLIM_INFINITY || (rlim_t)cpu_lim < rl.rlim_max){
+                rl.rlim_cur = cpu_lim;
+                if (setrlimit(RLIMIT_CPU, &rl) == -1){
+                    printf("c WARNING! Could not set resource limit: CPU-time.\n");
+                }
+            } }
+
+        // Set limit on virtual memory:
+        if (mem_lim != INT32_MAX){
+            rlim_t new_mem_lim = (rlim_t)mem_lim * 1024*1024;
+            rlimit rl;
+            getrlimit(RLIMIT_AS, &rl);
+            if (rl.rlim_max == RLIM_INFINITY || new_mem_lim < rl.rlim_max){
+                rl.rlim_cur = new_mem_lim;
+                if (setrlimit(RLIMIT_AS, &rl) == -1){
+                    printf("c WARNING! Could not set resource limit: Virtual memory.\n");
+                }
+            } }
+
+        std::vector<const Portfolio::EngineType*> types;
+        for (int t = 0; t < nb_engine_types; t++)
+            if (selected(engines, engine_types[t]->name))
+                types.push_back(engine_types[t]);
+        if (types.empty()){
+            fprintf(stderr, "ERROR! No engine selected by \"-engines=%s\".\n", (const char*)engines);
+            exit(1); }
+
+        signal(SIGINT, SIGINT_exit);
+        signal(SIGXCPU,SIGINT_exit);
+
+        MasterSolver S;
+        double       initial_time = cpuTime();
+
+        if (!pre) S.eliminate(true);
+        S.parsing   = true;
+        S.verbosity = verb;
+
+        if (argc == 1)
+            printf("c Reading from standard input... Use '--help' for help.\n");
+
+        gzFile in = (argc == 1) ? gzdopen(0, "rb") : gzopen(argv[1], "rb");
+        if (in == NULL)
+            printf("c ERROR! Could not open file: %s\n", argc == 1 ? "<stdin>" : argv[1]), exit(1);
+
+        parse_DIMACS(in, S);
+        gzclose(in);
+        FILE* res = (argc >= 3) ? fopen(argv[2], "wb") : NULL;
+
+        S.parsing = false;
+        S.eliminate(true);
+        if (verb > 0)
+            printf("c Parsed and simplified %d variables, %d clauses in %.2f s\n", S.nVars(), S.nClauses(), cpuTime() - initial_time);
+
+        int ret = 20, winner = -1;
+        std::vector<Portfolio::Engine*> es;
+        int                             link_id = (int)types.size();
+        Portfolio::Exchange             exchange(link_id + (connect != NULL));
+        Portfolio::Link                 link(exchange, link_id);
+
+        if (connect != NULL){
+            signal(SIGPIPE, SIG_IGN);
+            Fingerprint f;
+            S.copyTo(f);
+            if (link.connect(connect, S.nVars(), f.value()) && verb > 0)
+                printf("c Connected to %s\n", (const char*)connect); }
+
+        if (S.okay()){
+            std::vector<int>         results(types.size(), 0);
+            std::vector<std::thread> threads;
+            for (size_t i = 0; i < types.size(); i++)
+                es.push_back(types[i]->create((int)i, exchange, share_size, share_lbd));
+            if (connect != NULL)
+                link.start();
+            for (size_t i = 0; i < types.size(); i++)
+                threads.push_back(std::thread(runEngine, &S, es[i], (int)i, &exchange, &results[i]));
+            for (size_t i = 0; i < threads.size(); i++)
+                threads[i].join();
+
+            winner = exchange.winnerId();
+            if (winner == link_id){
+                // Stopped by the answer of another worker: it is the coordinator's to report.
+                ret = link.remoteResult() == 20 ? 20 : 0;
+                if (verb > 0)
+                    printf("c Another worker found the formula %s\n", link.remoteResult() == 10 ? "satisfiable" : "unsatisfiable");
+            }else{
+                ret = winner < 0 ? 0 : results[winner];
+                if (ret == 10) S.takeModel(*es[winner]); }
+        }
+
+        if (connect != NULL){
+            exchange.finish(link_id);    // (stops the link if no engine did)
+            std::vector<int> lits;
+            if (ret == 10)
+                for (int v = 0; v < S.model.size(); v++)
+                    if (S.model[v] != l_Undef) lits.push_back(S.model[v] == l_True ? v + 1 : -(v + 1));
+            link.finish(winner == link_id ? 0 : ret, lits); }
+
+        if (verb > 0){
+            printf("c ============================[ Portfolio Statistics ]===========================\n");
+            printf("c  %-16s %14s %12s %12s %10s\n", "engine", "conflicts", "exported", "imported", "missed");
+            for (size_t i = 0; i < es.size(); i++)
+                printf("c %s%-16s %14" PRIu64 " %12" PRIu64 " %12" PRIu64 " %10" PRIu64 "\n", (int)i == winner ? "*" : " ",
+                       types[i]->name, es[i]->conflicts(), exchange.nbExported((int)i), exchange.nbImported((int)i), exchange.nbDropped((int)i));
+            if (connect != NULL && !es.empty())
+                printf("c %s%-16s %14s %12" PRIu64 " %12" PRIu64 " %10" PRIu64 "   (%" PRIu64 " batches, %.1f kB sent)\n", winner == link_id ? "*" : " ",
+                       "network", "-", exchange.nbExported(link_id), exchange.nbImported(link_id), exchange.nbDropped(link_id), link.nbBatches(), link.nbBytesSent() / 1024.0);
+            if (es.empty())
+                printf("c Solved by simplification\n");
+            printf("c CPU time (all threads): %g s\n", cpuTime());
+        }
+
+        report(ret, S.model, print_model, res);
+
+        exit(ret);     // (faster than "return", which will invoke the destructors of the engines)
+    } catch (OutOfMemoryException&){
+        printf("c ===============================================================================\n");
+        printf("c Out of memory\n");
+        printf("s UNKNOWN\n");
+        exit(0);
+    }
+}
@@ -0,0 +1,491 @@
+/**************************************************************************************[Network.cc]
+Multi-engine portfolio -- distributed mode: the worker link and the coordinator.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+**************************************************************************************************/
+
+#include <errno.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <netdb.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+
+#include <set>
+
+#include "Network.h"
+
+using namespace Portfolio;
+
+static const uint64_t protocol_version = 1;
+static const int      flush_ms         = 50;         // Longest wait of the link between two batches.
+static const size_t   max_message      = 1 << 28;    // Longer messages are taken as garbage.
+static const size_t   max_queued       = 64 << 20;   // Batches for a worker that lags more are dropped.
+
+
+//=================================================================================================
+// Encoding:
+
+
+static void putVarint(std::string& out, uint64_t x)
+{
+    while (x >= 0x80){
+        out.push_back((char)(x | 0x80));
+        x >>= 7; }
+    out.push_back((char)x);
+}
+
+static bool getVarint(const char*& p, const char* end, uint64_t& x)
+{
+    x = 0;
+    for (int shift = 0; p < end && shift < 64; shift += 7){
+        uint8_t b = (uint8_t)*p++;
+        x |= (uint64_t)(b & 0x7f) << shift;
+        if (!(b & 0x80)) return true; }
+    return false;
+}
+
+static inline uint64_t encodeLit(int l) { return l > 0 ? 2 * (uint64_t)(l - 1) : 2 * (uint64_t)(-l - 1) + 1; }
+static inline int      decodeLit(uint64_t x) { return (x & 1) ? -(int)(x / 2 + 1) : (int)(x / 2 + 1); }
+
+static void putClause(std::string& out, const std::vector<int>& c)
+{
+    putVarint(out, c.size());
+    for (size_t i = 0; i < c.size(); i++)
+        putVarint(out, encodeLit(c[i]));
+}
+
+// Reads one clause over the variables 1..'vars'. Empty clauses and other variables are rejected
+// (as garbage), so that a peer can neither stop the solvers nor make them index past their end.
+static bool getClause(const char*& p, const char* end, int vars, std::vector<int>& c)
+{
+    uint64_t size, x;
+    if (!getVarint(p, end, size) || size == 0 || size > (uint64_t)(end - p)) return false;
+    c.clear();
+    for (uint64_t i = 0; i < size; i++){
+        if (!getVarint(p, end, x) || x >= 2 * (uint64_t)vars) return false;
+        c.push_back(decodeLit(x)); }
+    return true;
+}
+
+static std::string frame(int type, const std::string& payload)
+{
+    std::string m(5, '\0');
+    m[0] = (char)type;
+    for (int i = 0; i < 4; i++) m[1 + i] = (char)((payload.size() >> (8 * i)) & 0xff);
+    return m + payload;
+}
+
+// If 'buf' starts with a whole message, moves it to 'type'/'payload' and returns 1; returns 0 if
+// more bytes are needed and -1 on garbage.
+static int takeMessage(std::string& buf, int& type, std::string& payload)
+{
+    if (buf.size() < 5) return 0;
+    size_t len = 0;
+    for (int i = 0; i < 4; i++) len |= (size_t)(uint8_t)buf[1 + i] << (8 * i);
+    type = (uint8_t)buf[0];
+    if (len > max_message || type < msg_hello || type > msg_stop) return -1;
+    if (buf.size() < 5 + len) return 0;
+    payload.assign(buf, 5, len);
+    buf.erase(0, 5 + len);
+    return 1;
+}
+
+
+//=================================================================================================
+// Sockets:
+
+
+// Fills 'un' for "unix:<path>", or resolves "host:port" into 'ai' (to be freed by the caller).
+static bool resolve(const char* address, bool passive, sockaddr_un& un, addrinfo*& ai)
+{
+    ai = NULL;
+    if (strncmp(address, "unix:", 5) == 0){
+        if (strlen(address + 5) >= sizeof(un.sun_path)){
+            fprintf(stderr, "ERROR! Socket path too long: \"%s\".\n", address + 5);
+            return false; }
+        memset(&un, 0, sizeof(un));
+        un.sun_family = AF_UNIX;
+        strcpy(un.sun_path, address + 5);
+        return true; }
+
+    const char* colon = strrchr(address, ':');
+    if (colon == NULL){
+        fprintf(stderr, "ERROR! Address \"%s\" is neither \"host:port\" nor \"unix:<path>\".\n", address);
+        return false; }
+    std::string host(address, colon - address);
+    addrinfo hints;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family   = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_flags    = passive ? AI_PASSIVE : 0;
+    int err = getaddrinfo(host.empty() ? NULL : host.c_str(), colon + 1, &hints, &ai);
+    if (err != 0){
+        fprintf(stderr, "ERROR! Cannot resolve \"%s\": %s.\n", address, gai_strerror(err));
+        return false; }
+    return true;
+}
+
+static int listenOn(const char* address)
+{
+    sockaddr_un un;
+    addrinfo*   ai;
+    if (!resolve(address, true, un, ai)) return -1;
+
+    int fd = socket(ai ? ai->ai_family : AF_UNIX, SOCK_STREAM, 0);
+    if (fd >= 0){
+        int one = 1;
+        if (ai) setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+        else    unlink(un.sun_path);   // A socket left by a previous coordinator
+        if ((ai ? bind(fd, ai->ai_addr, ai->ai_addrlen) : bind(fd, (sockaddr*)&un, sizeof(un))) != 0 || listen(fd, 64) != 0){
+            close(fd);
+            fd = -1; } }
+    if (fd < 0)
+        fprintf(stderr, "ERROR! Cannot listen on \"%s\": %s.\n", address, strerror(errno));
+    if (ai) freeaddrinfo(ai);
+    return fd;
+}
+
+static int connectTo(const char* address)
+{
+    sockaddr_un un;
+    addrinfo*   ai;
+    if (!resolve(address, false, un, ai)) return -1;
+
+    int fd = -1;
+    for (int attempt = 0; attempt < 100 && fd < 0; attempt++){   // For about 10 seconds
+        if (attempt > 0) usleep(100000);
+        if (ai == NULL){
+            fd = socket(AF_UNIX, SOCK_STREAM, 0);
+            if (fd >= 0 && ::connect(fd, (sockaddr*)&un, sizeof(un)) != 0){ close(fd); fd = -1; }
+        }else
+            for (addrinfo* a = ai; a != NULL && fd < 0; a = a->ai_next){
+                fd = socket(a->ai_family, SOCK_STREAM, 0);
+                if (fd >= 0 && ::connect(fd, a->ai_addr, a->ai_addrlen) != 0){ close(fd); fd = -1; } } }
+    if (fd < 0)
+        fprintf(stderr, "ERROR! Cannot connect to \"%s\": %s.\n", address, strerror(errno));
+    else if (ai){
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one)); }
+    if (ai) freeaddrinfo(ai);
+    return fd;
+}
+
+static bool sendAll(int fd, const std::string& data)
+{
+    for (size_t done = 0; done < data.size(); ){
+        ssize_t n = send(fd, data.data() + done, data.size() - done, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        done += n; }
+    return true;
+}
+
+// Appends what can be read without waiting. Returns false once the peer has closed the connection.
+static bool receiveAvailable(int fd, std::string& buf)
+{
+    char chunk[65536];
+    for (;;){
+        ssize_t n = recv(fd, chunk, sizeof(chunk), MSG_DONTWAIT);
+        if (n > 0){ buf.append(chunk, n); continue; }
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) return true;
+        return false; }
+}
+
+
+//=================================================================================================
+// Link:
+
+
+Link::Link(Exchange& exchange_, int id_)
+  : exchange(exchange_), id(id_), fd(-1), vars(0), remote_result(0), batches(0), bytes_sent(0)
+{}
+
+Link::~Link() { if (fd >= 0) close(fd); }
+
+
+bool Link::connect(const char* address, int vars_, uint64_t fingerprint)
+{
+    vars = vars_;
+    fd = connectTo(address);
+    if (fd < 0) return false;
+    std::string hello;
+    putVarint(hello, protocol_version);
+    putVarint(hello, vars);
+    putVarint(hello, fingerprint);
+    if (!sendAll(fd, frame(msg_hello, hello))){
+        lost();
+        return false; }
+    return true;
+}
+
+
+void Link::start() { thread = std::thread(&Link::run, this); }
+
+
+void Link::run()
+{
+    std::vector<int> c;
+    std::string      batch;
+    while (fd >= 0 && !exchange.finished()){
+        exchange.waitRestart(flush_ms);
+
+        batch.clear();
+        while (exchange.importClause(id, c))
+            putClause(batch, c);
+        if (!batch.empty()){
+            std::string m = frame(msg_clauses, batch);
+            if (!sendAll(fd, m)){ lost(); break; }
+            batches++;
+            bytes_sent += m.size(); }
+
+        if (!receive()){ lost(); break; }
+    }
+
+    // Alone: keep reading the exchange so that its log can still be compacted.
+    while (!exchange.finished()){
+        exchange.waitRestart(flush_ms);
+        while (exchange.importClause(id, c)); }
+}
+
+
+bool Link::receive()
+{
+    bool open = receiveAvailable(fd, input);
+    int              type, r;
+    std::string      payload;
+    std::vector<int> c;
+    while ((r = takeMessage(input, type, payload)) > 0){
+        const char* p   = payload.data();
+        const char* end = p + payload.size();
+        if (type == msg_clauses){
+            while (p < end && getClause(p, end, vars, c))
+                exchange.exportClause(id, c);
+        }else if (type == msg_stop){
+            uint64_t status = 0;
+            getVarint(p, end, status);
+            if (status == 0)
+                fprintf(stderr, "c WARNING! Refused by the coordinator (not the same simplified formula): solving alone.\n");
+            else{
+                remote_result = (int)status;
+                exchange.finish(id); }
+            close(fd);
+            fd = -1;
+            return true; }
+    }
+    return r == 0 && open;
+}
+
+
+void Link::lost()
+{
+    if (!exchange.finished())
+        fprintf(stderr, "c WARNING! Lost the connection to the coordinator: solving alone.\n");
+    close(fd);
+    fd = -1;
+}
+
+
+void Link::finish(int result, const std::vector<int>& model)
+{
+    if (thread.joinable()) thread.join();
+    if (fd < 0) return;
+
+    if (result == 10 || result == 20){
+        std::string m;
+        putVarint(m, result);
+        putVarint(m, model.size());
+        for (size_t i = 0; i < model.size(); i++)
+            putVarint(m, encodeLit(model[i]));
+        sendAll(fd, frame(msg_result, m)); }
+
+    // Let the coordinator read everything before the connection goes (closing with unread
+    // input would reset it): stop writing, then drain until it closes or for two seconds.
+    shutdown(fd, SHUT_WR);
+    char chunk[4096];
+    pollfd pfd = { fd, POLLIN, 0 };
+    for (int i = 0; i < 20 && poll(&pfd, 1, 100) >= 0; i++)
+        if ((pfd.revents & (POLLIN | POLLHUP)) && recv(fd, chunk, sizeof(chunk), MSG_DONTWAIT) == 0)
+            break;
+    close(fd);
+    fd = -1;
+}
+
+
+//=================================================================================================
+// Coordinator:
+
+
+namespace {
+
+struct Worker {
+    int         fd, number;
+    bool        joined;
+    bool        closing;     // Refused: close once 'output' is sent.
+    std::string input, output;
+    uint64_t    dropped;     // Batches not queued for it
+    Worker(int fd_, int number_) : fd(fd_), number(number_), joined(false), closing(false), dropped(0) {}
+};
+
+}
+
+int Portfolio::runCoordinator(const char* address, int verbosity, std::vector<int>& model)
+{
+    int lfd = listenOn(address);
+    if (lfd < 0) return -1;
+    if (verbosity > 0)
+        printf("c Coordinator listening on %s\n", address);
+
+    std::vector<Worker> workers;
+    std::set<int>       units;              // Every unit received so far, for the workers that join later.
+    uint64_t            fingerprint = 0, clauses = 0, dropped = 0;
+    int                 vars = 0, joined = 0, accepted = 0, result = 0;
+    std::vector<int>    c;
+
+    while (result == 0 && (joined == 0 || !workers.empty())){
+        std::vector<pollfd> fds(1 + workers.size());
+        fds[0].fd = lfd; fds[0].events = POLLIN; fds[0].revents = 0;
+        for (size_t i = 0; i < workers.size(); i++){
+            fds[1 + i].fd      = workers[i].fd;
+            fds[1 + i].events  = POLLIN | (workers[i].output.empty() ? 0 : POLLOUT);
+            fds[1 + i].revents = 0; }
+        if (poll(fds.data(), fds.size(), 1000) < 0 && errno != EINTR){
+            perror("c poll");
+            break; }
+
+        std::vector<bool> gone(workers.size(), false);
+        for (size_t i = 0; i < workers.size() && result == 0; i++){
+            Worker& w = workers[i];
+            if (fds[1 + i].revents & POLLOUT){
+                ssize_t n = send(w.fd, w.output.data(), w.output.size(), MSG_NOSIGNAL | MSG_DONTWAIT);
+                if (n > 0) w.output.erase(0, n);
+                else if (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) gone[i] = true;
+                if (w.closing && w.output.empty()) gone[i] = true; }
+            if (!(fds[1 + i].revents & (POLLIN | POLLHUP | POLLERR)) || gone[i]) continue;
+
+            bool open = receiveAvailable(w.fd, w.input);
+            int         type, r = 0;
+            std::string payload;
+            while (!gone[i] && result == 0 && (r = takeMessage(w.input, type, payload)) > 0){
+                const char* p   = payload.data();
+                const char* end = p + payload.size();
+                if (type == msg_hello && !w.joined){
+                    uint64_t version = 0, v = 0, f = 0;
+                    getVarint(p, end, version); getVarint(p, end, v); getVarint(p, end, f);
+                    if (version != protocol_version || (joined > 0 && (f != fingerprint || (int)v != vars))){
+                        if (verbosity > 0)
+                            printf("c Worker %d refused: %s\n", w.number, version != protocol_version ? "other protocol version" : "other simplified formula");
+                        std::string stop;
+                        putVarint(stop, 0);
+                        w.output += frame(msg_stop, stop);
+                        w.closing = true;
+                        continue; }
+                    if (joined == 0){ fingerprint = f; vars = (int)v; }
+                    w.joined = true;
+                    joined++;
+                    if (verbosity > 0)
+                        printf("c Worker %d joined (%d variables)\n", w.number, vars);
+                    if (!units.empty()){
+                        std::string batch;
+                        for (std::set<int>::iterator it = units.begin(); it != units.end(); ++it){
+                            c.assign(1, *it);
+                            putClause(batch, c); }
+                        w.output += frame(msg_clauses, batch); }
+                }else if (type == msg_clauses && w.joined){
+                    while (p < end && getClause(p, end, vars, c)){
+                        clauses++;
+                        if (c.size() == 1) units.insert(c[0]); }
+                    if (p < end) continue;   // Not relayed: a clause of the batch is garbage.
+                    std::string m = frame(msg_clauses, payload);
+                    for (size_t j = 0; j < workers.size(); j++)
+                        if (j != i && workers[j].joined && !workers[j].closing){
+                            if (workers[j].output.size() < max_queued) workers[j].output += m;
+                            else workers[j].dropped++; }
+                }else if (type == msg_result && w.joined){
+                    uint64_t status = 0, n = 0, x;
+                    getVarint(p, end, status);
+                    getVarint(p, end, n);
+                    model.clear();
+                    for (uint64_t k = 0; k < n && getVarint(p, end, x); k++)
+                        model.push_back(decodeLit(x));
+                    if (status == 10 || status == 20){
+                        result = (int)status;
+                        if (verbosity > 0)
+                            printf("c Worker %d answered %s\n", w.number, result == 10 ? "SAT" : "UNSAT"); }
+                }else
+                    gone[i] = true;
+            }
+            if (r < 0 || !open) gone[i] = true;
+        }
+
+        for (size_t i = workers.size(); i-- > 0; )
+            if (gone[i]){
+                if (verbosity > 0 && workers[i].joined && result == 0)
+                    printf("c Worker %d left\n", workers[i].number);
+                close(workers[i].fd);
+                dropped += workers[i].dropped;
+                workers.erase(workers.begin() + i); }
+
+        if (result == 0 && (fds[0].revents & POLLIN)){
+            int fd = accept(lfd, NULL, NULL);
+            if (fd >= 0) workers.push_back(Worker(fd, accepted++)); }
+    }
+
+    // Stop the other workers. As in 'Link::finish()', read until they close (or for two seconds),
+    // since closing with unread batches would reset the connection and lose the stop message.
+    std::string stop;
+    putVarint(stop, result);
+    for (size_t i = 0; i < workers.size(); i++){
+        workers[i].output += frame(msg_stop, stop);
+        int flags = fcntl(workers[i].fd, F_GETFL);
+        fcntl(workers[i].fd, F_SETFL, flags & ~O_NONBLOCK);
+        timeval tv = { 2, 0 };
+        setsockopt(workers[i].fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+        sendAll(workers[i].fd, workers[i].output);
+        shutdown(workers[i].fd, SHUT_WR); }
+    for (int round = 0; round < 20 && !workers.empty(); round++){
+        std::vector<pollfd> fds(workers.size());
+        for (size_t i = 0; i < workers.size(); i++){
+            fds[i].fd = workers[i].fd; fds[i].events = POLLIN; fds[i].revents = 0; }
+        if (poll(fds.data(), fds.size(), 100) < 0 && errno != EINTR) break;
+        for (size_t i = workers.size(); i-- > 0; ){
+            workers[i].input.clear();
+            if ((fds[i].revents & (POLLIN | POLLHUP | POLLERR)) && !receiveAvailable(workers[i].fd, workers[i].input)){
+                close(workers[i].fd);
+                dropped += workers[i].dropped;
+                workers.erase(workers.begin() + i); } }
+    }
+    for (size_t i = 0; i < workers.size(); i++){
+        close(workers[i].fd);
+        dropped += workers[i].dropped; }
+    close(lfd);
+    if (strncmp(address, "unix:", 5) == 0) unlink(address + 5);
+
+    if (verbosity > 0){
+        printf("c %d worker(s) joined, %" PRIu64 " clause(s) relayed (%d distinct units)", joined, clauses, (int)units.size());
+        if (dropped > 0) printf(", %" PRIu64 " batch(es) dropped for lagging workers", dropped);
+        printf("\n"); }
+
+    return result;
+}
@@ -0,0 +1,95 @@
+/***************************************************************************************[Network.h]
+Multi-engine portfolio -- distributed mode: several portfolio processes (the workers) exchange
+units and short learnt clauses through a coordinator process.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+**************************************************************************************************/
+
+#ifndef Portfolio_Network_h
+#define Portfolio_Network_h
+
+#include <stdint.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Engine.h"
+
+namespace Portfolio {
+
+//=================================================================================================
+// Wire format:
+//
+// Addresses are "host:port" (TCP) or "unix:<path>" (Unix domain socket). A message is one type
+// byte, the length of the payload (4 bytes, little endian) and the payload. Integers in payloads
+// are LEB128 varints, and a literal is '2 * (var - 1) + sign', so that most literals take one to
+// three bytes:
+//
+//   hello    version, number of variables, fingerprint of the simplified formula (worker)
+//   clauses  any number of [size, lits...] (both ways)
+//   result   10 or 20, then for SAT the number of literals and the model (worker)
+//   stop     the answer found by another worker, or 0 if the worker was refused (coordinator)
+//
+// Clauses range over the variables of the simplified formula, so only workers that simplified the
+// input into the very same formula (same fingerprint) may exchange them.
+
+enum MessageType { msg_hello = 1, msg_clauses = 2, msg_result = 3, msg_stop = 4 };
+
+//=================================================================================================
+// Link -- the worker side: a thread that takes part in the exchange of the process as one more
+// engine. After each restart of a local engine, it sends what the engines exported since the last
+// batch and passes on what the coordinator relayed.
+
+class Link {
+public:
+    Link(Exchange& exchange, int id);
+    ~Link();
+
+    // Connects (retrying for a few seconds, so that the workers may start first) and says hello.
+    bool     connect      (const char* address, int vars, uint64_t fingerprint);
+    void     start        ();
+
+    // Waits for the thread (the exchange must be finished), then sends the answer of this worker
+    // if it has one (result 10 or 20, model as DIMACS literals) and disconnects.
+    void     finish       (int result, const std::vector<int>& model);
+
+    int      remoteResult () const { return remote_result; }  // Answer of another worker, if it stopped us.
+    uint64_t nbBatches    () const { return batches; }
+    uint64_t nbBytesSent  () const { return bytes_sent; }
+
+private:
+    Exchange&        exchange;
+    int              id;
+    int              fd;
+    int              vars;         // Of the simplified formula: received clauses must stay within.
+    std::thread      thread;
+    std::string      input;        // Received bytes not parsed yet.
+    int              remote_result;
+    uint64_t         batches, bytes_sent;
+
+    void     run          ();
+    bool     receive      ();        // Handles what arrived meanwhile (never waits); false if disconnected.
+    void     lost         ();
+};
+
+// The coordinator: relays every batch of clauses to all other workers until one of them answers,
+// or until all workers that joined have left. Returns 10 (with the model of the worker in 'model'),
+// 20, 0 if nobody answered, or -1 if 'address' cannot be listened on.
+int runCoordinator(const char* address, int verbosity, std::vector<int>& model);
+
+}
+
+#endif